@@ -141,3 +141,29 @@ bool FileSystem::writeBinaryFile(const std::filesystem::path& path, const std::v
 	file.write(reinterpret_cast<const char*>(data.data()), data.size());
 	return file.good();
 }
+
+std::string FileSystem::decodeUri(std::string_view uri)
+{
+	auto hex = [](char c) -> int {
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if (c >= 'a' && c <= 'f')
+			return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F')
+			return c - 'A' + 10;
+		return -1;
+	};
+
+	// Malformed escapes are kept as they are
+	std::string decoded;
+	decoded.reserve(uri.size());
+	for (size_t i = 0; i < uri.size(); i++) {
+		if (uri[i] == '%' && i + 2 < uri.size() && hex(uri[i + 1]) >= 0 && hex(uri[i + 2]) >= 0) {
+			decoded.push_back(static_cast<char>(hex(uri[i + 1]) * 16 + hex(uri[i + 2])));
+			i += 2;
+		} else
+			decoded.push_back(uri[i]);
+	}
+
+	return decoded;
+}
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <string_view>
 #include <filesystem>
 
 class FileSystem {
@@ -24,4 +25,7 @@ public:
 
 	static bool writeTextFile(const std::filesystem::path& path, const std::string& content);
 	static bool writeBinaryFile(const std::filesystem::path& path, const std::vector<uint8_t>& data);
+
+	// Percent-decodes a relative URI such as the buffer and image references of glTF files
+	static std::string decodeUri(std::string_view uri);
 };
@@ -0,0 +1,134 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+	file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		file_handle = nullptr;
+		throw std::runtime_error("Failed to open file: " + path.string());
+	}
+
+	LARGE_INTEGER file_size{};
+	if (!GetFileSizeEx(file_handle, &file_size)) {
+		close();
+		throw std::runtime_error("Failed to query file size: " + path.string());
+	}
+
+	size = static_cast<size_t>(file_size.QuadPart);
+	if (size == 0)
+		return;
+
+	mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping_handle) {
+		close();
+		throw std::runtime_error("Failed to map file: " + path.string());
+	}
+
+	data = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		close();
+		throw std::runtime_error("Failed to map file: " + path.string());
+	}
+#else
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error("Failed to open file: " + path.string());
+
+	struct stat file_stat{};
+	if (::fstat(descriptor, &file_stat) != 0) {
+		::close(descriptor);
+		throw std::runtime_error("Failed to query file size: " + path.string());
+	}
+
+	size = static_cast<size_t>(file_stat.st_size);
+	if (size > 0) {
+		void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mapping == MAP_FAILED) {
+			::close(descriptor);
+			throw std::runtime_error("Failed to map file: " + path.string());
+		}
+
+		data = static_cast<const uint8_t*>(mapping);
+	}
+
+	::close(descriptor);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data(std::exchange(other.data, nullptr)),
+    size(std::exchange(other.size, 0))
+#ifdef _WIN32
+    ,
+    file_handle(std::exchange(other.file_handle, nullptr)),
+    mapping_handle(std::exchange(other.mapping_handle, nullptr))
+#endif
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		close();
+
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+#ifdef _WIN32
+		file_handle = std::exchange(other.file_handle, nullptr);
+		mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+	}
+
+	return *this;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping_handle)
+		CloseHandle(mapping_handle);
+	if (file_handle)
+		CloseHandle(file_handle);
+
+	mapping_handle = nullptr;
+	file_handle = nullptr;
+#else
+	if (data)
+		::munmap(const_cast<uint8_t*>(data), size);
+#endif
+
+	data = nullptr;
+	size = 0;
+}
+
+std::span<const uint8_t> MappedFile::getData() const
+{
+	return {data, size};
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
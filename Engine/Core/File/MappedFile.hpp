@@ -0,0 +1,31 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+#include <filesystem>
+
+class MappedFile {
+private:
+	const uint8_t* data{};
+	size_t         size{};
+
+#ifdef _WIN32
+	void* file_handle{};
+	void* mapping_handle{};
+#endif
+
+	void close();
+
+public:
+	MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	auto getData() const -> std::span<const uint8_t>;
+	auto getSize() const -> size_t;
+};
@@ -47,6 +47,15 @@ std::filesystem::path PathResolver::getLogsDir()
 	return dir;
 }
 
+std::filesystem::path PathResolver::getCacheDir()
+{
+	auto dir = getExecutableDir() / "Cache";
+	if (!FileSystem::exists(dir))
+		FileSystem::createDirectories(dir);
+
+	return dir;
+}
+
 std::filesystem::path PathResolver::resolveAssetPath(const std::string& relativePath)
 {
 	return getAssetsDir() / relativePath;
@@ -12,6 +12,7 @@ public:
 	static std::filesystem::path getShadersDir();
 	static std::filesystem::path getScriptsDir();
 	static std::filesystem::path getLogsDir();
+	static std::filesystem::path getCacheDir();
 
 	static std::filesystem::path resolveAssetPath(const std::string& relativePath);
 };
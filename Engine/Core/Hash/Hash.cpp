@@ -0,0 +1,101 @@
+#include "Hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+static uint64_t read64(const uint8_t* data)
+{
+	uint64_t value;
+	std::memcpy(&value, data, sizeof(uint64_t));
+	return value;
+}
+
+static uint32_t read32(const uint8_t* data)
+{
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(uint32_t));
+	return value;
+}
+
+static uint64_t round(uint64_t accumulator, uint64_t input)
+{
+	accumulator += input * prime2;
+	accumulator = std::rotl(accumulator, 31);
+	return accumulator * prime1;
+}
+
+static uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+{
+	accumulator ^= round(0, value);
+	return accumulator * prime1 + prime4;
+}
+
+uint64_t Hash::xxh64(std::span<const uint8_t> data, uint64_t seed)
+{
+	const uint8_t* pointer = data.data();
+	const uint8_t* end = pointer + data.size();
+
+	uint64_t hash;
+	if (data.size() >= 32) {
+		uint64_t v1 = seed + prime1 + prime2;
+		uint64_t v2 = seed + prime2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - prime1;
+
+		for (; pointer + 32 <= end; pointer += 32) {
+			v1 = round(v1, read64(pointer));
+			v2 = round(v2, read64(pointer + 8));
+			v3 = round(v3, read64(pointer + 16));
+			v4 = round(v4, read64(pointer + 24));
+		}
+
+		hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+		hash = mergeRound(hash, v1);
+		hash = mergeRound(hash, v2);
+		hash = mergeRound(hash, v3);
+		hash = mergeRound(hash, v4);
+	} else
+		hash = seed + prime5;
+
+	hash += data.size();
+
+	for (; pointer + 8 <= end; pointer += 8) {
+		hash ^= round(0, read64(pointer));
+		hash = std::rotl(hash, 27) * prime1 + prime4;
+	}
+
+	if (pointer + 4 <= end) {
+		hash ^= read32(pointer) * prime1;
+		hash = std::rotl(hash, 23) * prime2 + prime3;
+		pointer += 4;
+	}
+
+	for (; pointer < end; pointer++) {
+		hash ^= *pointer * prime5;
+		hash = std::rotl(hash, 11) * prime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+uint64_t Hash::xxh64(std::string_view data, uint64_t seed)
+{
+	return xxh64({reinterpret_cast<const uint8_t*>(data.data()), data.size()}, seed);
+}
+
+uint64_t Hash::combine(uint64_t seed, uint64_t value)
+{
+	return seed ^ (value + prime1 + (seed << 6) + (seed >> 2));
+}
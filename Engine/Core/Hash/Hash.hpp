@@ -0,0 +1,24 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+#include <string_view>
+
+class Hash {
+public:
+	static uint64_t xxh64(std::span<const uint8_t> data, uint64_t seed = 0);
+	static uint64_t xxh64(std::string_view data, uint64_t seed = 0);
+
+	static uint64_t combine(uint64_t seed, uint64_t value);
+
+	// Compile-time hash for short keys such as type names, not for bulk data
+	static constexpr uint64_t fnv1a(std::string_view data)
+	{
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (char c : data) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001B3ull;
+		}
+		return hash;
+	}
+};
@@ -0,0 +1,114 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t worker_count)
+{
+	if (worker_count == 0)
+		worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+	workers.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; i++)
+		workers.emplace_back([this]() { work(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+
+	for (auto& worker : workers)
+		if (worker.joinable())
+			worker.join();
+}
+
+ThreadPool& ThreadPool::instance()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::work()
+{
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+			if (stopping && tasks.empty())
+				return;
+
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& func, size_t grain)
+{
+	if (count == 0)
+		return;
+
+	grain = std::max<size_t>(1, grain);
+	size_t chunk_count = (count + grain - 1) / grain;
+	if (chunk_count == 1) {
+		for (size_t i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	// The calling thread takes chunks as well, so nested calls from a worker never wait on an empty pool
+	struct Batch {
+		std::atomic<size_t>     next_chunk{0};
+		std::atomic<size_t>     done_chunks{0};
+		std::exception_ptr      exception;
+		std::mutex              mutex;
+		std::condition_variable finished;
+	};
+
+	auto batch = std::make_shared<Batch>();
+	auto run = [batch, &func, count, grain, chunk_count]() {
+		size_t chunk;
+		while ((chunk = batch->next_chunk.fetch_add(1)) < chunk_count) {
+			try {
+				size_t end = std::min(count, (chunk + 1) * grain);
+				for (size_t i = chunk * grain; i < end; i++)
+					func(i);
+			} catch (...) {
+				std::lock_guard lock(batch->mutex);
+				if (!batch->exception)
+					batch->exception = std::current_exception();
+			}
+
+			if (batch->done_chunks.fetch_add(1) + 1 == chunk_count) {
+				std::lock_guard lock(batch->mutex);
+				batch->finished.notify_all();
+			}
+		}
+	};
+
+	size_t helper_count = std::min<size_t>(workers.size(), chunk_count - 1);
+	{
+		std::lock_guard lock(mutex);
+		for (size_t i = 0; i < helper_count; i++)
+			tasks.emplace(run);
+	}
+	condition.notify_all();
+
+	run();
+
+	std::unique_lock lock(batch->mutex);
+	batch->finished.wait(lock, [&batch, chunk_count]() { return batch->done_chunks.load() == chunk_count; });
+
+	if (batch->exception)
+		std::rethrow_exception(batch->exception);
+}
+
+uint32_t ThreadPool::getWorkerCount() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
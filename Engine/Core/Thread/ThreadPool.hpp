@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+private:
+	std::vector<std::thread>          workers;
+	std::queue<std::function<void()>> tasks;
+
+	std::mutex              mutex;
+	std::condition_variable condition;
+	bool                    stopping{false};
+
+	void work();
+
+public:
+	ThreadPool(uint32_t worker_count = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	ThreadPool(ThreadPool&&) noexcept = delete;
+	ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+	static ThreadPool& instance();
+
+	template <typename F>
+	auto submit(F&& func) -> std::future<std::invoke_result_t<F>>;
+
+	void parallelFor(size_t count, const std::function<void(size_t)>& func, size_t grain = 1);
+
+	uint32_t getWorkerCount() const;
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& func) -> std::future<std::invoke_result_t<F>>
+{
+	using R = std::invoke_result_t<F>;
+
+	auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+	auto future = task->get_future();
+	{
+		std::lock_guard lock(mutex);
+		tasks.emplace([task]() { (*task)(); });
+	}
+	condition.notify_one();
+
+	return future;
+}
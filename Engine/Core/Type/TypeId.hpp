@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "Core/Hash/Hash.hpp"
+
+using TypeId = uint64_t;
+
+// Name of T as the compiler spells it in this function's signature, resolved at compile time without RTTI
+template <typename T>
+consteval std::string_view getTypeName()
+{
+#if defined(_MSC_VER)
+	std::string_view signature = __FUNCSIG__;
+	auto             begin = signature.find("getTypeName<") + 12;
+	auto             end = signature.rfind(">(void)");
+#else
+	std::string_view signature = __PRETTY_FUNCTION__;
+	auto             begin = signature.find("T = ") + 4;
+	auto             end = signature.find_first_of(";]", begin);
+#endif
+	return signature.substr(begin, end - begin);
+}
+
+// Stable for a given build, distinct types have distinct names and a 64-bit hash keeps them apart
+template <typename T>
+consteval TypeId getTypeId()
+{
+	return Hash::fnv1a(getTypeName<T>());
+}
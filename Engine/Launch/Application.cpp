@@ -1,5 +1,7 @@
 #include "Application.hpp"
 
+#include <format>
+
 #include "Core/File/PathResolver.hpp"
 #include "Core/File/JsonParser.hpp"
 #include "Core/Log/Logger.hpp"
@@ -9,8 +11,22 @@ Application::Application()
 {
 	Time::setMainClock(&clock);
 
-	auto path = JsonParser::readJson(PathResolver::getConfigsDir() / "config.json")["scene"];
-	auto scene = AssetImporter::loadScene((PathResolver::getAssetsDir() / (path.get<std::string>())).string());
+	auto config = JsonParser::readJson(PathResolver::getConfigsDir() / "config.json");
+	auto path = config["scene"];
+
+	import_settings.parallel = config.value("parallel_import", true);
+	import_settings.write_cooked = config.value("cook_scene", false);
+	import_settings.use_cache = config.value("use_asset_cache", true);
+	import_settings.optimize_meshes = config.value("optimize_meshes", true);
+	import_settings.generate_lods = config.value("generate_lods", true);
+	import_settings.build_meshlets = config.value("build_meshlets", true);
+	import_settings.generate_mips = config.value("generate_mips", true);
+	import_settings.compress_textures = config.value("compress_textures", true);
+	import_settings.deduplicate_assets = config.value("deduplicate_assets", true);
+	import_settings.bake_static = config.value("bake_static", true);
+	import_settings.collapse_static = config.value("collapse_static", false);
+
+	auto scene = AssetImporter::loadScene((PathResolver::getAssetsDir() / (path.get<std::string>())).string(), import_settings);
 
 	window = std::make_unique<Window>("Vortex", 2560, 1440);
 
@@ -43,6 +59,7 @@ void Application::run()
 
 			float dt = clock.getDeltaTime();
 
+			tickLoading();
 			tickGui(dt);
 			tickLogic(dt);
 			tickRender(dt);
@@ -74,6 +91,17 @@ void Application::tickRender(float dt)
 		renderer->tick(dt);
 }
 
+void Application::tickLoading()
+{
+	if (!world_loader || world_loader->getState() == WorldLoader::State::Loading)
+		return;
+
+	if (world_loader->getState() == WorldLoader::State::Ready)
+		loadWorld(world_loader->takeWorld(), world_loader->takeRenderScene());
+
+	world_loader.reset();
+}
+
 void Application::loadWorld(std::unique_ptr<World>&& new_world)
 {
 	world = std::move(new_world);
@@ -81,6 +109,28 @@ void Application::loadWorld(std::unique_ptr<World>&& new_world)
 		renderer->setActiveWorld(*world);
 }
 
+void Application::loadWorld(std::unique_ptr<World>&& new_world, std::unique_ptr<RenderScene>&& render_scene)
+{
+	// The renderer lets go of the previous world before it is destroyed
+	renderer->setActiveWorld(*new_world, std::move(render_scene));
+	world = std::move(new_world);
+}
+
+void Application::loadWorldAsync(const std::filesystem::path& scene_path)
+{
+	if (world_loader) {
+		Logger::warn(std::format("Ignoring load of {}, another world is still loading", scene_path.string()));
+		return;
+	}
+
+	world_loader = std::make_unique<WorldLoader>(*renderer, scene_path, import_settings);
+}
+
+const WorldLoader* Application::getWorldLoader() const
+{
+	return world_loader.get();
+}
+
 void Application::loadRenderer(std::unique_ptr<Renderer>&& new_renderer)
 {
 	renderer = std::move(new_renderer);
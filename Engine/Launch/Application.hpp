@@ -1,12 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <filesystem>
 
 #include "Core/Clock/Clock.hpp"
 #include "Render/Renderer.hpp"
 #include "Scene/World.hpp"
 #include "Platform/Window.hpp"
 #include "Platform/Widget.hpp"
+#include "Utils/AssetImporter.hpp"
+#include "WorldLoader.hpp"
 
 class Application {
 private:
@@ -15,6 +18,10 @@ private:
 	std::unique_ptr<Window>   window;
 	std::unique_ptr<Widget>   widget;
 
+	// Declared last so a pending load finishes before the renderer and its context go away
+	std::unique_ptr<WorldLoader> world_loader;
+	ImportSettings               import_settings;
+
 	Clock clock;
 
 public:
@@ -25,7 +32,13 @@ public:
 	void tickGui(float dt);
 	void tickLogic(float dt);
 	void tickRender(float dt);
+	void tickLoading();
 
 	void loadWorld(std::unique_ptr<World>&& world);
+	void loadWorld(std::unique_ptr<World>&& world, std::unique_ptr<RenderScene>&& render_scene);
+	// Imports on a background thread, the current world keeps rendering until the new one is resident
+	void loadWorldAsync(const std::filesystem::path& scene_path);
+
+	auto getWorldLoader() const -> const WorldLoader*;
 	void loadRenderer(std::unique_ptr<Renderer>&& renderer);
 };
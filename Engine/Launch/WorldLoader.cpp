@@ -0,0 +1,106 @@
+#include "WorldLoader.hpp"
+
+#include <chrono>
+#include <format>
+#include <algorithm>
+
+#include "Core/Log/Logger.hpp"
+
+// Rough share of the load spent in each phase, the importer reports up to this many stages
+constexpr float    IMPORT_SHARE = 0.6f;
+constexpr float    BUILD_SHARE = 0.1f;
+constexpr uint32_t IMPORT_STAGES = 12;
+
+WorldLoader::WorldLoader(Renderer& renderer, std::filesystem::path scene_path, ImportSettings settings)
+{
+	thread = std::thread([this, &renderer, scene_path = std::move(scene_path), settings = std::move(settings)]() mutable {
+		load(renderer, scene_path, std::move(settings));
+	});
+}
+
+WorldLoader::~WorldLoader()
+{
+	if (thread.joinable())
+		thread.join();
+}
+
+void WorldLoader::load(Renderer& renderer, const std::filesystem::path& scene_path, ImportSettings settings)
+{
+	try {
+		uint32_t stages = 0;
+		settings.on_stage = [this, &stages](std::string_view stage) {
+			setProgress(stage, IMPORT_SHARE * std::min(1.0f, static_cast<float>(++stages) / IMPORT_STAGES));
+		};
+
+		auto scene = AssetImporter::loadScene(scene_path.string(), settings);
+
+		auto new_world = std::make_unique<World>();
+		new_world->setActiveScene(std::move(scene));
+
+		auto new_render_scene = renderer.createRenderScene(*new_world);
+		setProgress("GPU Resources", IMPORT_SHARE + BUILD_SHARE);
+
+		// Full resolution is streamed here rather than after the swap, the new world shows up complete
+		auto total = std::max<size_t>(1, new_render_scene->getStreamingCount());
+		while (new_render_scene->stream()) {
+			auto streamed = 1.0f - static_cast<float>(new_render_scene->getStreamingCount()) / total;
+			setProgress("Streaming", IMPORT_SHARE + BUILD_SHARE + (1.0f - IMPORT_SHARE - BUILD_SHARE) * streamed);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		world = std::move(new_world);
+		render_scene = std::move(new_render_scene);
+		setProgress("Ready", 1.0f);
+		state = State::Ready;
+
+	} catch (const std::exception& e) {
+		{
+			std::lock_guard lock(mutex);
+			error = e.what();
+		}
+		Logger::error(std::format("Failed to load {}: {}", scene_path.string(), e.what()));
+		state = State::Failed;
+	}
+
+	renderer.getContext().releaseThreadCommandPool();
+}
+
+void WorldLoader::setProgress(std::string_view new_stage, float new_progress)
+{
+	std::lock_guard lock(mutex);
+	stage = new_stage;
+	progress = new_progress;
+}
+
+WorldLoader::State WorldLoader::getState() const
+{
+	return state;
+}
+
+std::string WorldLoader::getStage() const
+{
+	std::lock_guard lock(mutex);
+	return stage;
+}
+
+float WorldLoader::getProgress() const
+{
+	std::lock_guard lock(mutex);
+	return progress;
+}
+
+std::string WorldLoader::getError() const
+{
+	std::lock_guard lock(mutex);
+	return error;
+}
+
+std::unique_ptr<World> WorldLoader::takeWorld()
+{
+	return state == State::Ready ? std::move(world) : nullptr;
+}
+
+std::unique_ptr<RenderScene> WorldLoader::takeRenderScene()
+{
+	return state == State::Ready ? std::move(render_scene) : nullptr;
+}
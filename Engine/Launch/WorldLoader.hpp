@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <filesystem>
+
+#include "Render/Renderer.hpp"
+#include "Scene/World.hpp"
+#include "Utils/AssetImporter.hpp"
+
+// Imports a scene and builds its GPU resources on a background thread while the current world keeps rendering.
+// The main loop polls the state and hands the result to Renderer::setActiveWorld once every texture is resident
+class WorldLoader {
+public:
+	enum class State {
+		Loading,
+		Ready,
+		Failed,
+	};
+
+private:
+	std::thread        thread;
+	std::atomic<State> state{State::Loading};
+
+	mutable std::mutex mutex;
+	std::string        stage;
+	float              progress{0.0f};
+	std::string        error;
+
+	std::unique_ptr<World>       world;
+	std::unique_ptr<RenderScene> render_scene;
+
+	void load(Renderer& renderer, const std::filesystem::path& scene_path, ImportSettings settings);
+	void setProgress(std::string_view new_stage, float new_progress);
+
+public:
+	WorldLoader(Renderer& renderer, std::filesystem::path scene_path, ImportSettings settings = {});
+	// Waits for the load to finish, an import cannot be cancelled halfway
+	~WorldLoader();
+
+	WorldLoader(const WorldLoader&) = delete;
+	WorldLoader& operator=(const WorldLoader&) = delete;
+
+	WorldLoader(WorldLoader&&) noexcept = delete;
+	WorldLoader& operator=(WorldLoader&&) noexcept = delete;
+
+	State getState() const;
+	// Last finished stage and an estimate of the finished fraction of the whole load
+	auto  getStage() const -> std::string;
+	float getProgress() const;
+	auto  getError() const -> std::string;
+
+	// Valid once the state is Ready
+	auto takeWorld() -> std::unique_ptr<World>;
+	auto takeRenderScene() -> std::unique_ptr<RenderScene>;
+};
@@ -135,10 +135,21 @@ std::unique_ptr<Buffer> Buffer::createStatic(Context& context, vk::BufferUsageFl
 	if (!src || size == 0)
 		return nullptr;
 
+	return createStatic(context, Usage, size, [src, size](void* dst) { std::memcpy(dst, src, size); });
+}
+
+// The writer fills the mapped staging memory directly, so callers can produce data without an intermediate copy
+std::unique_ptr<Buffer> Buffer::createStatic(Context& context, vk::BufferUsageFlags Usage, size_t size, const std::function<void(void*)>& write)
+{
+	if (size == 0)
+		return nullptr;
+
 	auto host_buffer = std::make_unique<Buffer>(context, size,
 	    vk::BufferUsageFlagBits::eTransferSrc,
 	    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-	host_buffer->upload(src, size);
+	host_buffer->map(size);
+	write(host_buffer->data);
+	host_buffer->unmap();
 
 	auto device_buffer = std::make_unique<Buffer>(context, size,
 	    Usage | vk::BufferUsageFlagBits::eTransferDst,
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
@@ -47,6 +49,7 @@ public:
 	void upload(const void* src, size_t src_size, size_t dst_offset = 0);
 
 	static std::unique_ptr<Buffer> createStatic(Context& context, vk::BufferUsageFlags Usage, const void* src, size_t size);
+	static std::unique_ptr<Buffer> createStatic(Context& context, vk::BufferUsageFlags Usage, size_t size, const std::function<void(void*)>& write);
 	static std::unique_ptr<Buffer> createDynamic(Context& context, vk::BufferUsageFlags Usage, const void* src, size_t size);
 
 	vk::Buffer        get() const;
@@ -22,6 +22,7 @@ Context::Context(Window& window) :
 
 Context::~Context()
 {
+	thread_command_pools.clear();
 	transfer_command_pool.reset();
 	graphics_command_pool.reset();
 	swap_chain.reset();
@@ -82,7 +83,16 @@ void Context::createCommandPools()
 
 void Context::execute(std::function<void(CommandBuffer)> func)
 {
-	auto command = transfer_command_pool->allocate();
+	CommandPool* pool{};
+	{
+		std::lock_guard lock(pool_mutex);
+		auto& thread_pool = thread_command_pools[std::this_thread::get_id()];
+		if (!thread_pool)
+			thread_pool = std::make_unique<CommandPool>(*this, device->graphicsQueueIndex(), vk::CommandPoolCreateFlagBits::eTransient);
+		pool = thread_pool.get();
+	}
+
+	auto command = pool->allocate();
 
 	command.begin();
 	func(command);
@@ -92,7 +102,7 @@ void Context::execute(std::function<void(CommandBuffer)> func)
 	submit({command}, &fence);
 	fence.wait();
 
-	transfer_command_pool->free(command);
+	pool->free(command);
 }
 
 void Context::submit(const std::vector<CommandBuffer>& cmds, Fence* fence,
@@ -110,6 +120,7 @@ void Context::submit(const std::vector<CommandBuffer>& cmds, Fence* fence,
 	    .setSignalSemaphores(vk_signals)
 	    .setWaitDstStageMask(stages);
 
+	std::lock_guard lock(queue_mutex);
 	device->graphicsQueue().submit(submit_info, fence ? fence->get() : nullptr);
 }
 
@@ -126,10 +137,23 @@ void Context::present(const std::vector<uint32_t>& images,
 	    .setSwapchains(vk_sc)
 	    .setWaitSemaphores(vk_waits);
 
+	std::lock_guard lock(queue_mutex);
 	if (device->presentQueue().presentKHR(present_info) != vk::Result::eSuccess)
 		throw std::runtime_error("Failed to present swap chain image");
 }
 
+void Context::waitIdle()
+{
+	std::lock_guard lock(queue_mutex);
+	device->logical().waitIdle();
+}
+
+void Context::releaseThreadCommandPool()
+{
+	std::lock_guard lock(pool_mutex);
+	thread_command_pools.erase(std::this_thread::get_id());
+}
+
 std::vector<const char*> Context::requestExtensions()
 {
 	auto count = 0u;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <mutex>
+#include <thread>
 #include <functional>
+#include <unordered_map>
 
 #include <vulkan/vulkan.hpp>
 
@@ -24,6 +27,12 @@ private:
 	std::unique_ptr<CommandPool> graphics_command_pool;
 	std::unique_ptr<CommandPool> transfer_command_pool;
 
+	// One pool per thread calling execute, so scenes can upload from a loader thread while frames are recorded
+	std::unordered_map<std::thread::id, std::unique_ptr<CommandPool>> thread_command_pools;
+
+	std::mutex pool_mutex;
+	std::mutex queue_mutex;
+
 	Window* window{};
 
 	void createInstance();
@@ -42,8 +51,8 @@ public:
 	Context(const Context&) = delete;
 	Context& operator=(const Context&) = delete;
 
-	Context(Context&&) noexcept = default;
-	Context& operator=(Context&&) noexcept = default;
+	Context(Context&&) noexcept = delete;
+	Context& operator=(Context&&) noexcept = delete;
 
 	void execute(std::function<void(CommandBuffer)> func);
 
@@ -55,6 +64,11 @@ public:
 	void present(const std::vector<uint32_t>& images,
 	    const std::vector<Semaphore*>&        waits = {});
 
+	// Device wait that holds the queue lock, waiting idle while another thread submits is not allowed
+	void waitIdle();
+	// Destroys the execute pool of the calling thread, for threads that finish before the context
+	void releaseThreadCommandPool();
+
 	vk::Instance   getInstance() const;
 	vk::SurfaceKHR getSurface() const;
 
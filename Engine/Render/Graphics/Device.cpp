@@ -51,8 +51,14 @@ void Device::createLogicalDevice()
 		queue_create_infos.push_back(std::move(queue_create_info));
 	}
 
+	// Optional features are enabled only where the device has them, users check getEnabledFeatures()
+	auto supported_features = physical_device.getFeatures();
+	enabled_features.setSamplerAnisotropy(supported_features.samplerAnisotropy)
+	    .setTextureCompressionBC(supported_features.textureCompressionBC);
+
 	vk::DeviceCreateInfo create_info{};
 	create_info.setQueueCreateInfos(queue_create_infos)
+	    .setPEnabledFeatures(&enabled_features)
 	    .setEnabledLayerCount(layers.size())
 	    .setPEnabledLayerNames(layers)
 	    .setEnabledExtensionCount(extensions.size())
@@ -109,6 +115,11 @@ vk::Device Device::logical() const
 	return logical_device;
 }
 
+const vk::PhysicalDeviceFeatures& Device::getEnabledFeatures() const
+{
+	return enabled_features;
+}
+
 vk::Queue Device::graphicsQueue() const
 {
 	return graphics_queue;
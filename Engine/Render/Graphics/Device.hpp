@@ -18,6 +18,8 @@ private:
 	vk::Queue          graphics_queue;
 	vk::Queue          present_queue;
 
+	vk::PhysicalDeviceFeatures enabled_features{};
+
 	std::vector<std::string> extensions{};
 	std::vector<std::string> layers{};
 
@@ -48,6 +50,8 @@ public:
 	vk::Queue          graphicsQueue() const;
 	vk::Queue          presentQueue() const;
 
+	const vk::PhysicalDeviceFeatures& getEnabledFeatures() const;
+
 	uint32_t graphicsQueueIndex() const;
 	uint32_t presentQueueIndex() const;
 };
\ No newline at end of file
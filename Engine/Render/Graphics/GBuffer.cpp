@@ -6,7 +6,7 @@ GBuffer::GBuffer(Context& ctx, uint32_t width, uint32_t height,
     width(width),
     height(height),
     attachment_infos(std::move(attachment_infos)),
-    sampler(std::make_unique<Sampler>(ctx))
+    sampler(std::make_unique<Sampler>(ctx, SamplerSettings{.max_lod = 0.0f, .max_anisotropy = 1.0f}))
 {
 	createAttachments();
 }
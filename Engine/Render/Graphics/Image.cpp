@@ -15,10 +15,36 @@ Image::Image(Context& context, const uint8_t* data, uint32_t width, uint32_t hei
 		copyBufferToImage(command.get(), buffer->get(), image, width, height);
 		transitionImageLayout(command.get(), image, format, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
 	});
+	releaseStaging();
 
 	createImageView(format, vk::ImageAspectFlagBits::eColor);
 }
 
+Image::Image(Context& context, std::span<const uint8_t> data, std::span<const ImageLevel> levels, vk::Format format) :
+    context(&context), format(format), width(levels.front().width), height(levels.front().height), channels(4),
+    mip_levels(static_cast<uint32_t>(levels.size())), data(data.data())
+{
+	createBuffer(static_cast<uint32_t>(data.size()));
+	createImage(width, height, format, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, mip_levels);
+	allocateMemory();
+
+	context.execute([&](CommandBuffer command) {
+		recordUpload(command.get(), *buffer, levels);
+	});
+	releaseStaging();
+
+	createImageView(format, vk::ImageAspectFlagBits::eColor);
+}
+
+Image::Image(Context& context, std::span<const ImageLevel> levels, vk::Format format) :
+    context(&context), format(format), width(levels.front().width), height(levels.front().height), channels(4),
+    mip_levels(static_cast<uint32_t>(levels.size()))
+{
+	createImage(width, height, format, vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled, mip_levels);
+	allocateMemory();
+	createImageView(format, vk::ImageAspectFlagBits::eColor);
+}
+
 Image::Image(Context& context, uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage) :
     context(&context), format(format), width(width), height(height)
 {
@@ -50,12 +76,19 @@ void Image::createBuffer(uint32_t image_size)
 	buffer->upload(data, image_size);
 }
 
-void Image::createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage)
+// The upload has completed once execute returns, neither the staging memory nor the source is needed afterwards
+void Image::releaseStaging()
+{
+	buffer.reset();
+	data = nullptr;
+}
+
+void Image::createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage, uint32_t mip_levels)
 {
 	vk::ImageCreateInfo create_info{};
 	create_info.setImageType(vk::ImageType::e2D)
 	    .setExtent({width, height, 1})
-	    .setMipLevels(1)
+	    .setMipLevels(mip_levels)
 	    .setArrayLayers(1)
 	    .setFormat(format)
 	    .setTiling(vk::ImageTiling::eOptimal)
@@ -86,11 +119,18 @@ void Image::createImageView(vk::Format format, vk::ImageAspectFlags aspect_flags
 	vk::ImageSubresourceRange range{};
 	vk::ComponentMapping      mapping{};
 	range.setBaseMipLevel(0)
-	    .setLevelCount(1)
+	    .setLevelCount(mip_levels)
 	    .setBaseArrayLayer(0)
 	    .setLayerCount(1)
 	    .setAspectMask(aspect_flags);
 
+	// Single channel data reads as grayscale so shaders see the same channels the RGBA source had
+	if (format == vk::Format::eBc4UnormBlock)
+		mapping.setR(vk::ComponentSwizzle::eR)
+		    .setG(vk::ComponentSwizzle::eR)
+		    .setB(vk::ComponentSwizzle::eR)
+		    .setA(vk::ComponentSwizzle::eOne);
+
 	vk::ImageViewCreateInfo create_info{};
 	create_info.setImage(image)
 	    .setViewType(vk::ImageViewType::e2D)
@@ -120,12 +160,43 @@ void Image::copyBufferToImage(vk::CommandBuffer command, vk::Buffer buffer, vk::
 	command.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, region);
 }
 
+void Image::copyBufferToImage(vk::CommandBuffer command, vk::Buffer buffer, vk::Image image, std::span<const ImageLevel> levels)
+{
+	std::vector<vk::BufferImageCopy> regions;
+	for (uint32_t level = 0; level < levels.size(); level++) {
+		vk::ImageSubresourceLayers layers{};
+		layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		    .setMipLevel(level)
+		    .setBaseArrayLayer(0)
+		    .setLayerCount(1);
+
+		vk::BufferImageCopy region{};
+		region.setBufferOffset(levels[level].offset)
+		    .setBufferRowLength(0)
+		    .setBufferImageHeight(0)
+		    .setImageSubresource(layers)
+		    .setImageOffset({0, 0, 0})
+		    .setImageExtent({levels[level].width, levels[level].height, 1});
+		regions.push_back(region);
+	}
+
+	command.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, regions);
+}
+
+// Records the copy of every level from staging, the image ends up ready for sampling
+void Image::recordUpload(vk::CommandBuffer command, const Buffer& staging, std::span<const ImageLevel> levels)
+{
+	transitionImageLayout(command, image, format, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal);
+	copyBufferToImage(command, staging.get(), image, levels);
+	transitionImageLayout(command, image, format, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal);
+}
+
 void Image::transitionImageLayout(vk::CommandBuffer command, vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout)
 {
 	vk::ImageSubresourceRange range{};
 	range.setAspectMask(vk::ImageAspectFlagBits::eColor)
 	    .setBaseMipLevel(0)
-	    .setLevelCount(1)
+	    .setLevelCount(mip_levels)
 	    .setBaseArrayLayer(0)
 	    .setLayerCount(1);
 
@@ -184,6 +255,11 @@ vk::Format Image::getFormat() const
 	return format;
 }
 
+uint32_t Image::getMipLevels() const
+{
+	return mip_levels;
+}
+
 void Image::setSampler(Sampler& sampler)
 {
 	this->sampler = &sampler;
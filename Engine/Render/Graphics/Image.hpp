@@ -1,11 +1,20 @@
 #pragma once
 
+#include <span>
+
 #include <vulkan/vulkan.hpp>
 
 #include "Context.hpp"
 #include "Buffer.hpp"
 #include "Sampler.hpp"
 
+// One mip level of the upload data, each level halves the previous one
+struct ImageLevel {
+	uint64_t offset = 0;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
 class Image {
 private:
 	vk::Image        image;
@@ -13,9 +22,10 @@ private:
 	vk::DeviceMemory memory;
 	vk::Format       format;
 
-	int width{};
-	int height{};
-	int channels{};
+	int      width{};
+	int      height{};
+	int      channels{};
+	uint32_t mip_levels{1};
 
 	const void* data{};
 
@@ -28,6 +38,9 @@ private:
 
 public:
 	Image(Context& context, const uint8_t* data, uint32_t width, uint32_t height, vk::Format format = vk::Format::eR8G8B8A8Srgb);
+	Image(Context& context, std::span<const uint8_t> data, std::span<const ImageLevel> levels, vk::Format format = vk::Format::eR8G8B8A8Srgb);
+	// Sampled image with storage for every level, filled later by recordUpload
+	Image(Context& context, std::span<const ImageLevel> levels, vk::Format format);
 	Image(Context& context, uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage);
 	~Image();
 
@@ -38,16 +51,20 @@ public:
 	Image& operator=(Image&&) noexcept = default;
 
 	void createBuffer(uint32_t image_size);
-	void createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage);
+	void releaseStaging();
+	void createImage(uint32_t width, uint32_t height, vk::Format format, vk::ImageUsageFlags usage, uint32_t mip_levels = 1);
 	void allocateMemory();
 	void createImageView(vk::Format format, vk::ImageAspectFlags aspect_flags);
 
 	void copyBufferToImage(vk::CommandBuffer command, vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height);
+	void copyBufferToImage(vk::CommandBuffer command, vk::Buffer buffer, vk::Image image, std::span<const ImageLevel> levels);
 	void transitionImageLayout(vk::CommandBuffer command, vk::Image image, vk::Format format, vk::ImageLayout old_layout, vk::ImageLayout new_layout);
+	void recordUpload(vk::CommandBuffer command, const Buffer& staging, std::span<const ImageLevel> levels);
 
 	vk::Image     get() const;
 	vk::ImageView getView() const;
 	vk::Format    getFormat() const;
+	uint32_t      getMipLevels() const;
 
 	void     setSampler(Sampler& sampler);
 	Sampler& getSampler() const;
@@ -1,9 +1,11 @@
 #include "Sampler.hpp"
 
+#include <algorithm>
+
 #include "Device.hpp"
 
-Sampler::Sampler(Context& context) :
-    context(&context)
+Sampler::Sampler(Context& context, const SamplerSettings& settings) :
+    settings(settings), context(&context)
 {
 	create();
 }
@@ -15,13 +17,21 @@ Sampler::~Sampler()
 
 void Sampler::create()
 {
+	float max_anisotropy = 1.0f;
+	if (context->getDevice().getEnabledFeatures().samplerAnisotropy)
+		max_anisotropy = std::min(settings.max_anisotropy, context->getDevice().physical().getProperties().limits.maxSamplerAnisotropy);
+
 	vk::SamplerCreateInfo create_info{};
 	create_info.setMagFilter(vk::Filter::eLinear)
 	    .setMinFilter(vk::Filter::eLinear)
 	    .setAddressModeU(vk::SamplerAddressMode::eRepeat)
 	    .setAddressModeV(vk::SamplerAddressMode::eRepeat)
 	    .setAddressModeW(vk::SamplerAddressMode::eRepeat)
-	    .setAnisotropyEnable(vk::False)
+	    .setAnisotropyEnable(max_anisotropy > 1.0f ? vk::True : vk::False)
+	    .setMaxAnisotropy(std::max(max_anisotropy, 1.0f))
+	    .setMinLod(settings.min_lod)
+	    .setMaxLod(settings.max_lod)
+	    .setMipLodBias(settings.mip_lod_bias)
 	    .setBorderColor(vk::BorderColor::eIntOpaqueBlack)
 	    .setUnnormalizedCoordinates(vk::False)
 	    .setCompareEnable(vk::False)
@@ -36,6 +46,11 @@ vk::Sampler Sampler::get() const
 	return sampler;
 }
 
+const SamplerSettings& Sampler::getSettings() const
+{
+	return settings;
+}
+
 vk::DescriptorSetLayoutBinding Sampler::binding(uint32_t binding)
 {
 	vk::DescriptorSetLayoutBinding layout_binding{};
@@ -4,13 +4,21 @@
 
 #include "Context.hpp"
 
+struct SamplerSettings {
+	float min_lod = 0.0f;
+	float max_lod = vk::LodClampNone;
+	float mip_lod_bias = 0.0f;
+	float max_anisotropy = 16.0f; // Clamped to the device limit, 1 disables anisotropic filtering
+};
+
 class Sampler {
-	vk::Sampler sampler;
+	vk::Sampler     sampler;
+	SamplerSettings settings;
 
 	Context* context{};
 
 public:
-	Sampler(Context& context);
+	Sampler(Context& context, const SamplerSettings& settings = {});
 	~Sampler();
 
 	Sampler(const Sampler&) = delete;
@@ -21,7 +29,8 @@ public:
 
 	void create();
 
-	vk::Sampler get() const;
+	vk::Sampler            get() const;
+	const SamplerSettings& getSettings() const;
 
 	static vk::DescriptorSetLayoutBinding binding(uint32_t binding = {});
 };
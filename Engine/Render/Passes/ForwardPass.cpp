@@ -95,7 +95,7 @@ void ForwardPass::initialize(Context& ctx, vk::Extent2D ext)
 void ForwardPass::cleanup()
 {
 	if (context) {
-		context->getDevice().logical().waitIdle();
+		context->waitIdle();
 		pass.reset();
 		depth_image.reset();
 	}
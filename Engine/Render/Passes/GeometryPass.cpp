@@ -189,7 +189,7 @@ void GeometryPass::initialize(Context& ctx, vk::Extent2D ext)
 void GeometryPass::cleanup()
 {
 	if (context) {
-		context->getDevice().logical().waitIdle();
+		context->waitIdle();
 		pass.reset();
 		gbuffer = nullptr;
 	}
@@ -74,7 +74,7 @@ void LightingPass::initialize(Context& ctx, vk::Extent2D ext)
 void LightingPass::cleanup()
 {
 	if (context) {
-		context->getDevice().logical().waitIdle();
+		context->waitIdle();
 
 		gbuffer_pool.reset();
 		gbuffer_layout.reset();
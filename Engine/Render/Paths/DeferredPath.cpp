@@ -36,7 +36,7 @@ void DeferredPath::initialize(Context& ctx)
 void DeferredPath::cleanup()
 {
 	if (context) {
-		context->getDevice().logical().waitIdle();
+		context->waitIdle();
 
 		gbuffer.reset();
 		geometry_pipeline.reset();
@@ -26,7 +26,7 @@ void ForwardPath::initialize(Context& ctx)
 void ForwardPath::cleanup()
 {
 	if (context) {
-		context->getDevice().logical().waitIdle();
+		context->waitIdle();
 
 		forward_pipeline.reset();
 		forward_pass.reset();
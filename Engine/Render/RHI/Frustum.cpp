@@ -0,0 +1,33 @@
+#include "Frustum.hpp"
+
+// Gribb/Hartmann plane extraction for a [0, 1] depth range
+Frustum::Frustum(const glm::mat4& view_projection)
+{
+	auto row = [&](int i) { return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]); };
+
+	planes = {
+	    row(3) + row(0),
+	    row(3) - row(0),
+	    row(3) + row(1),
+	    row(3) - row(1),
+	    row(2),
+	    row(3) - row(2),
+	};
+
+	for (auto& plane : planes)
+		plane /= glm::length(glm::vec3(plane));
+}
+
+bool Frustum::intersectsSphere(const glm::vec3& center, float radius) const
+{
+	for (const auto& plane : planes)
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			return false;
+
+	return true;
+}
+
+auto Frustum::getPlanes() const -> const std::array<glm::vec4, 6>&
+{
+	return planes;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+// View frustum as six inward facing planes (xyz normal, w distance) in the space of the matrix it was built from
+class Frustum {
+private:
+	std::array<glm::vec4, 6> planes{};
+
+public:
+	Frustum() = default;
+	Frustum(const glm::mat4& view_projection);
+
+	bool intersectsSphere(const glm::vec3& center, float radius) const;
+
+	auto getPlanes() const -> const std::array<glm::vec4, 6>&;
+};
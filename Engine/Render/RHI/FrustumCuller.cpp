@@ -0,0 +1,145 @@
+#include "FrustumCuller.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#	define VORTEX_AVX 1
+#	include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VORTEX_SSE2 1
+#	include <emmintrin.h>
+#endif
+
+// Extent of a draw without bounds, large enough to pass every plane and small enough to stay finite when summed
+constexpr float UNBOUNDED_EXTENT = 1e30f;
+
+void FrustumCuller::resize(size_t count)
+{
+	this->count = count;
+	visible_count = count;
+
+	size_t padded = (count + block_size - 1) / block_size * block_size;
+	for (auto* axis : {&center_x, &center_y, &center_z})
+		axis->assign(padded, 0.0f);
+	for (auto* axis : {&extent_x, &extent_y, &extent_z})
+		axis->assign(padded, UNBOUNDED_EXTENT);
+	visible.assign(padded, 1);
+}
+
+void FrustumCuller::setBounds(size_t index, const glm::vec3& min, const glm::vec3& max)
+{
+	auto center = (min + max) * 0.5f;
+	auto extent = (max - min) * 0.5f;
+
+	center_x[index] = center.x;
+	center_y[index] = center.y;
+	center_z[index] = center.z;
+	extent_x[index] = extent.x;
+	extent_y[index] = extent.y;
+	extent_z[index] = extent.z;
+}
+
+void FrustumCuller::setUnbounded(size_t index)
+{
+	center_x[index] = center_y[index] = center_z[index] = 0.0f;
+	extent_x[index] = extent_y[index] = extent_z[index] = UNBOUNDED_EXTENT;
+}
+
+size_t FrustumCuller::cull(const Frustum& frustum)
+{
+	cullBlocks(frustum);
+
+	// Padding lanes carry unbounded boxes and pass, only real draws are counted
+	visible_count = static_cast<size_t>(std::count(visible.begin(), visible.begin() + count, uint8_t{1}));
+	return visible_count;
+}
+
+// Signed distance of the box center to the plane plus the projected radius of the box, negative when fully outside
+void FrustumCuller::cullBlocks(const Frustum& frustum)
+{
+	const auto& planes = frustum.getPlanes();
+
+	for (size_t block = 0; block < visible.size(); block += block_size) {
+#if defined(VORTEX_AVX)
+		__m256 center[3] = {_mm256_loadu_ps(&center_x[block]), _mm256_loadu_ps(&center_y[block]), _mm256_loadu_ps(&center_z[block])};
+		__m256 extent[3] = {_mm256_loadu_ps(&extent_x[block]), _mm256_loadu_ps(&extent_y[block]), _mm256_loadu_ps(&extent_z[block])};
+		__m256 outside = _mm256_setzero_ps();
+
+		for (const auto& plane : planes) {
+			__m256 distance = _mm256_set1_ps(plane.w);
+			for (int axis = 0; axis < 3; axis++) {
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(center[axis], _mm256_set1_ps(plane[axis])));
+				distance = _mm256_add_ps(distance, _mm256_mul_ps(extent[axis], _mm256_set1_ps(std::abs(plane[axis]))));
+			}
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+		}
+
+		int mask = _mm256_movemask_ps(outside);
+		for (size_t lane = 0; lane < block_size; lane++)
+			visible[block + lane] = (mask >> lane) & 1 ? 0 : 1;
+#elif defined(VORTEX_SSE2)
+		for (size_t half = block; half < block + block_size; half += 4) {
+			__m128 center[3] = {_mm_loadu_ps(&center_x[half]), _mm_loadu_ps(&center_y[half]), _mm_loadu_ps(&center_z[half])};
+			__m128 extent[3] = {_mm_loadu_ps(&extent_x[half]), _mm_loadu_ps(&extent_y[half]), _mm_loadu_ps(&extent_z[half])};
+			__m128 outside = _mm_setzero_ps();
+
+			for (const auto& plane : planes) {
+				__m128 distance = _mm_set1_ps(plane.w);
+				for (int axis = 0; axis < 3; axis++) {
+					distance = _mm_add_ps(distance, _mm_mul_ps(center[axis], _mm_set1_ps(plane[axis])));
+					distance = _mm_add_ps(distance, _mm_mul_ps(extent[axis], _mm_set1_ps(std::abs(plane[axis]))));
+				}
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+			}
+
+			int mask = _mm_movemask_ps(outside);
+			for (size_t lane = 0; lane < 4; lane++)
+				visible[half + lane] = (mask >> lane) & 1 ? 0 : 1;
+		}
+#else
+		for (size_t index = block; index < block + block_size; index++) {
+			visible[index] = 1;
+			for (const auto& plane : planes) {
+				float distance = plane.w
+				    + center_x[index] * plane.x + center_y[index] * plane.y + center_z[index] * plane.z
+				    + extent_x[index] * std::abs(plane.x) + extent_y[index] * std::abs(plane.y) + extent_z[index] * std::abs(plane.z);
+				if (distance < 0.0f) {
+					visible[index] = 0;
+					break;
+				}
+			}
+		}
+#endif
+	}
+}
+
+bool FrustumCuller::isVisible(size_t index) const
+{
+	return visible[index] != 0;
+}
+
+glm::vec3 FrustumCuller::getCenter(size_t index) const
+{
+	return {center_x[index], center_y[index], center_z[index]};
+}
+
+glm::vec3 FrustumCuller::getExtent(size_t index) const
+{
+	return {extent_x[index], extent_y[index], extent_z[index]};
+}
+
+size_t FrustumCuller::size() const
+{
+	return count;
+}
+
+size_t FrustumCuller::getVisibleCount() const
+{
+	return visible_count;
+}
+
+size_t FrustumCuller::getCulledCount() const
+{
+	return count - visible_count;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+
+// World bounds of every draw as center and extent arrays per axis, padded to whole blocks so the frustum test runs
+// eight boxes at a time without a tail. A box is culled once it lies fully behind any plane
+class FrustumCuller {
+private:
+	std::vector<float>   center_x, center_y, center_z;
+	std::vector<float>   extent_x, extent_y, extent_z;
+	std::vector<uint8_t> visible;
+	size_t               count{0};
+	size_t               visible_count{0};
+
+	void cullBlocks(const Frustum& frustum);
+
+public:
+	FrustumCuller() = default;
+
+	// Drops every box, new draws start unbounded and always visible
+	void resize(size_t count);
+	void setBounds(size_t index, const glm::vec3& min, const glm::vec3& max);
+	void setUnbounded(size_t index);
+
+	// Returns the number of visible draws
+	size_t cull(const Frustum& frustum);
+
+	bool   isVisible(size_t index) const;
+	auto   getCenter(size_t index) const -> glm::vec3;
+	auto   getExtent(size_t index) const -> glm::vec3;
+	size_t size() const;
+	size_t getVisibleCount() const;
+	size_t getCulledCount() const;
+
+	static constexpr size_t block_size = 8;
+};
@@ -1,44 +1,277 @@
 #include "GpuData.hpp"
 
-vk::VertexInputBindingDescription GpuVertex::binding(uint32_t binding)
+#include <cfloat>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include <glm/gtc/packing.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VORTEX_SSE2 1
+#	include <emmintrin.h>
+#endif
+
+// Vertices converted per block, small enough that the four attribute blocks stay in L1
+constexpr size_t PACK_BLOCK = 64;
+
+using PackLanes = float[4];
+
+// Converts one component to float following the glTF rules for normalized integers
+template <typename T>
+static float toFloat(T value, bool normalized)
 {
-	return {
-	    binding,
-	    sizeof(GpuVertex),
-	    vk::VertexInputRate::eVertex,
-	};
+	if constexpr (std::is_floating_point_v<T>) {
+		return static_cast<float>(value);
+	} else {
+		if (!normalized)
+			return static_cast<float>(value);
+		if constexpr (std::is_signed_v<T>)
+			return std::max(static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max()), -1.0f);
+		else
+			return static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+	}
 }
 
-std::vector<vk::VertexInputAttributeDescription> GpuVertex::attributes(uint32_t binding)
+// Expands a block of vertices of one attribute into four float lanes, lanes the source lacks keep their defaults
+template <typename T>
+static void convertBlock(const VertexAttribute& attribute, size_t first, size_t count, uint32_t components, PackLanes* lanes)
 {
-	return {
-	    {
-	        0,
-	        binding,
-	        vk::Format::eR32G32B32Sfloat,
-	        offsetof(GpuVertex, pos),
-	    },
-	    {
-	        1,
-	        binding,
-	        vk::Format::eR32G32B32Sfloat,
-	        offsetof(GpuVertex, normal),
-	    },
-	    {
-	        2,
-	        binding,
-	        vk::Format::eR32G32Sfloat,
-	        offsetof(GpuVertex, uv),
-	    },
-	    {
-	        3,
-	        binding,
-	        vk::Format::eR32G32B32A32Sfloat,
-	        offsetof(GpuVertex, color),
-	    },
-	};
+	const uint8_t* source = attribute.data.data() + first * attribute.stride;
+	for (size_t i = 0; i < count; i++, source += attribute.stride) {
+		T values[4];
+		std::memcpy(values, source, components * sizeof(T));
+		for (uint32_t c = 0; c < components; c++)
+			lanes[i][c] = toFloat(values[c], attribute.normalized);
+	}
+}
+
+static void convertBlock(const VertexAttribute& attribute, size_t first, size_t count, PackLanes* lanes)
+{
+	uint32_t components = std::min(attribute.components, 4u);
+	switch (attribute.component_type) {
+	case ComponentType::Float:
+		convertBlock<float>(attribute, first, count, components, lanes);
+		break;
+	case ComponentType::Byte:
+		convertBlock<int8_t>(attribute, first, count, components, lanes);
+		break;
+	case ComponentType::UnsignedByte:
+		convertBlock<uint8_t>(attribute, first, count, components, lanes);
+		break;
+	case ComponentType::Short:
+		convertBlock<int16_t>(attribute, first, count, components, lanes);
+		break;
+	case ComponentType::UnsignedShort:
+		convertBlock<uint16_t>(attribute, first, count, components, lanes);
+		break;
+	case ComponentType::UnsignedInt:
+		convertBlock<uint32_t>(attribute, first, count, components, lanes);
+		break;
+	}
+}
+
+// Attribute blocks of one submesh, missing attributes keep their default lanes
+struct PackStream {
+	const VertexAttribute* attribute;
+	alignas(16) PackLanes  lanes[PACK_BLOCK];
+};
+
+constexpr const char* PACK_ATTRIBUTES[4] = {"POSITION", "NORMAL", "TEXCOORD_0", "COLOR_0"};
+constexpr float       PACK_DEFAULTS[4][4] = {
+    {0.0f, 0.0f, 0.0f, 1.0f},
+    {0.0f, 0.0f, 1.0f, 1.0f},
+    {0.0f, 0.0f, 0.0f, 1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f},
+};
+
+// Walks the vertices block by block, func(first, count, streams) sees the streams selected by mask converted to floats
+template <typename Func>
+static void convertStreams(const SubMesh& submesh, size_t vertex_count, uint32_t mask, Func&& func)
+{
+	auto streams = std::make_unique<PackStream[]>(4);
+	for (size_t a = 0; a < 4; a++) {
+		const auto* attribute = submesh.getAttribute(PACK_ATTRIBUTES[a]);
+		streams[a].attribute = (mask & (1u << a)) && attribute && !attribute->data.empty() ? attribute : nullptr;
+		for (auto& lanes : streams[a].lanes)
+			std::copy_n(PACK_DEFAULTS[a], 4, lanes);
+	}
+
+	for (size_t first = 0; first < vertex_count; first += PACK_BLOCK) {
+		size_t count = std::min(PACK_BLOCK, vertex_count - first);
+		for (size_t a = 0; a < 4; a++)
+			if (streams[a].attribute)
+				convertBlock(*streams[a].attribute, first, count, streams[a].lanes);
+
+		func(first, count, streams.get());
+	}
+}
+
+// Interleaves the converted lanes into FullVertex rows, each vertex is written once as three 16 byte stores
+static void assembleBlock(const PackStream* streams, size_t count, FullVertex* out)
+{
+	static_assert(sizeof(FullVertex) == 12 * sizeof(float));
+
+	const auto& pos = streams[0].lanes;
+	const auto& normal = streams[1].lanes;
+	const auto& uv = streams[2].lanes;
+	const auto& color = streams[3].lanes;
+
+	float* dst = reinterpret_cast<float*>(out);
+	for (size_t i = 0; i < count; i++, dst += 12) {
+#ifdef VORTEX_SSE2
+		__m128 p = _mm_load_ps(pos[i]);
+		__m128 n = _mm_load_ps(normal[i]);
+		__m128 t = _mm_load_ps(uv[i]);
+		__m128 c = _mm_load_ps(color[i]);
+
+		__m128 pz_nx = _mm_shuffle_ps(p, n, _MM_SHUFFLE(0, 0, 2, 2));
+		_mm_storeu_ps(dst + 0, _mm_shuffle_ps(p, pz_nx, _MM_SHUFFLE(2, 0, 1, 0)));
+		_mm_storeu_ps(dst + 4, _mm_shuffle_ps(n, t, _MM_SHUFFLE(1, 0, 2, 1)));
+		_mm_storeu_ps(dst + 8, c);
+#else
+		std::memcpy(dst + 0, pos[i], 3 * sizeof(float));
+		std::memcpy(dst + 3, normal[i], 3 * sizeof(float));
+		std::memcpy(dst + 6, uv[i], 2 * sizeof(float));
+		std::memcpy(dst + 8, color[i], 4 * sizeof(float));
+#endif
+	}
+}
+
+void Float3Position::encode(const float* lanes, const VertexQuantization& quantization, Storage& out)
+{
+	out = {lanes[0], lanes[1], lanes[2]};
 }
 
+void Unorm16Position::encode(const float* lanes, const VertexQuantization& quantization, Storage& out)
+{
+	glm::vec3 position = (glm::vec3(lanes[0], lanes[1], lanes[2]) - quantization.offset) / quantization.scale;
+	uint64_t  packed = glm::packUnorm4x16(glm::vec4(glm::clamp(position, 0.0f, 1.0f), 0.0f));
+	std::memcpy(&out, &packed, sizeof(Storage));
+}
+
+void Float3Normal::encode(const float* lanes, Storage& out)
+{
+	out = {lanes[0], lanes[1], lanes[2]};
+}
+
+// Octahedral mapping: project onto |x|+|y|+|z| = 1 and fold the lower hemisphere over the diagonals
+void Oct16Normal::encode(const float* lanes, Storage& out)
+{
+	glm::vec3 normal(lanes[0], lanes[1], lanes[2]);
+	float     sum = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	glm::vec2 encoded = sum > 0.0f ? glm::vec2(normal.x, normal.y) / sum : glm::vec2(0.0f);
+	if (normal.z < 0.0f)
+		encoded = glm::vec2((1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+		    (1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f));
+
+	uint32_t packed = glm::packSnorm2x16(encoded);
+	std::memcpy(&out, &packed, sizeof(Storage));
+}
+
+void Float2TexCoord::encode(const float* lanes, Storage& out)
+{
+	out = {lanes[0], lanes[1]};
+}
+
+void Half2TexCoord::encode(const float* lanes, Storage& out)
+{
+	uint32_t packed = glm::packHalf2x16(glm::vec2(lanes[0], lanes[1]));
+	std::memcpy(&out, &packed, sizeof(Storage));
+}
+
+void Float4Color::encode(const float* lanes, Storage& out)
+{
+	out = {lanes[0], lanes[1], lanes[2], lanes[3]};
+}
+
+void Unorm8Color::encode(const float* lanes, Storage& out)
+{
+	uint32_t packed = glm::packUnorm4x8(glm::clamp(glm::vec4(lanes[0], lanes[1], lanes[2], lanes[3]), 0.0f, 1.0f));
+	std::memcpy(&out, &packed, sizeof(Storage));
+}
+
+// Position bounds of the submesh, encoded positions span the full unorm range inside them
+template <typename Position, typename Normal, typename TexCoord, typename Color>
+VertexQuantization VertexLayout<Position, Normal, TexCoord, Color>::quantization(const SubMesh& submesh)
+{
+	if constexpr (!quantized) {
+		return {};
+	} else {
+		glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+		convertStreams(submesh, submesh.getVerticesCount(), 1u << 0, [&min, &max](size_t, size_t count, const PackStream* streams) {
+			for (size_t i = 0; i < count; i++) {
+				const auto& lanes = streams[0].lanes[i];
+				min = glm::min(min, glm::vec3(lanes[0], lanes[1], lanes[2]));
+				max = glm::max(max, glm::vec3(lanes[0], lanes[1], lanes[2]));
+			}
+		});
+
+		if (submesh.getVerticesCount() == 0)
+			return {};
+
+		VertexQuantization quantization{.offset = min, .scale = max - min};
+		for (int c = 0; c < 3; c++)
+			if (quantization.scale[c] <= 0.0f)
+				quantization.scale[c] = 1.0f;
+
+		return quantization;
+	}
+}
+
+// Single pass over the output: every block of vertices is converted from the accessor views and written in
+// order, so packing straight into mapped (write combined) staging memory never reads it back
+template <typename Position, typename Normal, typename TexCoord, typename Color>
+void VertexLayout<Position, Normal, TexCoord, Color>::pack(const SubMesh& submesh, std::span<VertexLayout> vertices, const VertexQuantization& quantization)
+{
+	convertStreams(submesh, vertices.size(), 0xF, [&vertices, &quantization](size_t first, size_t count, const PackStream* streams) {
+		if constexpr (std::is_same_v<VertexLayout, FullVertex>) {
+			assembleBlock(streams, count, vertices.data() + first);
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				auto& vertex = vertices[first + i];
+				Position::encode(streams[0].lanes[i], quantization, vertex.pos);
+				Normal::encode(streams[1].lanes[i], vertex.normal);
+				TexCoord::encode(streams[2].lanes[i], vertex.uv);
+				Color::encode(streams[3].lanes[i], vertex.color);
+			}
+		}
+	});
+}
+
+// Cooked submeshes already store FullVertex arrays, their attributes are views into one interleaved blob
+template <typename Position, typename Normal, typename TexCoord, typename Color>
+auto VertexLayout<Position, Normal, TexCoord, Color>::packed(const SubMesh& submesh) -> std::span<const VertexLayout>
+{
+	if constexpr (quantized || octahedral) {
+		return {};
+	} else {
+		const auto* position = submesh.getAttribute("POSITION");
+		if (!position || position->stride != sizeof(VertexLayout) || submesh.getVerticesCount() == 0)
+			return {};
+
+		const uint8_t* base = position->data.data() - offsetof(VertexLayout, pos);
+		auto matches = [&submesh, base](const char* name, size_t offset, ComponentType component_type, uint32_t size) {
+			const auto* attribute = submesh.getAttribute(name);
+			return attribute && attribute->component_type == component_type && attribute->stride == sizeof(VertexLayout)
+			    && attribute->size == size && attribute->data.data() == base + offset;
+		};
+
+		if (!matches("POSITION", offsetof(VertexLayout, pos), Position::component_type, sizeof(typename Position::Storage))
+		    || !matches("NORMAL", offsetof(VertexLayout, normal), Normal::component_type, sizeof(typename Normal::Storage))
+		    || !matches("TEXCOORD_0", offsetof(VertexLayout, uv), TexCoord::component_type, sizeof(typename TexCoord::Storage))
+		    || !matches("COLOR_0", offsetof(VertexLayout, color), Color::component_type, sizeof(typename Color::Storage)))
+			return {};
+
+		return {reinterpret_cast<const VertexLayout*>(base), submesh.getVerticesCount()};
+	}
+}
+
+template struct VertexLayout<Float3Position, Float3Normal, Float2TexCoord, Float4Color>;
+template struct VertexLayout<Unorm16Position, Oct16Normal, Half2TexCoord, Unorm8Color>;
+
 vk::DescriptorSetLayoutBinding GpuSceneData::binding(uint32_t binding)
 {
 	return {
@@ -1,22 +1,144 @@
 #pragma once
 
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 
+#include "Scene/Resources/SubMesh.hpp"
+
 constexpr uint32_t MAX_LIGHTS = 16;
 
-struct GpuVertex {
-	glm::vec3 pos{0.0f};
-	glm::vec3 normal{0.0f, 0.0f, 1.0f};
-	glm::vec2 uv{0.0f};
-	glm::vec4 color{1.0f};
+// Maps encoded positions back to object space (offset + value * scale), identity for float positions
+struct VertexQuantization {
+	glm::vec3 offset{0.0f};
+	glm::vec3 scale{1.0f};
+};
+
+// Vertex stream encodings, each one stores four converted float lanes in its own format
+struct Float3Position {
+	using Storage = glm::vec3;
+	static constexpr auto format = vk::Format::eR32G32B32Sfloat;
+	static constexpr auto component_type = ComponentType::Float;
+	static constexpr bool quantized = false;
+
+	static void encode(const float* lanes, const VertexQuantization& quantization, Storage& out);
+};
+
+struct Unorm16Position {
+	using Storage = glm::u16vec4;
+	static constexpr auto format = vk::Format::eR16G16B16A16Unorm;
+	static constexpr auto component_type = ComponentType::UnsignedShort;
+	static constexpr bool quantized = true;
+
+	static void encode(const float* lanes, const VertexQuantization& quantization, Storage& out);
+};
+
+struct Float3Normal {
+	using Storage = glm::vec3;
+	static constexpr auto format = vk::Format::eR32G32B32Sfloat;
+	static constexpr auto component_type = ComponentType::Float;
+	static constexpr bool octahedral = false;
+
+	static void encode(const float* lanes, Storage& out);
+};
+
+struct Oct16Normal {
+	using Storage = glm::i16vec2;
+	static constexpr auto format = vk::Format::eR16G16Snorm;
+	static constexpr auto component_type = ComponentType::Short;
+	static constexpr bool octahedral = true;
+
+	static void encode(const float* lanes, Storage& out);
+};
+
+struct Float2TexCoord {
+	using Storage = glm::vec2;
+	static constexpr auto format = vk::Format::eR32G32Sfloat;
+	static constexpr auto component_type = ComponentType::Float;
+
+	static void encode(const float* lanes, Storage& out);
+};
+
+struct Half2TexCoord {
+	using Storage = glm::u16vec2;
+	static constexpr auto format = vk::Format::eR16G16Sfloat;
+	static constexpr auto component_type = ComponentType::UnsignedShort;
+
+	static void encode(const float* lanes, Storage& out);
+};
+
+struct Float4Color {
+	using Storage = glm::vec4;
+	static constexpr auto format = vk::Format::eR32G32B32A32Sfloat;
+	static constexpr auto component_type = ComponentType::Float;
 
-	static vk::VertexInputBindingDescription                binding(uint32_t binding = {});
-	static std::vector<vk::VertexInputAttributeDescription> attributes(uint32_t binding = {});
+	static void encode(const float* lanes, Storage& out);
 };
 
+struct Unorm8Color {
+	using Storage = glm::u8vec4;
+	static constexpr auto format = vk::Format::eR8G8B8A8Unorm;
+	static constexpr auto component_type = ComponentType::UnsignedByte;
+
+	static void encode(const float* lanes, Storage& out);
+};
+
+// Interleaved vertex built from one encoding per stream, shader locations follow the member order
+template <typename Position, typename Normal, typename TexCoord, typename Color>
+struct VertexLayout {
+	typename Position::Storage pos;
+	typename Normal::Storage   normal;
+	typename TexCoord::Storage uv;
+	typename Color::Storage    color;
+
+	static constexpr bool quantized = Position::quantized;
+	static constexpr bool octahedral = Normal::octahedral;
+
+	static vk::VertexInputBindingDescription binding(uint32_t binding = {})
+	{
+		return {
+		    binding,
+		    sizeof(VertexLayout),
+		    vk::VertexInputRate::eVertex,
+		};
+	}
+
+	static std::vector<vk::VertexInputAttributeDescription> attributes(uint32_t binding = {})
+	{
+		return {
+		    {0, binding, Position::format, offsetof(VertexLayout, pos)},
+		    {1, binding, Normal::format, offsetof(VertexLayout, normal)},
+		    {2, binding, TexCoord::format, offsetof(VertexLayout, uv)},
+		    {3, binding, Color::format, offsetof(VertexLayout, color)},
+		};
+	}
+
+	static auto quantization(const SubMesh& submesh) -> VertexQuantization;
+	static void pack(const SubMesh& submesh, std::span<VertexLayout> vertices, const VertexQuantization& quantization = {});
+	static auto packed(const SubMesh& submesh) -> std::span<const VertexLayout>;
+};
+
+// Float layout used on the CPU side and in cooked scenes
+using FullVertex = VertexLayout<Float3Position, Float3Normal, Float2TexCoord, Float4Color>;
+// 20 bytes: positions relative to the submesh bounds, octahedral normals, half UVs, RGBA8 colors
+using CompactVertex = VertexLayout<Unorm16Position, Oct16Normal, Half2TexCoord, Unorm8Color>;
+
+extern template struct VertexLayout<Float3Position, Float3Normal, Float2TexCoord, Float4Color>;
+extern template struct VertexLayout<Unorm16Position, Oct16Normal, Half2TexCoord, Unorm8Color>;
+
+#ifdef VORTEX_FULL_VERTICES
+using GpuVertex = FullVertex;
+#else
+using GpuVertex = CompactVertex;
+#endif
+
 struct GpuObjectData {
 	glm::mat4 model{1.0f};
+	glm::vec4 position_offset{0.0f}; // w: 1 when normals are octahedral encoded
+	glm::vec4 position_scale{1.0f};
 
 	static vk::DescriptorSetLayoutBinding binding(uint32_t binding = 0);
 };
@@ -11,11 +11,7 @@ GpuMaterial::GpuMaterial(Context& context,
     base_color_texture(base_color),
     metallic_roughness_texture(metallic_roughness)
 {
-	if (auto* pbr = dynamic_cast<const PBRMaterial*>(material.get())) {
-		material_data.base_color = pbr->getBaseColorFactor();
-		material_data.metallic = pbr->getMetallicFactor();
-		material_data.roughness = pbr->getRoughnessFactor();
-	}
+	readFactors();
 
 	material_uniform = Buffer::createDynamic(
 	    context,
@@ -24,8 +20,12 @@ GpuMaterial::GpuMaterial(Context& context,
 	    sizeof(GpuMaterialData));
 
 	material_descriptor = pool.allocate(layout);
+	writeDescriptor();
+}
 
-	auto& device = context.getDevice();
+void GpuMaterial::writeDescriptor()
+{
+	auto& device = context->getDevice();
 	material_descriptor.update(device, 0, vk::DescriptorType::eUniformBuffer, material_uniform.get());
 
 	if (base_color_texture)
@@ -35,6 +35,21 @@ GpuMaterial::GpuMaterial(Context& context,
 		material_descriptor.update(device, 2, vk::DescriptorType::eCombinedImageSampler, metallic_roughness_texture);
 }
 
+void GpuMaterial::readFactors()
+{
+	if (auto* pbr = dynamic_cast<const PBRMaterial*>(source_material.get())) {
+		material_data.base_color = pbr->getBaseColorFactor();
+		material_data.metallic = pbr->getMetallicFactor();
+		material_data.roughness = pbr->getRoughnessFactor();
+	}
+}
+
+void GpuMaterial::refresh()
+{
+	readFactors();
+	updateUniforms();
+}
+
 void GpuMaterial::updateUniforms()
 {
 	material_uniform->upload(&material_data, sizeof(GpuMaterialData));
@@ -50,6 +65,19 @@ void GpuMaterial::bind(vk::CommandBuffer command_buffer, vk::PipelineLayout pipe
 	    {});
 }
 
+DescriptorSet GpuMaterial::setTextures(DescriptorSetLayout& layout, DescriptorPool& pool, Image* base_color, Image* metallic_roughness)
+{
+	auto previous = material_descriptor;
+
+	base_color_texture = base_color;
+	metallic_roughness_texture = metallic_roughness;
+
+	material_descriptor = pool.allocate(layout);
+	writeDescriptor();
+
+	return previous;
+}
+
 DescriptorSet GpuMaterial::getDescriptor()
 {
 	return material_descriptor.get();
@@ -23,6 +23,9 @@ private:
 
 	Context* context{};
 
+	void readFactors();
+	void writeDescriptor();
+
 public:
 	GpuMaterial(Context&          context,
 	    std::shared_ptr<Material> material,
@@ -39,7 +42,11 @@ public:
 	GpuMaterial& operator=(GpuMaterial&&) noexcept = default;
 
 	void updateUniforms();
+	// Copies the factors of the source material again and uploads them
+	void refresh();
 	void bind(vk::CommandBuffer command_buffer, vk::PipelineLayout pipeline_layout);
+	// Points the material at new images through a fresh set and returns the old one, frames in flight may still bind it
+	auto setTextures(DescriptorSetLayout& layout, DescriptorPool& pool, Image* base_color, Image* metallic_roughness) -> DescriptorSet;
 
 	DescriptorSet             getDescriptor();
 	std::shared_ptr<Material> getSourceMaterial() const;
@@ -1,6 +1,8 @@
 #include "GpuMesh.hpp"
 
-#include <numeric>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include "Render/Graphics/Context.hpp"
 #include "Scene/Resources/SubMesh.hpp"
@@ -8,59 +10,76 @@
 GpuMesh::GpuMesh(Context& context,
     const SubMesh&        submesh,
     DescriptorSetLayout&  layout,
-    DescriptorPool&       pool) :
+    DescriptorPool&       pool,
+    const GpuMesh*        shared_geometry) :
     context(&context), submesh(&submesh)
 {
-	const auto& vertices = submesh.getVertices();
-	const auto& indices = submesh.getIndices();
-	const auto& attributes = submesh.getAttributes();
-
 	vertex_count = submesh.getVerticesCount();
 	index_count = submesh.getIndicesCount();
 
-	if (!vertices.empty() && vertex_count > 0) {
-		auto source_stride = std::accumulate(attributes.begin(), attributes.end(), 0u,
-		    [](uint32_t sum, const auto& pair) {
-			    return sum + pair.second.size;
-		    });
-
-		const auto* pos_attribute = submesh.getAttribute("POSITION");
-		const auto* normal_attribute = submesh.getAttribute("NORMAL");
-		const auto* uv_attribute = submesh.getAttribute("TEXCOORD_0");
-		const auto* color_attribute = submesh.getAttribute("COLOR_0");
-
-		std::vector<GpuVertex> gpu_vertices(vertex_count);
-		const uint8_t*         src_data = reinterpret_cast<const uint8_t*>(vertices.data());
-
-		for (uint32_t i = 0; i < vertex_count; i++) {
-			const uint8_t* vertex_data = src_data + i * source_stride;
-
-			if (pos_attribute)
-				std::memcpy(&gpu_vertices[i].pos, vertex_data + pos_attribute->offset, sizeof(glm::vec3));
-
-			if (normal_attribute)
-				std::memcpy(&gpu_vertices[i].normal, vertex_data + normal_attribute->offset, sizeof(glm::vec3));
-
-			if (uv_attribute)
-				std::memcpy(&gpu_vertices[i].uv, vertex_data + uv_attribute->offset, sizeof(glm::vec2));
-
-			if (color_attribute)
-				std::memcpy(&gpu_vertices[i].color, vertex_data + color_attribute->offset, sizeof(glm::vec4));
-		}
-
+	if (shared_geometry) {
+		vertex_buffer = shared_geometry->vertex_buffer;
+		index_buffer = shared_geometry->index_buffer;
+		index_type = shared_geometry->index_type;
+		object_data.position_offset = shared_geometry->object_data.position_offset;
+		object_data.position_scale = shared_geometry->object_data.position_scale;
+	} else if (vertex_count > 0) {
+		auto quantization = GpuVertex::quantization(submesh);
+		object_data.position_offset = glm::vec4(quantization.offset, GpuVertex::octahedral ? 1.0f : 0.0f);
+		object_data.position_scale = glm::vec4(quantization.scale, 1.0f);
+
+		auto packed = GpuVertex::packed(submesh);
 		vertex_buffer = Buffer::createStatic(
 		    *this->context,
 		    vk::BufferUsageFlagBits::eVertexBuffer,
-		    gpu_vertices.data(),
-		    gpu_vertices.size() * sizeof(GpuVertex));
+		    vertex_count * sizeof(GpuVertex),
+		    [&submesh, &quantization, packed, count = vertex_count](void* data) {
+			    std::span<GpuVertex> vertices(static_cast<GpuVertex*>(data), count);
+			    if (packed.empty())
+				    GpuVertex::pack(submesh, vertices, quantization);
+			    else
+				    std::copy(packed.begin(), packed.end(), vertices.begin());
+		    });
 	}
 
-	if (!indices.empty()) {
-		index_buffer = Buffer::createStatic(
-		    *this->context,
-		    vk::BufferUsageFlagBits::eIndexBuffer,
-		    indices.data(),
-		    indices.size() * sizeof(uint32_t));
+	lods.push_back({.index_offset = 0, .index_count = index_count, .error = 0.0f});
+	for (const auto& level : submesh.getLods())
+		lods.push_back({.index_offset = index_count + level.index_offset, .index_count = level.index_count, .error = level.error});
+
+	meshlets = submesh.getMeshlets();
+	draw_ranges.push_back({.index_offset = 0, .index_count = index_count});
+	if (auto material = submesh.getMaterial())
+		cone_culling = !material->getDoubleSided();
+
+	// 16-bit indices whenever every vertex is addressable, 0xFFFF stays free as the restart value
+	if (index_count > 0 && !shared_geometry) {
+		auto lod_indices = submesh.getLodIndices();
+		auto total_count = index_count + static_cast<uint32_t>(lod_indices.size());
+
+		if (vertex_count <= std::numeric_limits<uint16_t>::max()) {
+			index_type = vk::IndexType::eUint16;
+			index_buffer = Buffer::createStatic(
+			    *this->context,
+			    vk::BufferUsageFlagBits::eIndexBuffer,
+			    total_count * sizeof(uint16_t),
+			    [&submesh, lod_indices, count = index_count, total_count](void* data) {
+				    std::span<uint16_t> indices(static_cast<uint16_t*>(data), total_count);
+				    submesh.copyIndices(indices.first(count));
+				    std::transform(lod_indices.begin(), lod_indices.end(), indices.begin() + count,
+				        [](uint32_t index) { return static_cast<uint16_t>(index); });
+			    });
+		} else {
+			index_type = vk::IndexType::eUint32;
+			index_buffer = Buffer::createStatic(
+			    *this->context,
+			    vk::BufferUsageFlagBits::eIndexBuffer,
+			    total_count * sizeof(uint32_t),
+			    [&submesh, lod_indices, count = index_count, total_count](void* data) {
+				    std::span<uint32_t> indices(static_cast<uint32_t*>(data), total_count);
+				    submesh.copyIndices(indices.first(count));
+				    std::copy(lod_indices.begin(), lod_indices.end(), indices.begin() + count);
+			    });
+		}
 	}
 
 	object_uniform = Buffer::createDynamic(
@@ -75,13 +94,14 @@ GpuMesh::GpuMesh(Context& context,
 
 void GpuMesh::draw(vk::CommandBuffer command_buffer)
 {
-	command_buffer.drawIndexed(index_count, 1, 0, 0, 0);
+	for (const auto& range : draw_ranges)
+		command_buffer.drawIndexed(range.index_count, 1, range.index_offset, 0, 0);
 }
 
 void GpuMesh::bind(vk::CommandBuffer command_buffer, vk::PipelineLayout pipeline_layout)
 {
 	command_buffer.bindVertexBuffers(0, vertex_buffer->get(), {0});
-	command_buffer.bindIndexBuffer(index_buffer->get(), 0, vk::IndexType::eUint32);
+	command_buffer.bindIndexBuffer(index_buffer->get(), 0, index_type);
 	command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline_layout,
 	    2, object_descriptor.get(), {});
 }
@@ -96,6 +116,70 @@ void GpuMesh::updateUniforms()
 	object_uniform->upload(&object_data, sizeof(GpuObjectData));
 }
 
+// Picks the coarsest level whose object space error projects below max_pixel_error, with hysteresis so
+// a mesh sitting on a threshold does not flip between levels every frame
+void GpuMesh::selectLod(const glm::vec3& camera_position, float pixels_per_unit, float max_pixel_error)
+{
+	constexpr float HYSTERESIS = 0.25f;
+
+	if (lods.size() < 2 || !submesh->hasBounds())
+		return;
+
+	const auto& model = object_data.model;
+	float       scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))});
+	glm::vec3   center = glm::vec3(model * glm::vec4((submesh->getBoundsMin() + submesh->getBoundsMax()) * 0.5f, 1.0f));
+	float       radius = glm::length(submesh->getBoundsMax() - submesh->getBoundsMin()) * 0.5f * scale;
+	float       distance = std::max(glm::length(center - camera_position) - radius, 1e-3f);
+
+	auto projected = [&](uint32_t level) { return lods[level].error * scale / distance * pixels_per_unit; };
+
+	uint32_t next = lod;
+	while (next > 0 && projected(next) > max_pixel_error * (1.0f + HYSTERESIS))
+		next--;
+	while (next + 1 < lods.size() && projected(next + 1) <= max_pixel_error * (1.0f - HYSTERESIS))
+		next++;
+
+	lod = next;
+}
+
+// Rejects meshlets outside the frustum or facing away from the camera, only the full detail level carries meshlets
+void GpuMesh::cullMeshlets(const Frustum& frustum, const glm::vec3& camera_position, bool backface_culling)
+{
+	draw_ranges.clear();
+	if (lod != 0 || meshlets.empty()) {
+		draw_ranges.push_back({.index_offset = lods[lod].index_offset, .index_count = lods[lod].index_count});
+		return;
+	}
+
+	const auto& model = object_data.model;
+	glm::mat3   linear(model);
+	glm::vec3   scales(glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2]));
+	float       max_scale = std::max({scales.x, scales.y, scales.z});
+	float       min_scale = std::min({scales.x, scales.y, scales.z});
+
+	// Cones only survive rotation and uniform scale, a mirroring transform also flips the winding they were built from
+	bool cones = backface_culling && cone_culling && max_scale <= min_scale * 1.001f && glm::determinant(linear) > 0.0f;
+
+	for (const auto& meshlet : meshlets) {
+		auto center = glm::vec3(model * glm::vec4(meshlet.center, 1.0f));
+		if (!frustum.intersectsSphere(center, meshlet.radius * max_scale))
+			continue;
+
+		if (cones && meshlet.cone_cutoff < 1.0f) {
+			auto apex = glm::vec3(model * glm::vec4(meshlet.cone_apex, 1.0f));
+			auto axis = linear * meshlet.cone_axis / max_scale;
+			auto view = apex - camera_position;
+			if (glm::dot(view, axis) >= meshlet.cone_cutoff * glm::length(view))
+				continue;
+		}
+
+		if (!draw_ranges.empty() && draw_ranges.back().index_offset + draw_ranges.back().index_count == meshlet.index_offset)
+			draw_ranges.back().index_count += meshlet.index_count;
+		else
+			draw_ranges.push_back({.index_offset = meshlet.index_offset, .index_count = meshlet.index_count});
+	}
+}
+
 DescriptorSet GpuMesh::getDescriptor() const
 {
 	return object_descriptor;
@@ -106,6 +190,16 @@ const SubMesh* GpuMesh::getSubMesh() const
 	return submesh;
 }
 
+uint32_t GpuMesh::getDrawIndex() const
+{
+	return draw_index;
+}
+
+void GpuMesh::setDrawIndex(uint32_t index)
+{
+	draw_index = index;
+}
+
 vk::Buffer GpuMesh::getVertexBuffer() const
 {
 	return vertex_buffer->get();
@@ -121,7 +215,32 @@ uint32_t GpuMesh::getVertexCount() const
 	return vertex_count;
 }
 
+vk::IndexType GpuMesh::getIndexType() const
+{
+	return index_type;
+}
+
 uint32_t GpuMesh::getIndexCount() const
 {
 	return index_count;
 }
+
+uint32_t GpuMesh::getLod() const
+{
+	return lod;
+}
+
+uint32_t GpuMesh::getLodCount() const
+{
+	return static_cast<uint32_t>(lods.size());
+}
+
+auto GpuMesh::getMeshlets() const -> const std::vector<Meshlet>&
+{
+	return meshlets;
+}
+
+auto GpuMesh::getDrawRanges() const -> const std::vector<DrawRange>&
+{
+	return draw_ranges;
+}
@@ -3,16 +3,33 @@
 #include <vulkan/vulkan.hpp>
 
 #include "GpuData.hpp"
+#include "Frustum.hpp"
 #include "Render/Graphics/Buffer.hpp"
 #include "Render/Graphics/Descriptor.hpp"
 #include "Scene/Resources/SubMesh.hpp"
 
+struct DrawRange {
+	uint32_t index_offset = 0;
+	uint32_t index_count = 0;
+};
+
 class GpuMesh {
 private:
-	std::unique_ptr<Buffer> vertex_buffer;
-	std::unique_ptr<Buffer> index_buffer;
+	// Shared with every GpuMesh built from the same geometry streams
+	std::shared_ptr<Buffer> vertex_buffer;
+	std::shared_ptr<Buffer> index_buffer;
 	uint32_t                vertex_count{};
 	uint32_t                index_count{};
+	vk::IndexType           index_type{vk::IndexType::eUint32};
+
+	// LOD 0 is the full index range, coarser levels follow it in the same index buffer
+	std::vector<SubMeshLod> lods;
+	uint32_t                lod{};
+
+	// Meshlets of LOD 0 and the index ranges that survived the last cull, adjacent ranges merged into one draw
+	std::vector<Meshlet>   meshlets;
+	std::vector<DrawRange> draw_ranges;
+	bool                   cone_culling{true};
 
 	DescriptorSet object_descriptor;
 
@@ -20,6 +37,8 @@ private:
 	GpuObjectData           object_data;
 
 	const SubMesh* submesh{};
+	// Slot of the mesh in the per-draw arrays of the render scene
+	uint32_t draw_index{};
 
 	Context* context{};
 
@@ -27,7 +46,8 @@ public:
 	GpuMesh(Context&         context,
 	    const SubMesh&       submesh,
 	    DescriptorSetLayout& layout,
-	    DescriptorPool&      pool);
+	    DescriptorPool&      pool,
+	    const GpuMesh*       shared_geometry = nullptr);
 	~GpuMesh() = default;
 
 	GpuMesh(const GpuMesh&) = delete;
@@ -42,12 +62,24 @@ public:
 	void setModelMatrix(const glm::mat4& model);
 	void updateUniforms();
 
+	void selectLod(const glm::vec3& camera_position, float pixels_per_unit, float max_pixel_error);
+	void cullMeshlets(const Frustum& frustum, const glm::vec3& camera_position, bool backface_culling);
+
 	DescriptorSet  getDescriptor() const;
 	const SubMesh* getSubMesh() const;
 
-	vk::Buffer getVertexBuffer() const;
-	vk::Buffer getIndexBuffer() const;
+	uint32_t getDrawIndex() const;
+	void     setDrawIndex(uint32_t index);
+
+	vk::Buffer    getVertexBuffer() const;
+	vk::Buffer    getIndexBuffer() const;
+	vk::IndexType getIndexType() const;
 
 	uint32_t getVertexCount() const;
 	uint32_t getIndexCount() const;
+	uint32_t getLod() const;
+	uint32_t getLodCount() const;
+
+	auto getMeshlets() const -> const std::vector<Meshlet>&;
+	auto getDrawRanges() const -> const std::vector<DrawRange>&;
 };
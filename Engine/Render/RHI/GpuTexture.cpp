@@ -1,16 +1,46 @@
 #include "GpuTexture.hpp"
 
-GpuTexture::GpuTexture(Context& context, std::shared_ptr<Texture> texture, std::shared_ptr<Sampler> default_sampler) :
+#include <limits>
+#include <format>
+#include <utility>
+#include <algorithm>
+
+static vk::Format toImageFormat(TextureFormat format, bool srgb)
+{
+	switch (format) {
+	case TextureFormat::RGBA8:
+		return srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+	case TextureFormat::BC1:
+		return srgb ? vk::Format::eBc1RgbaSrgbBlock : vk::Format::eBc1RgbaUnormBlock;
+	case TextureFormat::BC3:
+		return srgb ? vk::Format::eBc3SrgbBlock : vk::Format::eBc3UnormBlock;
+	case TextureFormat::BC4:
+		return vk::Format::eBc4UnormBlock;
+	case TextureFormat::BC5:
+		return vk::Format::eBc5UnormBlock;
+	case TextureFormat::BC7:
+		return srgb ? vk::Format::eBc7SrgbBlock : vk::Format::eBc7UnormBlock;
+	default:
+		throw std::runtime_error("Unsupported texture format");
+	}
+}
+
+GpuTexture::GpuTexture(Context& context, std::shared_ptr<Texture> texture, std::shared_ptr<Sampler> default_sampler, uint32_t resident_size) :
     context(&context), source_texture(texture)
 {
 	if (!texture || !texture->valid())
 		throw std::runtime_error("Cannot create gpu texture from invalid texture");
+	if (Texture::isCompressed(texture->getFormat()) && !context.getDevice().getEnabledFeatures().textureCompressionBC)
+		throw std::runtime_error(std::format("Texture {} is block compressed but the device has no BC support", texture->getName()));
+
+	if (resident_size > 0)
+		while (resident_level + 1 < texture->getMipCount()
+		    && std::max(texture->getMip(resident_level).width, texture->getMip(resident_level).height) > resident_size)
+			resident_level++;
 
-	image = std::make_unique<Image>(
-	    context,
-	    texture->getData().data(),
-	    texture->getWidth(),
-	    texture->getHeight());
+	std::vector<ImageLevel> levels;
+	auto                    data = getUploadData(resident_level, levels);
+	image = std::make_unique<Image>(context, data, levels, getImageFormat());
 
 	if (default_sampler)
 		sampler = default_sampler;
@@ -20,6 +50,47 @@ GpuTexture::GpuTexture(Context& context, std::shared_ptr<Texture> texture, std::
 	image->setSampler(*sampler);
 }
 
+// Levels may be stored in any order (KTX2 keeps the smallest first), the range spans all of the requested ones
+std::span<const uint8_t> GpuTexture::getUploadData(uint32_t first_level, std::vector<ImageLevel>& levels) const
+{
+	uint64_t begin = std::numeric_limits<uint64_t>::max(), end = 0;
+	for (uint32_t level = first_level; level < source_texture->getMipCount(); level++) {
+		auto mip = source_texture->getMip(level);
+		begin = std::min(begin, mip.offset);
+		end = std::max(end, mip.offset + mip.size);
+	}
+
+	levels.clear();
+	for (uint32_t level = first_level; level < source_texture->getMipCount(); level++) {
+		auto mip = source_texture->getMip(level);
+		levels.push_back({.offset = mip.offset - begin, .width = mip.width, .height = mip.height});
+	}
+
+	return source_texture->getData().subspan(begin, end - begin);
+}
+
+vk::Format GpuTexture::getImageFormat() const
+{
+	return toImageFormat(source_texture->getFormat(), source_texture->isSrgb());
+}
+
+uint32_t GpuTexture::getResidentLevel() const
+{
+	return resident_level;
+}
+
+bool GpuTexture::isFullyResident() const
+{
+	return resident_level == 0;
+}
+
+std::unique_ptr<Image> GpuTexture::swapImage(std::unique_ptr<Image> full_image)
+{
+	full_image->setSampler(*sampler);
+	resident_level = 0;
+	return std::exchange(image, std::move(full_image));
+}
+
 Image* GpuTexture::getImage() const
 {
 	return image.get();
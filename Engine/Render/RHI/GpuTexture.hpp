@@ -1,6 +1,8 @@
 #pragma once
 
+#include <span>
 #include <memory>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "Render/Graphics/Context.hpp"
@@ -16,10 +18,14 @@ private:
 	std::shared_ptr<Texture> source_texture;
 	Context*                 context{};
 
+	// First level of the source chain held by image, levels above it are still streaming
+	uint32_t resident_level{0};
+
 	void createFromMemory(const std::vector<uint8_t>& data, uint32_t width, uint32_t height, uint32_t channels);
 
 public:
-	GpuTexture(Context& context, std::shared_ptr<Texture> texture, std::shared_ptr<Sampler> sampler = nullptr);
+	// A non zero resident size keeps only the levels up to that size, the rest is left to streaming
+	GpuTexture(Context& context, std::shared_ptr<Texture> texture, std::shared_ptr<Sampler> sampler = nullptr, uint32_t resident_size = 0);
 	~GpuTexture() = default;
 
 	GpuTexture(const GpuTexture&) = delete;
@@ -28,6 +34,15 @@ public:
 	GpuTexture(GpuTexture&&) noexcept = default;
 	GpuTexture& operator=(GpuTexture&&) noexcept = default;
 
+	// Upload ranges of the source levels from first_level down, offsets are relative to the returned data
+	auto getUploadData(uint32_t first_level, std::vector<ImageLevel>& levels) const -> std::span<const uint8_t>;
+	auto getImageFormat() const -> vk::Format;
+
+	uint32_t getResidentLevel() const;
+	bool     isFullyResident() const;
+	// Takes over an image holding the full chain and returns the previous one, frames in flight may still sample it
+	auto swapImage(std::unique_ptr<Image> full_image) -> std::unique_ptr<Image>;
+
 	Image*                   getImage() const;
 	Sampler*                 getSampler() const;
 	std::shared_ptr<Texture> getSourceTexture() const;
@@ -0,0 +1,358 @@
+#include "OcclusionCuller.hpp"
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+#include "FrustumCuller.hpp"
+#include "Core/Thread/ThreadPool.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+#include "Utils/MeshOptimizer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VORTEX_SSE2 1
+#	include <emmintrin.h>
+#endif
+
+// Draws tested per task of the thread pool
+constexpr size_t TEST_GRAIN = 256;
+
+OcclusionCuller::OcclusionCuller()
+{
+	for (uint32_t level_width = width, level_height = height;; level_width = std::max(1u, level_width / 2), level_height = std::max(1u, level_height / 2)) {
+		pyramid.push_back({level_width, level_height, std::vector<float>(level_width * level_height, 1.0f)});
+		if (level_width == 1 && level_height == 1)
+			break;
+	}
+}
+
+// The task points into this culler
+OcclusionCuller::~OcclusionCuller()
+{
+	wait();
+}
+
+void OcclusionCuller::resize(size_t draw_count)
+{
+	wait();
+
+	occluders.clear();
+	triangles.clear();
+	occluder_of_draw.assign(draw_count, -1);
+	occluded.assign(draw_count, 0);
+	tested_count = 0;
+	occluded_count = 0;
+}
+
+bool OcclusionCuller::addOccluder(uint32_t draw_index, const SubMesh& submesh)
+{
+	if (occluders.size() >= occluder_limit || draw_index >= occluder_of_draw.size())
+		return false;
+
+	auto positions = MeshOptimizer::getPositions(submesh);
+	if (positions.empty())
+		return false;
+
+	// The full mesh when it fits, else the finest level within the budget, simplification may bulge past the outline
+	std::vector<uint32_t> source;
+	float                 error = 0.0f;
+	const auto&           lods = submesh.getLods();
+	auto                  lod_indices = submesh.getLodIndices();
+	if (submesh.getIndicesCount() <= occluder_triangles * 3)
+		source = submesh.getIndices();
+	for (auto it = lods.begin(); it != lods.end() && source.empty(); ++it)
+		if (it->index_count <= occluder_triangles * 3 && it->index_offset + it->index_count <= lod_indices.size()) {
+			source.assign(lod_indices.begin() + it->index_offset, lod_indices.begin() + it->index_offset + it->index_count);
+			error = it->error;
+		}
+	if (source.empty() || source.size() % 3 != 0)
+		return false;
+
+	// Only the vertices the level references are kept
+	Occluder                               occluder{.draw_index = draw_index};
+	std::unordered_map<uint32_t, uint32_t> remap;
+	occluder.indices.reserve(source.size());
+	for (auto index : source) {
+		if (index >= positions.size())
+			return false;
+
+		auto [it, inserted] = remap.try_emplace(index, static_cast<uint32_t>(occluder.positions.size()));
+		if (inserted)
+			occluder.positions.push_back(positions[index]);
+		occluder.indices.push_back(it->second);
+	}
+
+	// A simplified level is pulled inwards by its error along the area weighted normals, so it only under-occludes
+	if (error > 0.0f) {
+		std::vector<glm::vec3> normals(occluder.positions.size(), glm::vec3(0.0f));
+		for (size_t index = 0; index < occluder.indices.size(); index += 3) {
+			auto a = occluder.indices[index], b = occluder.indices[index + 1], c = occluder.indices[index + 2];
+			auto normal = glm::cross(occluder.positions[b] - occluder.positions[a], occluder.positions[c] - occluder.positions[a]);
+			normals[a] += normal;
+			normals[b] += normal;
+			normals[c] += normal;
+		}
+		for (size_t vertex = 0; vertex < occluder.positions.size(); vertex++) {
+			float length = glm::length(normals[vertex]);
+			if (length > 0.0f)
+				occluder.positions[vertex] -= normals[vertex] * (error / length);
+		}
+	}
+
+	occluder_of_draw[draw_index] = static_cast<int32_t>(occluders.size());
+	occluders.push_back(std::move(occluder));
+	return true;
+}
+
+void OcclusionCuller::setModelMatrix(uint32_t draw_index, const glm::mat4& model)
+{
+	if (draw_index < occluder_of_draw.size() && occluder_of_draw[draw_index] >= 0)
+		occluders[occluder_of_draw[draw_index]].model = model;
+}
+
+void OcclusionCuller::begin(const glm::mat4& view_projection, const FrustumCuller& frustum_culler)
+{
+	wait();
+	pending = ThreadPool::instance().submit([this, view_projection, &frustum_culler]() { run(view_projection, frustum_culler); });
+}
+
+void OcclusionCuller::wait()
+{
+	if (pending.valid())
+		pending.get();
+}
+
+void OcclusionCuller::run(const glm::mat4& view_projection, const FrustumCuller& frustum_culler)
+{
+	auto& pool = ThreadPool::instance();
+
+	std::fill(pyramid[0].depths.begin(), pyramid[0].depths.end(), 1.0f);
+	std::fill(occluded.begin(), occluded.end(), 0);
+
+	// Hidden occluders are skipped, they cannot cover anything the camera sees
+	triangles.resize(occluders.size());
+	pool.parallelFor(occluders.size(), [&](size_t occluder) {
+		triangles[occluder].clear();
+		if (frustum_culler.isVisible(occluders[occluder].draw_index))
+			setupTriangles(occluder, view_projection);
+	});
+
+	// Bands own disjoint rows, so they write the depth buffer without synchronization
+	pool.parallelFor(height / band_height, [&](size_t band) { rasterizeBand(band); });
+	buildPyramid();
+
+	size_t count = std::min(frustum_culler.size(), occluded.size());
+	pool.parallelFor((count + TEST_GRAIN - 1) / TEST_GRAIN, [&](size_t chunk) {
+		for (size_t index = chunk * TEST_GRAIN; index < std::min(count, (chunk + 1) * TEST_GRAIN); index++)
+			if (frustum_culler.isVisible(index))
+				occluded[index] = testBounds(view_projection, frustum_culler.getCenter(index), frustum_culler.getExtent(index)) ? 1 : 0;
+	});
+
+	tested_count = frustum_culler.getVisibleCount();
+	occluded_count = static_cast<size_t>(std::count(occluded.begin(), occluded.end(), uint8_t{1}));
+}
+
+// Triangles crossing the near plane are dropped rather than clipped, leaving out an occluder is always safe
+void OcclusionCuller::setupTriangles(size_t index, const glm::mat4& view_projection)
+{
+	const auto& occluder = occluders[index];
+	auto        model_view_projection = view_projection * occluder.model;
+
+	std::vector<glm::vec3> screen(occluder.positions.size());
+	std::vector<uint8_t>   behind(occluder.positions.size());
+	for (size_t vertex = 0; vertex < screen.size(); vertex++) {
+		auto clip = model_view_projection * glm::vec4(occluder.positions[vertex], 1.0f);
+		behind[vertex] = clip.z < 0.0f || clip.w <= 0.0f;
+		if (!behind[vertex])
+			screen[vertex] = {(clip.x / clip.w * 0.5f + 0.5f) * width, (clip.y / clip.w * 0.5f + 0.5f) * height, clip.z / clip.w};
+	}
+
+	auto& result = triangles[index];
+	for (size_t first = 0; first + 2 < occluder.indices.size(); first += 3) {
+		auto i0 = occluder.indices[first], i1 = occluder.indices[first + 1], i2 = occluder.indices[first + 2];
+		if (behind[i0] || behind[i1] || behind[i2])
+			continue;
+
+		auto  v0 = screen[i0], v1 = screen[i1], v2 = screen[i2];
+		float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+		if (std::abs(area) < 1e-6f)
+			continue;
+		// Occluders are solid from either side, the winding is normalized instead of culled
+		if (area < 0.0f) {
+			std::swap(v1, v2);
+			area = -area;
+		}
+
+		Triangle triangle;
+		triangle.min_x = std::max(0, static_cast<int32_t>(std::ceil(std::min({v0.x, v1.x, v2.x}) - 0.5f)));
+		triangle.max_x = std::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::floor(std::max({v0.x, v1.x, v2.x}) - 0.5f)));
+		triangle.min_y = std::max(0, static_cast<int32_t>(std::ceil(std::min({v0.y, v1.y, v2.y}) - 0.5f)));
+		triangle.max_y = std::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::floor(std::max({v0.y, v1.y, v2.y}) - 0.5f)));
+		if (triangle.min_x > triangle.max_x || triangle.min_y > triangle.max_y)
+			continue;
+
+		const glm::vec3* vertices[3] = {&v0, &v1, &v2};
+		for (int edge = 0; edge < 3; edge++) {
+			const auto& a = *vertices[edge];
+			const auto& b = *vertices[(edge + 1) % 3];
+			triangle.edge_a[edge] = a.y - b.y;
+			triangle.edge_b[edge] = b.x - a.x;
+			triangle.edge_c[edge] = -(triangle.edge_a[edge] * a.x + triangle.edge_b[edge] * a.y);
+		}
+
+		// Depth is linear in screen space. Half a pixel of slope is added so each texel stores the farthest depth it covers
+		float depth_dx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+		float depth_dy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+		triangle.depth_a = depth_dx;
+		triangle.depth_b = depth_dy;
+		triangle.depth_c = v0.z - depth_dx * v0.x - depth_dy * v0.y + 0.5f * (std::abs(depth_dx) + std::abs(depth_dy));
+		triangle.depth_max = std::max({v0.z, v1.z, v2.z});
+
+		result.push_back(triangle);
+	}
+}
+
+// Four pixels of a row per step, the edge functions and the depth plane evaluated side by side
+void OcclusionCuller::rasterizeBand(size_t band)
+{
+	auto  band_begin = static_cast<int32_t>(band * band_height);
+	auto  band_end = band_begin + static_cast<int32_t>(band_height);
+	auto& depths = pyramid[0].depths;
+
+	for (const auto& occluder_triangles : triangles) {
+		for (const auto& triangle : occluder_triangles) {
+			int32_t row_begin = std::max(triangle.min_y, band_begin);
+			int32_t row_end = std::min(triangle.max_y + 1, band_end);
+
+			for (int32_t y = row_begin; y < row_end; y++) {
+				float  center_y = static_cast<float>(y) + 0.5f;
+				float* row = depths.data() + static_cast<size_t>(y) * width;
+				// Rows start on a multiple of four, width is one too, so every step stays inside the row
+				int32_t x = triangle.min_x & ~3;
+
+#if defined(VORTEX_SSE2)
+				__m128 edge_a[3], edge_row[3];
+				for (int edge = 0; edge < 3; edge++) {
+					edge_a[edge] = _mm_set1_ps(triangle.edge_a[edge]);
+					edge_row[edge] = _mm_set1_ps(triangle.edge_b[edge] * center_y + triangle.edge_c[edge]);
+				}
+				__m128 depth_a = _mm_set1_ps(triangle.depth_a);
+				__m128 depth_row = _mm_set1_ps(triangle.depth_b * center_y + triangle.depth_c);
+				__m128 depth_max = _mm_set1_ps(triangle.depth_max);
+				__m128 zero = _mm_setzero_ps();
+
+				for (; x <= triangle.max_x; x += 4) {
+					__m128 center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(x) + 0.5f), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+					__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a[0], center_x), edge_row[0]), zero);
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a[1], center_x), edge_row[1]), zero));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a[2], center_x), edge_row[2]), zero));
+					if (_mm_movemask_ps(inside) == 0)
+						continue;
+
+					__m128 depth = _mm_min_ps(_mm_add_ps(_mm_mul_ps(depth_a, center_x), depth_row), depth_max);
+					__m128 previous = _mm_loadu_ps(row + x);
+					__m128 closer = _mm_min_ps(previous, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closer), _mm_andnot_ps(inside, previous)));
+				}
+#else
+				for (; x <= triangle.max_x; x++) {
+					float center_x = static_cast<float>(x) + 0.5f;
+					bool  inside = true;
+					for (int edge = 0; edge < 3 && inside; edge++)
+						inside = triangle.edge_a[edge] * center_x + triangle.edge_b[edge] * center_y + triangle.edge_c[edge] >= 0.0f;
+					if (!inside)
+						continue;
+
+					float depth = std::min(triangle.depth_a * center_x + triangle.depth_b * center_y + triangle.depth_c, triangle.depth_max);
+					row[x] = std::min(row[x], depth);
+				}
+#endif
+			}
+		}
+	}
+}
+
+void OcclusionCuller::buildPyramid()
+{
+	for (size_t level = 1; level < pyramid.size(); level++) {
+		const auto& source = pyramid[level - 1];
+		auto&       target = pyramid[level];
+
+		for (uint32_t y = 0; y < target.height; y++) {
+			uint32_t y0 = std::min(y * 2, source.height - 1);
+			uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+			for (uint32_t x = 0; x < target.width; x++) {
+				uint32_t x0 = std::min(x * 2, source.width - 1);
+				uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+				target.depths[y * target.width + x] = std::max(
+				    std::max(source.depths[y0 * source.width + x0], source.depths[y0 * source.width + x1]),
+				    std::max(source.depths[y1 * source.width + x0], source.depths[y1 * source.width + x1]));
+			}
+		}
+	}
+}
+
+// True when the box lies behind the occluders. The rectangle grows by a texel, which covers texels only partly
+// inside an occluder, and the level is chosen so it spans at most two texels per axis
+bool OcclusionCuller::testBounds(const glm::mat4& view_projection, const glm::vec3& center, const glm::vec3& extent) const
+{
+	glm::vec2 screen_min(std::numeric_limits<float>::max());
+	glm::vec2 screen_max(std::numeric_limits<float>::lowest());
+	float     nearest = std::numeric_limits<float>::max();
+
+	for (int corner = 0; corner < 8; corner++) {
+		glm::vec3 sign((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+		auto      clip = view_projection * glm::vec4(center + sign * extent, 1.0f);
+		// Crossing the near plane, the camera may be inside
+		if (!(clip.z >= 0.0f && clip.w > 0.0f))
+			return false;
+
+		glm::vec2 screen((clip.x / clip.w * 0.5f + 0.5f) * width, (clip.y / clip.w * 0.5f + 0.5f) * height);
+		screen_min = glm::min(screen_min, screen);
+		screen_max = glm::max(screen_max, screen);
+		nearest = std::min(nearest, clip.z / clip.w);
+	}
+
+	auto clamp_x = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(width - 1))); };
+	auto clamp_y = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, static_cast<float>(height - 1))); };
+	uint32_t min_x = clamp_x(std::floor(screen_min.x) - 1.0f), max_x = clamp_x(std::floor(screen_max.x) + 1.0f);
+	uint32_t min_y = clamp_y(std::floor(screen_min.y) - 1.0f), max_y = clamp_y(std::floor(screen_max.y) + 1.0f);
+
+	size_t level = 0;
+	while (level + 1 < pyramid.size() && ((max_x >> level) - (min_x >> level) > 1 || (max_y >> level) - (min_y >> level) > 1))
+		level++;
+
+	const auto& texels = pyramid[level];
+	float       farthest = 0.0f;
+	for (uint32_t y = min_y >> level; y <= std::min(max_y >> level, texels.height - 1); y++)
+		for (uint32_t x = min_x >> level; x <= std::min(max_x >> level, texels.width - 1); x++)
+			farthest = std::max(farthest, texels.depths[y * texels.width + x]);
+
+	return nearest > farthest;
+}
+
+bool OcclusionCuller::isOccluded(size_t index) const
+{
+	return index < occluded.size() && occluded[index] != 0;
+}
+
+size_t OcclusionCuller::getOccluderCount() const
+{
+	return occluders.size();
+}
+
+size_t OcclusionCuller::getTestedCount() const
+{
+	return tested_count;
+}
+
+size_t OcclusionCuller::getOccludedCount() const
+{
+	return occluded_count;
+}
+
+float OcclusionCuller::getOccludedRatio() const
+{
+	return tested_count > 0 ? static_cast<float>(occluded_count) / static_cast<float>(tested_count) : 0.0f;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <future>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+class SubMesh;
+class FrustumCuller;
+
+// Software occlusion culling. A few large opaque meshes are rasterized at low resolution into a depth buffer, a max
+// depth pyramid is built over it, and every draw the frustum kept is rejected when the nearest depth of its bounds
+// lies behind the farthest occluder depth over the texels it covers. Runs on the thread pool between begin and wait
+class OcclusionCuller {
+private:
+	struct Occluder {
+		uint32_t               draw_index{};
+		glm::mat4              model{1.0f};
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t>  indices;
+	};
+
+	// Edge functions and depth plane over pixel centers, coverage is every edge non-negative
+	struct Triangle {
+		float   edge_a[3];
+		float   edge_b[3];
+		float   edge_c[3];
+		float   depth_a, depth_b, depth_c;
+		float   depth_max;
+		int32_t min_x, max_x, min_y, max_y;
+	};
+
+	struct Level {
+		uint32_t           width{};
+		uint32_t           height{};
+		std::vector<float> depths;
+	};
+
+	std::vector<Occluder>              occluders;
+	std::vector<int32_t>               occluder_of_draw;
+	std::vector<std::vector<Triangle>> triangles;
+	// Level 0 is the depth buffer, each next level keeps the maximum of 2x2 texels
+	std::vector<Level>   pyramid;
+	std::vector<uint8_t> occluded;
+	size_t               tested_count{0};
+	size_t               occluded_count{0};
+
+	std::future<void> pending;
+
+	void run(const glm::mat4& view_projection, const FrustumCuller& frustum_culler);
+	void setupTriangles(size_t occluder, const glm::mat4& view_projection);
+	void rasterizeBand(size_t band);
+	void buildPyramid();
+	bool testBounds(const glm::mat4& view_projection, const glm::vec3& center, const glm::vec3& extent) const;
+
+public:
+	OcclusionCuller();
+	~OcclusionCuller();
+
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	OcclusionCuller(OcclusionCuller&&) noexcept = delete;
+	OcclusionCuller& operator=(OcclusionCuller&&) noexcept = delete;
+
+	// Drops the occluders and sizes the results for a new set of draws
+	void resize(size_t draw_count);
+	// Copies the finest level of the submesh within the triangle budget, false when it cannot occlude
+	bool addOccluder(uint32_t draw_index, const SubMesh& submesh);
+	void setModelMatrix(uint32_t draw_index, const glm::mat4& model);
+
+	// Starts culling the draws the frustum culler kept, both must stay untouched until wait returns
+	void begin(const glm::mat4& view_projection, const FrustumCuller& frustum_culler);
+	void wait();
+
+	bool   isOccluded(size_t index) const;
+	size_t getOccluderCount() const;
+	size_t getTestedCount() const;
+	size_t getOccludedCount() const;
+	// Share of the draws inside the frustum that were occluded
+	float getOccludedRatio() const;
+
+	static constexpr uint32_t width = 256;
+	static constexpr uint32_t height = 128;
+	static constexpr uint32_t band_height = 16;
+	static constexpr size_t   occluder_limit = 64;
+	static constexpr size_t   occluder_triangles = 2048;
+};
@@ -1,9 +1,16 @@
 #include "RenderScene.hpp"
 
+#include <cmath>
+#include <functional>
+#include <algorithm>
+#include <unordered_set>
+
 #include "Render/Graphics/Device.hpp"
+#include "Render/Graphics/SwapChain.hpp"
 #include "Render/RHI/GpuMesh.hpp"
 #include "Render/RHI/GpuData.hpp"
 #include "Render/RHI/GpuTexture.hpp"
+#include "Scene/Core/AabbTree.hpp"
 #include "Scene/Components/Mesh.hpp"
 #include "Scene/Components/Light.hpp"
 #include "Scene/Resources/SubMesh.hpp"
@@ -13,14 +20,23 @@ constexpr uint32_t MAX_SCENE_SETS = 1;
 constexpr uint32_t MAX_MATERIAL_SETS = 10;
 constexpr uint32_t MAX_OBJECT_SETS = 100;
 
-RenderScene::RenderScene(Context& context, const World& world) :
-    context(&context), world(&world)
+// A material is rebound once per streamed texture slot, so up to three of its sets can be alive at once
+constexpr uint32_t SETS_PER_MATERIAL = 3;
+// Updates a replaced image or set is kept for, covers every frame in flight
+constexpr uint64_t RETIRE_FRAMES = 3;
+
+// Largest simplification error, in pixels, a LOD may show on screen
+constexpr float LOD_PIXEL_ERROR = 1.0f;
+
+RenderScene::RenderScene(Context& context, const World& world, ResidencySettings residency) :
+    context(&context), world(&world), residency(residency)
 {
 	createDescriptorLayouts();
 	createDescriptorPools();
 	createSceneDescriptor();
 
-	rebuild();
+	// Nothing of a new scene is in flight, so it builds without waiting for the device
+	build();
 }
 
 void RenderScene::createDescriptorLayouts()
@@ -41,9 +57,13 @@ void RenderScene::createDescriptorPools()
 	scene_pool = std::make_unique<DescriptorPool>(*context, MAX_SCENE_SETS, scene_pool_sizes);
 
 	std::vector<vk::DescriptorPoolSize> material_pool_sizes = {
-	    {vk::DescriptorType::eUniformBuffer, MAX_MATERIAL_SETS},
-	    {vk::DescriptorType::eCombinedImageSampler, MAX_MATERIAL_SETS * 5}};
-	material_pool = std::make_unique<DescriptorPool>(*context, MAX_MATERIAL_SETS, material_pool_sizes);
+	    {vk::DescriptorType::eUniformBuffer, MAX_MATERIAL_SETS * SETS_PER_MATERIAL},
+	    {vk::DescriptorType::eCombinedImageSampler, MAX_MATERIAL_SETS * SETS_PER_MATERIAL * 5}};
+	material_pool = std::make_unique<DescriptorPool>(
+	    *context,
+	    MAX_MATERIAL_SETS * SETS_PER_MATERIAL,
+	    material_pool_sizes,
+	    vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
 
 	std::vector<vk::DescriptorPoolSize> object_pool_sizes = {{vk::DescriptorType::eUniformBuffer, MAX_OBJECT_SETS}};
 	object_pool = std::make_unique<DescriptorPool>(*context, MAX_OBJECT_SETS, object_pool_sizes);
@@ -70,17 +90,25 @@ void RenderScene::loadTextures()
 	if (!world || !world->getActiveScene())
 		return;
 
-	auto textures = world->getActiveScene()->getResources<Texture>();
+	auto textures = world->getActiveScene()->getResources<Texture>().share();
 
 	gpu_textures.clear();
 	texture_to_gpu_texture.clear();
 
 	default_sampler = std::make_shared<Sampler>(*context);
+	if (!texture_streamer)
+		texture_streamer = std::make_unique<TextureStreamer>(*context);
+
+	// Only the small tail of each chain is uploaded here, full resolution streams in over the next frames
 	for (auto texture : textures) {
-		if (!texture || !texture->valid())
+		if (!texture || !texture->reload() || !texture->valid())
 			continue;
 
-		auto gpu_texture = std::make_unique<GpuTexture>(*context, texture, default_sampler);
+		auto gpu_texture = std::make_unique<GpuTexture>(*context, texture, default_sampler, TextureStreamer::resident_size);
+		if (gpu_texture->isFullyResident())
+			releaseSource(*texture, residency.textures);
+		else
+			texture_streamer->enqueue(*gpu_texture);
 		texture_to_gpu_texture[texture] = gpu_texture.get();
 		gpu_textures.push_back(std::move(gpu_texture));
 	}
@@ -91,7 +119,7 @@ void RenderScene::loadMaterials()
 	if (!world || !world->getActiveScene())
 		return;
 
-	auto materials = world->getActiveScene()->getResources<Material>();
+	auto materials = world->getActiveScene()->getResources<Material>().share();
 
 	gpu_materials.clear();
 	gpu_materials.reserve(materials.size());
@@ -100,29 +128,18 @@ void RenderScene::loadMaterials()
 		if (!material)
 			continue;
 
-		Image* base_color_texture = nullptr;
-		Image* metallic_roughness_texture = nullptr;
-
-		if (auto base_color_tex = material->getTexture("baseColor"); base_color_tex)
-			if (auto base_color_it = texture_to_gpu_texture.find(base_color_tex); base_color_it != texture_to_gpu_texture.end())
-				base_color_texture = base_color_it->second->getImage();
-
-		if (auto metallic_roughness_tex = material->getTexture("metallicRoughness"); metallic_roughness_tex)
-			if (auto metallic_roughness_it = texture_to_gpu_texture.find(metallic_roughness_tex); metallic_roughness_it != texture_to_gpu_texture.end())
-				metallic_roughness_texture = metallic_roughness_it->second->getImage();
-
 		auto gpu_material = std::make_unique<GpuMaterial>(
 		    *context,
 		    material,
 		    *material_layout,
 		    *material_pool,
-		    base_color_texture,
-		    metallic_roughness_texture);
+		    findImage(material->getTexture("baseColor")),
+		    findImage(material->getTexture("metallicRoughness")));
 
 		gpu_materials.push_back(std::move(gpu_material));
 	}
 
-	last_material_count = materials.size();
+	material_generation = world->getActiveScene()->getGeneration<Material>();
 }
 
 void RenderScene::loadMeshes()
@@ -130,26 +147,42 @@ void RenderScene::loadMeshes()
 	if (!world || !world->getActiveScene())
 		return;
 
-	auto submeshes = world->getActiveScene()->getResources<SubMesh>();
+	auto submeshes = world->getActiveScene()->getResources<SubMesh>().share();
 
 	gpu_meshes.clear();
 	submesh_to_gpu_mesh.clear();
 	gpu_meshes.reserve(submeshes.size());
 
+	// Submeshes sharing their streams (deduplicated at import) upload the vertex and index buffers once
+	std::unordered_map<GeometryKey, const GpuMesh*, GeometryKeyHash> geometry_to_gpu_mesh;
 	for (auto submesh : submeshes) {
-		if (submesh && submesh->isVisible()) {
+		if (submesh && submesh->isVisible() && submesh->reload()) {
+			auto [it, inserted] = geometry_to_gpu_mesh.try_emplace(submesh->getGeometryKey(), nullptr);
 			auto gpu_mesh = std::make_unique<GpuMesh>(
 			    *context,
 			    *submesh,
 			    *object_layout,
-			    *object_pool);
+			    *object_pool,
+			    it->second);
 
+			if (inserted)
+				it->second = gpu_mesh.get();
+			gpu_mesh->setDrawIndex(static_cast<uint32_t>(gpu_meshes.size()));
 			submesh_to_gpu_mesh[submesh] = gpu_mesh.get();
 			gpu_meshes.push_back(std::move(gpu_mesh));
 		}
 	}
 
-	last_submesh_count = submeshes.size();
+	frustum_culler.resize(gpu_meshes.size());
+	occlusion_culler->resize(gpu_meshes.size());
+	// Occluder geometry is copied before the sources are released
+	selectOccluders();
+
+	// Released only once every submesh is built, shared streams are read by the first one using them
+	for (const auto& [submesh, gpu_mesh] : submesh_to_gpu_mesh)
+		releaseSource(*submesh, residency.meshes);
+
+	submesh_generation = world->getActiveScene()->getGeneration<SubMesh>();
 }
 
 void RenderScene::organizeMeshesByMaterial()
@@ -171,22 +204,49 @@ void RenderScene::organizeMeshesByMaterial()
 	}
 }
 
+// Largest opaque meshes first, the surface of their object space bounds stands in for how much they can hide
+void RenderScene::selectOccluders()
+{
+	std::vector<std::pair<float, GpuMesh*>> candidates;
+	for (auto& gpu_mesh : gpu_meshes) {
+		const auto* submesh = gpu_mesh->getSubMesh();
+		auto        material = submesh->getMaterial();
+		if (!submesh->hasBounds() || (material && material->getAlphaMode() != AlphaMode::Opaque))
+			continue;
+
+		auto size = submesh->getBoundsMax() - submesh->getBoundsMin();
+		candidates.emplace_back(size.x * size.y + size.y * size.z + size.z * size.x, gpu_mesh.get());
+	}
+
+	std::ranges::sort(candidates, std::greater{}, &std::pair<float, GpuMesh*>::first);
+	for (const auto& [area, gpu_mesh] : candidates) {
+		if (occlusion_culler->getOccluderCount() >= OcclusionCuller::occluder_limit)
+			break;
+		occlusion_culler->addOccluder(gpu_mesh->getDrawIndex(), *gpu_mesh->getSubMesh());
+	}
+}
+
 bool RenderScene::needsRebuild() const
 {
 	if (!world || !world->getActiveScene())
 		return false;
 
-	auto submeshes = world->getActiveScene()->getResources<SubMesh>();
-	auto materials = world->getActiveScene()->getResources<Material>();
-
-	return submeshes.size() != last_submesh_count || materials.size() != last_material_count;
+	auto* scene = world->getActiveScene();
+	return scene->getGeneration<SubMesh>() != submesh_generation || scene->getGeneration<Material>() != material_generation;
 }
 
 void RenderScene::clear()
 {
+	if (texture_streamer)
+		texture_streamer->clear();
+	retired_bindings.clear();
+
 	meshes_by_material.clear();
 	submesh_to_gpu_mesh.clear();
 	gpu_meshes.clear();
+	// Waits for a pending pass before the frustum culler it reads is resized
+	occlusion_culler->resize(0);
+	frustum_culler.resize(0);
 	gpu_materials.clear();
 	gpu_textures.clear();
 	texture_to_gpu_texture.clear();
@@ -199,21 +259,36 @@ void RenderScene::clear()
 
 void RenderScene::updateCamera()
 {
-	if (!world)
+	if (!world || !world->getActiveScene())
 		return;
 
-	auto* camera = world->getActiveCamera();
-	if (camera) {
-		scene_data.view = camera->getView();
-		scene_data.projection = camera->getProjection();
-
-		glm::mat4 inv_view = glm::inverse(scene_data.view);
-		scene_data.camera_position = glm::vec4(inv_view[3][0], inv_view[3][1], inv_view[3][2], 1.0f);
+	bool changed = full_upload;
+	if (auto* camera = world->getActiveCamera()) {
+		auto view = camera->getView();
+		auto projection = camera->getProjection();
+		if (view != scene_data.view || projection != scene_data.projection) {
+			scene_data.view = view;
+			scene_data.projection = projection;
+
+			glm::mat4 inv_view = glm::inverse(scene_data.view);
+			scene_data.camera_position = glm::vec4(inv_view[3][0], inv_view[3][1], inv_view[3][2], 1.0f);
+			changed = true;
+		}
 	}
 
-	updateLights();
+	// Lights follow their nodes, the few of them are rebuilt once a light or the world matrix of a light node changed
+	auto&       scene = *world->getActiveScene();
+	auto&       journal = scene.getJournal();
+	const auto& nodes = scene.getTransforms().getNodes();
+	bool        lights_moved = std::any_of(journal.getTransforms().begin(), journal.getTransforms().end(),
+	    [&nodes](uint32_t index) { return nodes[index]->hasComponent<Light>(); });
+	if (full_upload || !journal.getLights().empty() || lights_moved) {
+		updateLights();
+		changed = true;
+	}
 
-	scene_uniform->upload(&scene_data, sizeof(GpuSceneData));
+	if (changed)
+		scene_uniform->upload(&scene_data, sizeof(GpuSceneData));
 }
 
 void RenderScene::updateLights()
@@ -229,27 +304,7 @@ void RenderScene::updateLights()
 	for (uint32_t i = 0; i < scene_data.light_count; ++i) {
 		auto* light = lights[i];
 		auto& gpu_light = scene_data.lights[i];
-		Node* light_node = nullptr;
-
-		std::function<Node*(Node*)> findLightNode = [&](Node* node) -> Node* {
-			if (!node)
-				return nullptr;
-
-			if (node->hasComponent<Light>() && &node->getComponent<Light>() == light)
-				return node;
-
-			for (auto* child : node->getChildren())
-				if (auto* found = findLightNode(child))
-					return found;
-
-			return nullptr;
-		};
-
-		for (auto* root = scene->getRoot(); auto* child : root->getChildren()) {
-			light_node = findLightNode(child);
-			if (light_node)
-				break;
-		}
+		Node* light_node = light->getNode();
 
 		glm::vec3 position(0.0f);
 		glm::vec3 direction(0.0f, -1.0f, 0.0f);
@@ -286,32 +341,142 @@ void RenderScene::updateMesh()
 	if (!world || !world->getActiveScene())
 		return;
 
-	auto scene = world->getActiveScene();
+	auto&       scene = *world->getActiveScene();
+	const auto& nodes = scene.getTransforms().getNodes();
+	const auto& world_matrices = scene.getTransforms().getWorldMatrices();
 
-	std::function<void(Node*)> traverse = [&](Node* node) {
-		if (!node)
-			return;
+	auto upload = [&](const Mesh& mesh, const glm::mat4& world_matrix) {
+		for (const auto& submesh : mesh.getSubmeshes()) {
+			auto it = submesh_to_gpu_mesh.find(submesh);
+			if (it == submesh_to_gpu_mesh.end())
+				continue;
 
-		if (node->hasComponent<Mesh>()) {
-			auto& mesh = node->getComponent<Mesh>();
-			auto  world_matrix = getWorldMatrix(node);
+			auto* gpu_mesh = it->second;
+			gpu_mesh->setModelMatrix(world_matrix);
+			gpu_mesh->updateUniforms();
+			occlusion_culler->setModelMatrix(gpu_mesh->getDrawIndex(), world_matrix);
 
-			for (auto submesh : mesh.getSubmeshes()) {
-				auto it = submesh_to_gpu_mesh.find(submesh);
-				if (it != submesh_to_gpu_mesh.end()) {
-					it->second->setModelMatrix(world_matrix);
-					it->second->updateUniforms();
-				}
+			if (submesh->hasBounds()) {
+				auto bounds = Aabb{submesh->getBoundsMin(), submesh->getBoundsMax()}.transformed(world_matrix);
+				frustum_culler.setBounds(gpu_mesh->getDrawIndex(), bounds.min, bounds.max);
 			}
 		}
-
-		for (auto* child : node->getChildren())
-			traverse(child);
 	};
 
-	auto* root = scene->getRoot();
-	for (auto* child : root->getChildren())
-		traverse(child);
+	// A fresh build uploads every mesh, afterwards only the world matrices the journal lists were recomputed
+	if (full_upload) {
+		scene.each<Mesh, Transform>([&](Node&, Mesh& mesh, Transform& transform) {
+			upload(mesh, transform.getWorldMatrix());
+		});
+	} else {
+		for (auto index : scene.getJournal().getTransforms())
+			if (nodes[index]->hasComponent<Mesh>())
+				upload(nodes[index]->getComponent<Mesh>(), world_matrices[index]);
+	}
+}
+
+void RenderScene::updateMaterials()
+{
+	if (!world || !world->getActiveScene())
+		return;
+
+	const auto& changed = world->getActiveScene()->getJournal().getMaterials();
+	if (changed.empty())
+		return;
+
+	for (auto& gpu_material : gpu_materials)
+		if (std::ranges::find(changed, gpu_material->getSourceMaterial().get()) != changed.end())
+			gpu_material->refresh();
+}
+
+void RenderScene::updateLods()
+{
+	auto  camera_position = glm::vec3(scene_data.camera_position);
+	float pixels_per_unit = scene_data.projection[1][1] * static_cast<float>(context->getSwapChain().getExtent().height) * 0.5f;
+
+	for (auto& gpu_mesh : gpu_meshes)
+		gpu_mesh->selectLod(camera_position, std::abs(pixels_per_unit), LOD_PIXEL_ERROR);
+}
+
+void RenderScene::updateCulling()
+{
+	Frustum frustum(scene_data.projection * scene_data.view);
+	auto    camera_position = glm::vec3(scene_data.camera_position);
+
+	// Normal cones assume rays from the camera position, an orthographic projection has none
+	bool backface_culling = scene_data.projection[3][3] == 0.0f;
+
+	// Whole draws first, eight boxes at a time, then the meshlets of the draws that survived
+	frustum_culler.cull(frustum);
+	for (auto& gpu_mesh : gpu_meshes)
+		if (frustum_culler.isVisible(gpu_mesh->getDrawIndex()))
+			gpu_mesh->cullMeshlets(frustum, camera_position, backface_culling);
+}
+
+// Rasterizes the occluders and tests the draws on the thread pool while the previous frame finishes on the GPU
+void RenderScene::updateOcclusion()
+{
+	occlusion_culler->begin(scene_data.projection * scene_data.view, frustum_culler);
+}
+
+void RenderScene::updateStreaming()
+{
+	++frame_count;
+
+	std::erase_if(retired_bindings, [&](RetiredBinding& retired) {
+		if (frame_count - retired.frame < RETIRE_FRAMES)
+			return false;
+
+		if (retired.set.get())
+			material_pool->free(retired.set);
+		return true;
+	});
+
+	if (!texture_streamer)
+		return;
+
+	auto streamed = texture_streamer->update();
+	if (streamed.empty())
+		return;
+
+	std::unordered_set<std::shared_ptr<Texture>> completed;
+	for (auto& texture : streamed) {
+		completed.insert(texture.texture->getSourceTexture());
+		releaseSource(*texture.texture->getSourceTexture(), residency.textures);
+		retired_bindings.push_back({.frame = frame_count, .image = std::move(texture.previous)});
+	}
+
+	for (auto& gpu_material : gpu_materials) {
+		auto material = gpu_material->getSourceMaterial();
+		auto base_color = material->getTexture("baseColor");
+		auto metallic_roughness = material->getTexture("metallicRoughness");
+		if (!completed.contains(base_color) && !completed.contains(metallic_roughness))
+			continue;
+
+		auto previous = gpu_material->setTextures(*material_layout, *material_pool, findImage(base_color), findImage(metallic_roughness));
+		retired_bindings.push_back({.frame = frame_count, .set = previous});
+	}
+}
+
+Image* RenderScene::findImage(const std::shared_ptr<Texture>& texture) const
+{
+	if (!texture)
+		return nullptr;
+
+	auto it = texture_to_gpu_texture.find(texture);
+	return it != texture_to_gpu_texture.end() ? it->second->getImage() : nullptr;
+}
+
+void RenderScene::releaseSource(Resource& resource, ResidencyPolicy policy) const
+{
+	if (policy == ResidencyPolicy::Keep)
+		return;
+
+	// A rebuild could not restore it without a reloader
+	if (policy == ResidencyPolicy::Reload && !resource.canReload())
+		return;
+
+	resource.release();
 }
 
 glm::mat4 RenderScene::getWorldMatrix(const Node* node) const
@@ -328,17 +493,73 @@ void RenderScene::update(float dt)
 	if (!world || !world->getActiveScene())
 		return;
 
+	// The occlusion pass of the last update still reads the bounds and matrices refreshed below
+	occlusion_culler->wait();
+
 	if (needsRebuild())
 		rebuild();
 
+	// Refreshes changed world matrices and records them in the journal the updates below consume
+	auto& scene = *world->getActiveScene();
+	scene.getTransforms().update();
+
 	updateCamera();
 	updateMesh();
+	updateMaterials();
+	updateLods();
+	updateCulling();
+	updateOcclusion();
+	updateStreaming();
+
+	scene.getJournal().clear();
+	full_upload = false;
 }
 
 void RenderScene::rebuild()
 {
-	context->getDevice().logical().waitIdle();
+	// A pending occlusion pass reads the frustum culler that build resizes
+	occlusion_culler->wait();
+	context->waitIdle();
 
+	build();
+}
+
+bool RenderScene::stream()
+{
+	if (!texture_streamer || texture_streamer->idle())
+		return false;
+
+	updateStreaming();
+	return !texture_streamer->idle();
+}
+
+size_t RenderScene::getStreamingCount() const
+{
+	return texture_streamer ? texture_streamer->remaining() : 0;
+}
+
+size_t RenderScene::getVisibleCount() const
+{
+	return frustum_culler.getVisibleCount();
+}
+
+size_t RenderScene::getCulledCount() const
+{
+	return frustum_culler.getCulledCount();
+}
+
+size_t RenderScene::getOccludedCount() const
+{
+	return occlusion_culler->getOccludedCount();
+}
+
+float RenderScene::getOccludedRatio() const
+{
+	return occlusion_culler->getOccludedRatio();
+}
+
+void RenderScene::build()
+{
 	clear();
 
 	if (!world || !world->getActiveScene())
@@ -350,10 +571,14 @@ void RenderScene::rebuild()
 	if (materials.size() > material_pool->setsCount()) {
 		uint32_t                            material_count = std::max(1u, static_cast<uint32_t>(materials.size()));
 		std::vector<vk::DescriptorPoolSize> material_pool_sizes = {
-		    {vk::DescriptorType::eUniformBuffer, material_count},
-		    {vk::DescriptorType::eCombinedImageSampler, material_count * 5},
+		    {vk::DescriptorType::eUniformBuffer, material_count * SETS_PER_MATERIAL},
+		    {vk::DescriptorType::eCombinedImageSampler, material_count * SETS_PER_MATERIAL * 5},
 		};
-		material_pool = std::make_unique<DescriptorPool>(*context, material_count, material_pool_sizes);
+		material_pool = std::make_unique<DescriptorPool>(
+		    *context,
+		    material_count * SETS_PER_MATERIAL,
+		    material_pool_sizes,
+		    vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
 	}
 
 	if (submeshes.size() > object_pool->setsCount()) {
@@ -368,6 +593,8 @@ void RenderScene::rebuild()
 	loadMaterials();
 	loadMeshes();
 	organizeMeshesByMaterial();
+
+	full_upload = true;
 }
 
 void RenderScene::draw(vk::CommandBuffer command_buffer, vk::PipelineLayout pipeline_layout)
@@ -379,6 +606,12 @@ void RenderScene::draw(vk::CommandBuffer command_buffer, vk::PipelineLayout pipe
 	    scene_descriptor.get(),
 	    {});
 
+	occlusion_culler->wait();
+
+	auto visible = [this](const GpuMesh* mesh) {
+		return frustum_culler.isVisible(mesh->getDrawIndex()) && !occlusion_culler->isOccluded(mesh->getDrawIndex());
+	};
+
 	for (auto& [material, meshes] : meshes_by_material) {
 		GpuMaterial* gpu_material = nullptr;
 		for (auto& gm : gpu_materials) {
@@ -388,11 +621,14 @@ void RenderScene::draw(vk::CommandBuffer command_buffer, vk::PipelineLayout pipe
 			}
 		}
 
-		if (!gpu_material)
+		if (!gpu_material || std::ranges::none_of(meshes, visible))
 			continue;
 		gpu_material->bind(command_buffer, pipeline_layout);
 
 		for (auto* mesh : meshes) {
+			if (!visible(mesh))
+				continue;
+
 			mesh->bind(command_buffer, pipeline_layout);
 			mesh->draw(command_buffer);
 		}
@@ -5,7 +5,10 @@
 #include <unordered_map>
 
 #include "GpuMesh.hpp"
+#include "FrustumCuller.hpp"
+#include "OcclusionCuller.hpp"
 #include "GpuTexture.hpp"
+#include "TextureStreamer.hpp"
 #include "Render/Graphics/Buffer.hpp"
 #include "Render/Graphics/Context.hpp"
 #include "Render/Graphics/Descriptor.hpp"
@@ -13,10 +16,24 @@
 #include "Scene/World.hpp"
 #include "Scene/Resources/Texture.hpp"
 
+// What happens to the CPU copy of a resource once the GPU holds it
+enum class ResidencyPolicy {
+	Keep,    // Stays in memory
+	Release, // Dropped after upload, a rebuild leaves the resource out
+	Reload,  // Dropped after upload and reloaded when a rebuild needs it, kept when the loader installed no reloader
+};
+
+struct ResidencySettings {
+	ResidencyPolicy textures{ResidencyPolicy::Keep};
+	ResidencyPolicy meshes{ResidencyPolicy::Keep};
+};
+
 class RenderScene {
 private:
 	const World* world{};
 
+	ResidencySettings residency;
+
 	// Set 0: Scene-level descriptor
 	DescriptorSet                        scene_descriptor;
 	std::unique_ptr<DescriptorSetLayout> scene_layout;
@@ -33,6 +50,17 @@ private:
 
 	std::unordered_map<std::shared_ptr<Texture>, GpuTexture*> texture_to_gpu_texture;
 
+	// Images and sets replaced by streaming, freed once no frame in flight can reference them
+	struct RetiredBinding {
+		uint64_t               frame{};
+		std::unique_ptr<Image> image;
+		DescriptorSet          set;
+	};
+
+	std::unique_ptr<TextureStreamer> texture_streamer;
+	std::vector<RetiredBinding>      retired_bindings;
+	uint64_t                         frame_count{0};
+
 	// Set 2: Object-level
 	std::unique_ptr<DescriptorSetLayout>  object_layout;
 	std::unique_ptr<DescriptorPool>       object_pool;
@@ -41,8 +69,17 @@ private:
 	std::unordered_map<std::shared_ptr<Material>, std::vector<GpuMesh*>> meshes_by_material;
 	std::unordered_map<std::shared_ptr<SubMesh>, GpuMesh*>               submesh_to_gpu_mesh;
 
-	size_t last_submesh_count{0};
-	size_t last_material_count{0};
+	// World bounds per draw, indexed by the draw index of each GpuMesh and tested against the camera every frame
+	FrustumCuller frustum_culler;
+	// Runs from the end of an update until the next draw, declared after the frustum culler it reads
+	std::unique_ptr<OcclusionCuller> occlusion_culler{std::make_unique<OcclusionCuller>()};
+
+	// Generations of the scene buckets the last build read, a change triggers a rebuild
+	uint64_t submesh_generation{0};
+	uint64_t material_generation{0};
+
+	// Set by a build, the next update uploads everything instead of what the scene journal lists
+	bool full_upload{true};
 
 	Context* context{};
 
@@ -54,31 +91,52 @@ private:
 	void loadMaterials();
 	void loadMeshes();
 	void organizeMeshesByMaterial();
+	void selectOccluders();
 
+	void build();
 	bool needsRebuild() const;
 	void clear();
 
 	void updateCamera();
 	void updateLights();
 	void updateMesh();
+	void updateMaterials();
+	void updateLods();
+	void updateCulling();
+	void updateOcclusion();
+	void updateStreaming();
+
+	Image* findImage(const std::shared_ptr<Texture>& texture) const;
+	void   releaseSource(Resource& resource, ResidencyPolicy policy) const;
 
 	glm::mat4 getWorldMatrix(const Node* node) const;
 
 public:
 	RenderScene() = default;
-	RenderScene(Context& context, const World& world);
+	RenderScene(Context& context, const World& world, ResidencySettings residency = {});
 	~RenderScene() = default;
 
 	RenderScene(const RenderScene&) = delete;
 	RenderScene& operator=(const RenderScene&) = delete;
 
-	RenderScene(RenderScene&&) noexcept = default;
-	RenderScene& operator=(RenderScene&&) noexcept = default;
+	RenderScene(RenderScene&&) noexcept = delete;
+	RenderScene& operator=(RenderScene&&) noexcept = delete;
 
 	void update(float dt);
 	void rebuild();
 	void draw(vk::CommandBuffer command_buffer, vk::PipelineLayout pipeline_layout);
 
+	// Advances texture streaming without drawing, for a scene built on a loader thread. True while textures remain
+	bool   stream();
+	size_t getStreamingCount() const;
+
+	// Draws the last update kept or rejected against the camera frustum
+	size_t getVisibleCount() const;
+	size_t getCulledCount() const;
+	// Draws inside the frustum hidden behind occluders, and their share of the draws inside the frustum
+	size_t getOccludedCount() const;
+	float  getOccludedRatio() const;
+
 	std::vector<vk::DescriptorSetLayout> getDescriptorSetLayouts() const;
 
 	DescriptorSet        getSceneDescriptor();
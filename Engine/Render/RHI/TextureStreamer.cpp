@@ -0,0 +1,116 @@
+#include "TextureStreamer.hpp"
+
+#include <chrono>
+
+#include "Core/Thread/ThreadPool.hpp"
+#include "Render/Graphics/Device.hpp"
+
+TextureStreamer::TextureStreamer(Context& context, uint64_t budget) :
+    budget(budget), context(&context)
+{
+	command_pool = std::make_unique<CommandPool>(context, context.getDevice().graphicsQueueIndex(), vk::CommandPoolCreateFlagBits::eTransient);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	clear();
+}
+
+void TextureStreamer::enqueue(GpuTexture& texture)
+{
+	if (!texture.isFullyResident())
+		pending.push_back(&texture);
+}
+
+void TextureStreamer::begin(GpuTexture& texture)
+{
+	Upload upload{.texture = &texture};
+	auto   data = texture.getUploadData(0, upload.levels);
+
+	upload.staging = std::make_unique<Buffer>(
+	    *context,
+	    data.size(),
+	    vk::BufferUsageFlagBits::eTransferSrc,
+	    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+	upload.image = std::make_unique<Image>(*context, upload.levels, texture.getImageFormat());
+
+	// Reading the source touches every page of a mapped cooked file, that cost stays off the render thread
+	upload.fill = ThreadPool::instance().submit([staging = upload.staging.get(), data]() {
+		staging->upload(data.data(), data.size());
+	});
+
+	uploads.push_back(std::move(upload));
+}
+
+void TextureStreamer::submit(Upload& upload)
+{
+	upload.command = command_pool->allocate();
+	upload.command.begin();
+	upload.image->recordUpload(upload.command.get(), *upload.staging, upload.levels);
+	upload.command.end();
+
+	upload.fence = std::make_unique<Fence>(*context, false);
+	context->submit({upload.command}, upload.fence.get());
+}
+
+std::vector<StreamedTexture> TextureStreamer::update()
+{
+	std::vector<StreamedTexture> completed;
+	for (auto it = uploads.begin(); it != uploads.end();) {
+		if (it->fill.valid()) {
+			if (it->fill.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+				it->fill.get();
+				submit(*it);
+			}
+			++it;
+			continue;
+		}
+
+		if (!it->fence->signaled()) {
+			++it;
+			continue;
+		}
+
+		command_pool->free(it->command);
+		completed.push_back({.texture = it->texture, .previous = it->texture->swapImage(std::move(it->image))});
+		it = uploads.erase(it);
+	}
+
+	uint64_t started = 0;
+	while (!pending.empty()) {
+		std::vector<ImageLevel> levels;
+		auto                    size = pending.front()->getUploadData(0, levels).size();
+		if (started > 0 && started + size > budget)
+			break;
+
+		started += size;
+		begin(*pending.front());
+		pending.pop_front();
+	}
+
+	return completed;
+}
+
+void TextureStreamer::clear()
+{
+	pending.clear();
+	for (auto& upload : uploads) {
+		if (upload.fill.valid())
+			upload.fill.wait();
+		if (upload.fence) {
+			upload.fence->wait();
+			command_pool->free(upload.command);
+		}
+	}
+	uploads.clear();
+}
+
+bool TextureStreamer::idle() const
+{
+	return pending.empty() && uploads.empty();
+}
+
+size_t TextureStreamer::remaining() const
+{
+	return pending.size() + uploads.size();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "GpuTexture.hpp"
+#include "Render/Graphics/Buffer.hpp"
+#include "Render/Graphics/Command.hpp"
+#include "Render/Graphics/Context.hpp"
+#include "Render/Graphics/Image.hpp"
+#include "Render/Graphics/Sync.hpp"
+
+// A texture whose full chain became resident this frame, previous still holds the low resolution image
+struct StreamedTexture {
+	GpuTexture*            texture{};
+	std::unique_ptr<Image> previous;
+};
+
+// Brings textures created at a small resident size to full resolution over the following frames. A worker fills the
+// staging memory, the transfer is submitted without waiting and the image is swapped in once its fence has signaled
+class TextureStreamer {
+public:
+	static constexpr uint32_t resident_size = 64;
+	static constexpr uint64_t frame_budget = 32ull << 20;
+
+private:
+	struct Upload {
+		GpuTexture*             texture{};
+		std::vector<ImageLevel> levels;
+		std::unique_ptr<Buffer> staging;
+		std::unique_ptr<Image>  image;
+		std::future<void>       fill;
+		CommandBuffer           command;
+		std::unique_ptr<Fence>  fence;
+	};
+
+	std::deque<GpuTexture*> pending;
+	std::vector<Upload>     uploads;
+	uint64_t                budget{frame_budget};
+
+	// Owned so a scene can stream on its loader thread before the render thread takes it over
+	std::unique_ptr<CommandPool> command_pool;
+
+	Context* context{};
+
+	void begin(GpuTexture& texture);
+	void submit(Upload& upload);
+
+public:
+	TextureStreamer(Context& context, uint64_t budget = frame_budget);
+	~TextureStreamer();
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	void enqueue(GpuTexture& texture);
+	// Starts uploads within the byte budget, the first one of a frame always starts so one large texture cannot stall
+	auto update() -> std::vector<StreamedTexture>;
+	// Drops every request, waits for the work already handed to workers and the GPU
+	void clear();
+
+	bool   idle() const;
+	size_t remaining() const;
+};
@@ -1,5 +1,8 @@
 #include "Renderer.hpp"
 
+#include <format>
+#include <stdexcept>
+
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,6 +14,18 @@
 #include "Core/File/PathResolver.hpp"
 #include "Core/File/JsonParser.hpp"
 
+static ResidencyPolicy toResidencyPolicy(const std::string& name)
+{
+	if (name == "keep")
+		return ResidencyPolicy::Keep;
+	if (name == "release")
+		return ResidencyPolicy::Release;
+	if (name == "reload")
+		return ResidencyPolicy::Reload;
+
+	throw std::runtime_error(std::format("Unknown residency policy {}", name));
+}
+
 Renderer::Renderer(Window& window)
 {
 	context = std::make_unique<Context>(window);
@@ -77,7 +92,7 @@ void Renderer::call()
 
 void Renderer::wait()
 {
-	context->getDevice().logical().waitIdle();
+	context->waitIdle();
 }
 
 void Renderer::draw()
@@ -139,9 +154,17 @@ World* Renderer::getActiveWorld() const
 
 void Renderer::setActiveWorld(World& world)
 {
-	active_world = &world;
+	setActiveWorld(world, createRenderScene(world));
+}
 
-	render_scene = std::make_unique<RenderScene>(*context, *active_world);
+void Renderer::setActiveWorld(World& world, std::unique_ptr<RenderScene> scene)
+{
+	// The previous scene may still be referenced by frames in flight
+	if (render_scene)
+		wait();
+
+	active_world = &world;
+	render_scene = std::move(scene);
 
 	auto descriptor_layouts = render_scene->getDescriptorSetLayouts();
 
@@ -165,6 +188,18 @@ void Renderer::setActiveWorld(World& world)
 	deferred_pipeline->build(descriptor_layouts, geometry_shader->getStages(), descriptor_layouts, lighting_shader->getStages());
 }
 
+std::unique_ptr<RenderScene> Renderer::createRenderScene(const World& world) const
+{
+	const auto& config_data = JsonParser::readJson(PathResolver::getConfigsDir() / "config.json");
+
+	ResidencySettings residency{
+	    .textures = toResidencyPolicy(config_data.value("texture_residency", "keep")),
+	    .meshes = toResidencyPolicy(config_data.value("mesh_residency", "keep")),
+	};
+
+	return std::make_unique<RenderScene>(*context, world, residency);
+}
+
 Context& Renderer::getContext() const
 {
 	return *context;
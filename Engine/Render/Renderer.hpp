@@ -66,6 +66,10 @@ public:
 
 	auto getActiveWorld() const -> World*;
 	void setActiveWorld(World& world);
+	// Takes over a scene built elsewhere, the loader thread for instance
+	void setActiveWorld(World& world, std::unique_ptr<RenderScene> scene);
+	// Safe to call from any thread, touches only the context
+	auto createRenderScene(const World& world) const -> std::unique_ptr<RenderScene>;
 
 	Context&     getContext() const;
 	RenderScene& getRenderScene() const;
@@ -1,5 +1,7 @@
 #include "Light.hpp"
 
+#include "Scene/Core/Scene.hpp"
+
 Light::Light(const std::string& name) :
     Component(name)
 {}
@@ -9,6 +11,12 @@ std::type_index Light::getType()
 	return typeid(Light);
 }
 
+void Light::markChanged()
+{
+	if (auto* scene = getScene())
+		scene->getJournal().recordLight(*this);
+}
+
 glm::vec3 Light::getColor() const
 {
 	return color;
@@ -17,6 +25,7 @@ glm::vec3 Light::getColor() const
 void Light::setColor(const glm::vec3& color)
 {
 	this->color = color;
+	markChanged();
 }
 
 float Light::getIntensity() const
@@ -27,6 +36,7 @@ float Light::getIntensity() const
 void Light::setIntensity(float intensity)
 {
 	this->intensity = intensity;
+	markChanged();
 }
 
 DirectionalLight::DirectionalLight(const std::string& name) :
@@ -46,6 +56,7 @@ glm::vec3 DirectionalLight::getDirection() const
 void DirectionalLight::setDirection(const glm::vec3& direction)
 {
 	this->direction = direction;
+	markChanged();
 }
 
 PointLight::PointLight(const std::string& name) :
@@ -65,6 +76,7 @@ float PointLight::getRange() const
 void PointLight::setRange(float range)
 {
 	this->range = range;
+	markChanged();
 }
 
 SpotLight::SpotLight(const std::string& name) :
@@ -84,6 +96,7 @@ glm::vec3 SpotLight::getDirection() const
 void SpotLight::setDirection(const glm::vec3& direction)
 {
 	this->direction = direction;
+	markChanged();
 }
 
 float SpotLight::getRange() const
@@ -94,6 +107,7 @@ float SpotLight::getRange() const
 void SpotLight::setRange(float range)
 {
 	this->range = range;
+	markChanged();
 }
 
 float SpotLight::getInnerConeAngle() const
@@ -104,6 +118,7 @@ float SpotLight::getInnerConeAngle() const
 void SpotLight::setInnerConeAngle(float angle)
 {
 	this->inner_cone_angle = angle;
+	markChanged();
 }
 
 float SpotLight::getOuterConeAngle() const
@@ -114,4 +129,5 @@ float SpotLight::getOuterConeAngle() const
 void SpotLight::setOuterConeAngle(float angle)
 {
 	this->outer_cone_angle = angle;
+	markChanged();
 }
@@ -11,6 +11,9 @@ protected:
 	glm::vec3 color{1.0f, 1.0f, 1.0f};
 	float     intensity{1.0f};
 
+	// Lights placed in a scene report value changes to its journal
+	void markChanged();
+
 public:
 	Light(const std::string& name);
 	~Light() override = default;
@@ -1,60 +1,92 @@
 #include "Transform.hpp"
 
+#include <glm/gtx/matrix_decompose.hpp>
+
 #include "Scene/Core/Node.hpp"
+#include "Scene/Core/Scene.hpp"
+#include "Scene/Core/TransformStore.hpp"
 
 std::type_index Transform::getType()
 {
 	return typeid(Transform);
 }
 
+void Transform::attach(TransformStore& new_store, uint32_t new_index)
+{
+	store = &new_store;
+	index = new_index;
+}
+
+void Transform::detach()
+{
+	if (!store)
+		return;
+
+	translation = store->translations[index];
+	rotation = store->rotations[index];
+	scaling = store->scalings[index];
+	store = nullptr;
+}
+
+// Joining the store is deferred to the first world matrix query, the hierarchy is usually complete by then
+TransformStore* Transform::findStore() const
+{
+	if (store)
+		return store;
+
+	if (auto* scene = node ? node->getScene() : nullptr) {
+		scene->getTransforms().update();
+		return store;
+	}
+
+	return nullptr;
+}
+
 void Transform::translate(const glm::vec3& delta)
 {
-	translation += delta;
-	invalidateWorldMatrix();
+	setTranslation(getTranslation() + delta);
 }
 
 void Transform::rotate(const glm::vec3& axis, float angle)
 {
-	rotation = glm::normalize(glm::angleAxis(angle, axis) * rotation);
-	invalidateWorldMatrix();
+	setRotation(glm::normalize(glm::angleAxis(angle, axis) * getRotation()));
 }
 
 void Transform::scale(const glm::vec3& factor)
 {
-	scaling *= factor;
-	invalidateWorldMatrix();
+	setScaling(getScaling() * factor);
 }
 
 const glm::vec3& Transform::getTranslation() const
 {
-	return translation;
+	return store ? store->translations[index] : translation;
 }
 
 void Transform::setTranslation(const glm::vec3& translation)
 {
-	this->translation = translation;
+	(store ? store->translations[index] : this->translation) = translation;
 	invalidateWorldMatrix();
 }
 
 const glm::quat& Transform::getRotation() const
 {
-	return rotation;
+	return store ? store->rotations[index] : rotation;
 }
 
 void Transform::setRotation(const glm::quat& rotation)
 {
-	this->rotation = rotation;
+	(store ? store->rotations[index] : this->rotation) = rotation;
 	invalidateWorldMatrix();
 }
 
 const glm::vec3& Transform::getScaling() const
 {
-	return scaling;
+	return store ? store->scalings[index] : scaling;
 }
 
 void Transform::setScaling(const glm::vec3& scale)
 {
-	this->scaling = scale;
+	(store ? store->scalings[index] : this->scaling) = scale;
 	invalidateWorldMatrix();
 }
 
@@ -70,38 +102,38 @@ void Transform::setNode(Node& node)
 
 glm::mat4 Transform::getMatrix() const
 {
-	return glm::translate(glm::mat4(1.0f), translation)
-	    * glm::mat4_cast(rotation)
-	    * glm::scale(glm::mat4(1.0f), scaling);
+	return TransformStore::compose(getTranslation(), getRotation(), getScaling());
 }
 
 glm::mat4 Transform::getWorldMatrix()
 {
-	updateWorldTransform();
+	if (auto* transforms = findStore()) {
+		transforms->update();
+		return transforms->world_matrices[index];
+	}
+
+	auto world_matrix = getMatrix();
+	for (auto* parent = node->getParent(); parent; parent = parent->getParent())
+		world_matrix = parent->getTransform().getMatrix() * world_matrix;
+
 	return world_matrix;
 }
 
 void Transform::setMatrix(const glm::mat4& matrix)
 {
-	this->world_matrix = matrix;
-	invalidateWorldMatrix();
-}
+	glm::vec3 new_translation, new_scaling, skew;
+	glm::quat new_rotation;
+	glm::vec4 perspective;
+	if (!glm::decompose(matrix, new_scaling, new_rotation, new_translation, skew, perspective))
+		return;
 
-void Transform::invalidateWorldMatrix()
-{
-	update_world_matrix = true;
+	setTranslation(new_translation);
+	setRotation(new_rotation);
+	setScaling(new_scaling);
 }
 
-void Transform::updateWorldTransform()
+void Transform::invalidateWorldMatrix()
 {
-	if (!update_world_matrix)
-		return;
-
-	world_matrix = getMatrix();
-	if (auto* parent = node->getParent(); parent) {
-		auto& transform = parent->getTransform();
-		world_matrix = transform.getWorldMatrix() * world_matrix;
-	}
-
-	update_world_matrix = false;
+	if (store)
+		store->markDirty(index);
 }
@@ -6,18 +6,27 @@
 #include "Scene/Core/Component.hpp"
 
 class Node;
+class TransformStore;
 
+// Handle into the TransformStore of the scene. Until the node joins a scene hierarchy the values live here
+// and the world matrix is computed through the parents on every call
 class Transform : public Component {
 private:
 	glm::vec3 translation{0.0f, 0.0f, 0.0f};
 	glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
 	glm::vec3 scaling{1.0f, 1.0f, 1.0f};
-	glm::mat4 world_matrix{1.0f};
-	bool      update_world_matrix{true};
+
+	TransformStore* store{};
+	uint32_t        index{};
 
 	Node* node{};
 
-	void updateWorldTransform();
+	friend class TransformStore;
+
+	void attach(TransformStore& store, uint32_t index);
+	void detach();
+
+	auto findStore() const -> TransformStore*;
 
 public:
 	Transform() = default;
@@ -43,6 +52,7 @@ public:
 
 	auto getMatrix() const -> glm::mat4;
 	auto getWorldMatrix() -> glm::mat4;
+	// Replaces the local transform, the matrix is decomposed into translation, rotation and scaling
 	void setMatrix(const glm::mat4& matrix);
 	void invalidateWorldMatrix();
 };
@@ -0,0 +1,396 @@
+#include "AabbTree.hpp"
+
+#include <cmath>
+#include <utility>
+#include <algorithm>
+
+bool Aabb::valid() const
+{
+	return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+}
+
+bool Aabb::contains(const Aabb& other) const
+{
+	return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z
+	    && max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+}
+
+bool Aabb::overlaps(const Aabb& other) const
+{
+	return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z
+	    && max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+}
+
+glm::vec3 Aabb::center() const
+{
+	return (min + max) * 0.5f;
+}
+
+float Aabb::surfaceArea() const
+{
+	auto size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+float Aabb::distance2(const glm::vec3& point) const
+{
+	auto offset = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+	return glm::dot(offset, offset);
+}
+
+float Aabb::intersect(const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance) const
+{
+	auto t1 = (min - origin) * inverse_direction;
+	auto t2 = (max - origin) * inverse_direction;
+
+	auto  t_min = glm::min(t1, t2);
+	auto  t_max = glm::max(t1, t2);
+	float enter = std::max({t_min.x, t_min.y, t_min.z, 0.0f});
+	float exit = std::min({t_max.x, t_max.y, t_max.z, max_distance});
+
+	return enter <= exit ? enter : -1.0f;
+}
+
+Aabb Aabb::expanded(float margin) const
+{
+	return {min - glm::vec3(margin), max + glm::vec3(margin)};
+}
+
+Aabb Aabb::transformed(const glm::mat4& matrix) const
+{
+	auto center = glm::vec3(matrix * glm::vec4(this->center(), 1.0f));
+	auto extents = (max - min) * 0.5f;
+
+	glm::vec3 world_extents(0.0f);
+	for (int axis = 0; axis < 3; axis++)
+		world_extents += glm::abs(glm::vec3(matrix[axis])) * extents[axis];
+
+	return {center - world_extents, center + world_extents};
+}
+
+Aabb Aabb::merge(const Aabb& a, const Aabb& b)
+{
+	return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+int32_t AabbTree::allocate()
+{
+	if (free_list == NULL_NODE) {
+		nodes.emplace_back();
+		return static_cast<int32_t>(nodes.size() - 1);
+	}
+
+	auto index = free_list;
+	free_list = nodes[index].parent;
+	nodes[index] = TreeNode{};
+	return index;
+}
+
+void AabbTree::release(int32_t index)
+{
+	nodes[index] = TreeNode{};
+	nodes[index].parent = free_list;
+	free_list = index;
+}
+
+int32_t AabbTree::createProxy(const Aabb& bounds, Node* node)
+{
+	auto leaf = allocate();
+	auto size = bounds.max - bounds.min;
+
+	nodes[leaf].tight = bounds;
+	nodes[leaf].bounds = bounds.expanded(std::max(margin_floor, margin_fraction * std::max({size.x, size.y, size.z})));
+	nodes[leaf].node = node;
+	nodes[leaf].height = 0;
+
+	insertLeaf(leaf);
+	leaf_count++;
+
+	return leaf;
+}
+
+void AabbTree::destroyProxy(int32_t proxy)
+{
+	removeLeaf(proxy);
+	release(proxy);
+	leaf_count--;
+}
+
+bool AabbTree::moveProxy(int32_t proxy, const Aabb& bounds)
+{
+	nodes[proxy].tight = bounds;
+	if (nodes[proxy].bounds.contains(bounds))
+		return false;
+
+	auto size = bounds.max - bounds.min;
+	removeLeaf(proxy);
+	nodes[proxy].bounds = bounds.expanded(std::max(margin_floor, margin_fraction * std::max({size.x, size.y, size.z})));
+	insertLeaf(proxy);
+
+	return true;
+}
+
+void AabbTree::clear()
+{
+	nodes.clear();
+	root = NULL_NODE;
+	free_list = NULL_NODE;
+	leaf_count = 0;
+}
+
+Node* AabbTree::getNode(int32_t proxy) const
+{
+	return nodes[proxy].node;
+}
+
+const Aabb& AabbTree::getBounds(int32_t proxy) const
+{
+	return nodes[proxy].tight;
+}
+
+const Aabb& AabbTree::getFatBounds(int32_t proxy) const
+{
+	return nodes[proxy].bounds;
+}
+
+size_t AabbTree::size() const
+{
+	return leaf_count;
+}
+
+int32_t AabbTree::getHeight() const
+{
+	return root == NULL_NODE ? 0 : nodes[root].height;
+}
+
+void AabbTree::insertLeaf(int32_t leaf)
+{
+	if (root == NULL_NODE) {
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// Descend towards the sibling whose bounds grow the least, stop where pairing with the node itself is cheapest
+	auto leaf_bounds = nodes[leaf].bounds;
+	auto index = root;
+	while (!nodes[index].isLeaf()) {
+		auto child1 = nodes[index].child1;
+		auto child2 = nodes[index].child2;
+
+		float area = nodes[index].bounds.surfaceArea();
+		float combined_area = Aabb::merge(nodes[index].bounds, leaf_bounds).surfaceArea();
+
+		float cost = 2.0f * combined_area;
+		float inheritance_cost = 2.0f * (combined_area - area);
+
+		auto descend_cost = [&](int32_t child) {
+			float merged = Aabb::merge(leaf_bounds, nodes[child].bounds).surfaceArea();
+			return (nodes[child].isLeaf() ? merged : merged - nodes[child].bounds.surfaceArea()) + inheritance_cost;
+		};
+		float cost1 = descend_cost(child1);
+		float cost2 = descend_cost(child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	auto sibling = index;
+	auto old_parent = nodes[sibling].parent;
+	auto new_parent = allocate();
+
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].bounds = Aabb::merge(leaf_bounds, nodes[sibling].bounds);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent == NULL_NODE)
+		root = new_parent;
+	else if (nodes[old_parent].child1 == sibling)
+		nodes[old_parent].child1 = new_parent;
+	else
+		nodes[old_parent].child2 = new_parent;
+
+	refit(nodes[leaf].parent);
+}
+
+void AabbTree::removeLeaf(int32_t leaf)
+{
+	if (leaf == root) {
+		root = NULL_NODE;
+		return;
+	}
+
+	auto parent = nodes[leaf].parent;
+	auto grand_parent = nodes[parent].parent;
+	auto sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	release(parent);
+	nodes[leaf].parent = NULL_NODE;
+
+	if (grand_parent == NULL_NODE) {
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		return;
+	}
+
+	if (nodes[grand_parent].child1 == parent)
+		nodes[grand_parent].child1 = sibling;
+	else
+		nodes[grand_parent].child2 = sibling;
+	nodes[sibling].parent = grand_parent;
+
+	refit(grand_parent);
+}
+
+// Walks up from index restoring heights and bounds, rotating where the subtrees drifted apart
+void AabbTree::refit(int32_t index)
+{
+	while (index != NULL_NODE) {
+		index = balance(index);
+
+		auto child1 = nodes[index].child1;
+		auto child2 = nodes[index].child2;
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].bounds = Aabb::merge(nodes[child1].bounds, nodes[child2].bounds);
+
+		index = nodes[index].parent;
+	}
+}
+
+// Promotes the taller grandchild when the children of a differ in height by more than one, returns the new subtree root
+int32_t AabbTree::balance(int32_t a)
+{
+	if (nodes[a].isLeaf() || nodes[a].height < 2)
+		return a;
+
+	auto b = nodes[a].child1;
+	auto c = nodes[a].child2;
+	auto difference = nodes[c].height - nodes[b].height;
+
+	if (difference > 1 || difference < -1) {
+		// up is the taller child moving into the place of a, keep is the other child of a
+		bool right = difference > 1;
+		auto up = right ? c : b;
+		auto keep = right ? b : c;
+
+		auto f = nodes[up].child1;
+		auto g = nodes[up].child2;
+
+		nodes[up].child1 = a;
+		nodes[up].parent = nodes[a].parent;
+		nodes[a].parent = up;
+
+		if (nodes[up].parent == NULL_NODE)
+			root = up;
+		else if (nodes[nodes[up].parent].child1 == a)
+			nodes[nodes[up].parent].child1 = up;
+		else
+			nodes[nodes[up].parent].child2 = up;
+
+		// The taller grandchild stays under up, the shorter one replaces up as a child of a
+		auto taller = nodes[f].height > nodes[g].height ? f : g;
+		auto shorter = taller == f ? g : f;
+
+		nodes[up].child2 = taller;
+		if (right)
+			nodes[a].child2 = shorter;
+		else
+			nodes[a].child1 = shorter;
+		nodes[shorter].parent = a;
+
+		nodes[a].bounds = Aabb::merge(nodes[keep].bounds, nodes[shorter].bounds);
+		nodes[a].height = 1 + std::max(nodes[keep].height, nodes[shorter].height);
+		nodes[up].bounds = Aabb::merge(nodes[a].bounds, nodes[taller].bounds);
+		nodes[up].height = 1 + std::max(nodes[a].height, nodes[taller].height);
+
+		return up;
+	}
+
+	return a;
+}
+
+int32_t AabbTree::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float& distance) const
+{
+	if (root == NULL_NODE)
+		return NULL_NODE;
+
+	// Division by a zero component gives an infinity, which the slab test handles
+	auto    inverse_direction = 1.0f / direction;
+	int32_t hit = NULL_NODE;
+	float   closest = max_distance;
+
+	Stack stack;
+	stack.push(root);
+	while (!stack.empty()) {
+		auto        index = stack.pop();
+		const auto& node = nodes[index];
+		if (node.bounds.intersect(origin, inverse_direction, closest) < 0.0f)
+			continue;
+
+		if (node.isLeaf()) {
+			float entry = node.tight.intersect(origin, inverse_direction, closest);
+			if (entry >= 0.0f && (hit == NULL_NODE || entry < closest)) {
+				hit = index;
+				closest = entry;
+			}
+			continue;
+		}
+
+		// Closer child last so it is popped first and shortens the ray for the other
+		auto closer = node.child1;
+		auto farther = node.child2;
+		if (nodes[closer].bounds.distance2(origin) > nodes[farther].bounds.distance2(origin))
+			std::swap(closer, farther);
+		stack.push(farther);
+		stack.push(closer);
+	}
+
+	distance = closest;
+	return hit;
+}
+
+void AabbTree::findNearest(const glm::vec3& point, size_t count, std::vector<int32_t>& result) const
+{
+	result.clear();
+	if (root == NULL_NODE || count == 0)
+		return;
+
+	// result stays sorted by distance, a subtree is skipped once it cannot beat the current last of count
+	auto distance_of = [&](int32_t leaf) { return nodes[leaf].tight.distance2(point); };
+	auto worst = [&]() { return result.size() < count ? std::numeric_limits<float>::max() : distance_of(result.back()); };
+
+	Stack stack;
+	stack.push(root);
+	while (!stack.empty()) {
+		auto        index = stack.pop();
+		const auto& node = nodes[index];
+		if (node.bounds.distance2(point) >= worst())
+			continue;
+
+		if (node.isLeaf()) {
+			float distance = distance_of(index);
+			if (distance >= worst())
+				continue;
+
+			auto position = std::upper_bound(result.begin(), result.end(), distance,
+			    [&](float value, int32_t leaf) { return value < distance_of(leaf); });
+			result.insert(position, index);
+			if (result.size() > count)
+				result.pop_back();
+			continue;
+		}
+
+		auto closer = node.child1;
+		auto farther = node.child2;
+		if (nodes[closer].bounds.distance2(point) > nodes[farther].bounds.distance2(point))
+			std::swap(closer, farther);
+		stack.push(farther);
+		stack.push(closer);
+	}
+}
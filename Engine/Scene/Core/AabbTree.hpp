@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+class Node;
+
+struct Aabb {
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+	bool valid() const;
+	bool contains(const Aabb& other) const;
+	bool overlaps(const Aabb& other) const;
+	auto center() const -> glm::vec3;
+	float surfaceArea() const;
+	// Squared distance from the point to the box, zero inside
+	float distance2(const glm::vec3& point) const;
+	// Entry distance of the ray or a negative value on a miss, inverse_direction holds 1/direction per axis
+	float intersect(const glm::vec3& origin, const glm::vec3& inverse_direction, float max_distance) const;
+
+	auto expanded(float margin) const -> Aabb;
+	// Bounds of the box after the affine transform, from its center and the absolute matrix applied to its extents
+	auto transformed(const glm::mat4& matrix) const -> Aabb;
+
+	static Aabb merge(const Aabb& a, const Aabb& b);
+};
+
+// Dynamic bounding volume hierarchy over scene nodes. Leaves keep the tight bounds and a fat copy enlarged by a
+// margin, so small moves do not touch the tree. Insertion picks the sibling by surface area and rotations keep the
+// height logarithmic, which makes every query logarithmic in the number of leaves plus what it reports
+class AabbTree {
+private:
+	static constexpr int32_t NULL_NODE = -1;
+
+	struct TreeNode {
+		Aabb    bounds;
+		Aabb    tight;
+		Node*   node{};
+		int32_t parent{NULL_NODE};
+		int32_t child1{NULL_NODE};
+		int32_t child2{NULL_NODE};
+		// -1 while on the free list
+		int32_t height{-1};
+
+		bool isLeaf() const { return child1 == NULL_NODE; }
+	};
+
+	// Traversal stack on the caller's stack, a balanced tree of any practical size stays far below its capacity
+	struct Stack {
+		std::array<int32_t, 256> fixed;
+		std::vector<int32_t>     overflow;
+		size_t                   count{0};
+
+		void push(int32_t value)
+		{
+			if (count < fixed.size())
+				fixed[count] = value;
+			else
+				overflow.push_back(value);
+			count++;
+		}
+
+		int32_t pop()
+		{
+			count--;
+			if (count < fixed.size())
+				return fixed[count];
+
+			auto value = overflow.back();
+			overflow.pop_back();
+			return value;
+		}
+
+		bool empty() const { return count == 0; }
+	};
+
+	std::vector<TreeNode> nodes;
+	int32_t               root{NULL_NODE};
+	int32_t               free_list{NULL_NODE};
+	size_t                leaf_count{0};
+
+	int32_t allocate();
+	void    release(int32_t index);
+	void    insertLeaf(int32_t leaf);
+	void    removeLeaf(int32_t leaf);
+	int32_t balance(int32_t index);
+	void    refit(int32_t index);
+
+public:
+	AabbTree() = default;
+
+	int32_t createProxy(const Aabb& bounds, Node* node);
+	void    destroyProxy(int32_t proxy);
+	// True when the leaf left its fat bounds and was reinserted
+	bool    moveProxy(int32_t proxy, const Aabb& bounds);
+	void    clear();
+
+	Node* getNode(int32_t proxy) const;
+	auto  getBounds(int32_t proxy) const -> const Aabb&;
+	auto  getFatBounds(int32_t proxy) const -> const Aabb&;
+
+	size_t  size() const;
+	int32_t getHeight() const;
+
+	// Calls function(proxy) for every leaf whose fat bounds overlap, stops when it returns false
+	template <typename F>
+	void query(const Aabb& bounds, F&& function) const;
+
+	// Calls function(proxy) for every live leaf
+	template <typename F>
+	void each(F&& function) const;
+
+	// Closest leaf whose tight bounds the ray enters within max_distance, NULL_NODE on a miss
+	int32_t raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, float& distance) const;
+
+	// Up to count leaves closest to the point by distance to their tight bounds, nearest first
+	void findNearest(const glm::vec3& point, size_t count, std::vector<int32_t>& result) const;
+
+	// Fat bounds grow by this fraction of the largest extent, plus a floor for flat or tiny boxes
+	static constexpr float margin_fraction = 0.1f;
+	static constexpr float margin_floor = 0.01f;
+};
+
+template <typename F>
+void AabbTree::query(const Aabb& bounds, F&& function) const
+{
+	if (root == NULL_NODE)
+		return;
+
+	Stack stack;
+	stack.push(root);
+	while (!stack.empty()) {
+		const auto& node = nodes[stack.pop()];
+		if (!node.bounds.overlaps(bounds))
+			continue;
+
+		if (node.isLeaf()) {
+			if (!function(static_cast<int32_t>(&node - nodes.data())))
+				return;
+		} else {
+			stack.push(node.child1);
+			stack.push(node.child2);
+		}
+	}
+}
+
+template <typename F>
+void AabbTree::each(F&& function) const
+{
+	for (size_t index = 0; index < nodes.size(); index++)
+		if (nodes[index].height == 0)
+			function(static_cast<int32_t>(index));
+}
@@ -0,0 +1,129 @@
+#include "Archetype.hpp"
+
+#include <algorithm>
+
+#include "Node.hpp"
+
+Archetype::Archetype(std::vector<TypeId> types) :
+    types(std::move(types)),
+    columns(this->types.size())
+{}
+
+const std::vector<TypeId>& Archetype::getTypes() const
+{
+	return types;
+}
+
+const std::vector<Node*>& Archetype::getNodes() const
+{
+	return nodes;
+}
+
+const std::vector<Component*>& Archetype::getColumn(size_t column) const
+{
+	return columns[column];
+}
+
+int32_t Archetype::findColumn(TypeId type) const
+{
+	auto it = std::lower_bound(types.begin(), types.end(), type);
+	return it != types.end() && *it == type ? static_cast<int32_t>(it - types.begin()) : -1;
+}
+
+size_t Archetype::size() const
+{
+	return nodes.size();
+}
+
+uint32_t Archetype::add(Node& node, const std::vector<std::pair<TypeId, Component*>>& components)
+{
+	nodes.push_back(&node);
+	for (size_t column = 0; column < columns.size(); column++)
+		columns[column].push_back(components[column].second);
+
+	return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void Archetype::set(uint32_t row, const std::vector<std::pair<TypeId, Component*>>& components)
+{
+	for (size_t column = 0; column < columns.size(); column++)
+		columns[column][row] = components[column].second;
+}
+
+Node* Archetype::remove(uint32_t row)
+{
+	size_t last = nodes.size() - 1;
+
+	nodes[row] = nodes[last];
+	nodes.pop_back();
+	for (auto& column : columns) {
+		column[row] = column[last];
+		column.pop_back();
+	}
+
+	return row < last ? nodes[row] : nullptr;
+}
+
+Archetype& ArchetypeStorage::findArchetype(const std::vector<std::pair<TypeId, Component*>>& components)
+{
+	std::vector<TypeId> types;
+	types.reserve(components.size());
+	for (const auto& [type, component] : components)
+		types.push_back(type);
+
+	auto it = archetype_by_types.find(types);
+	if (it != archetype_by_types.end())
+		return *it->second;
+
+	auto& archetype = archetypes.emplace_back(std::make_unique<Archetype>(types));
+	archetype_by_types.emplace(std::move(types), archetype.get());
+
+	return *archetype;
+}
+
+void ArchetypeStorage::insert(Node& node)
+{
+	auto& archetype = findArchetype(node.components);
+
+	node.archetype = &archetype;
+	node.archetype_row = archetype.add(node, node.components);
+	generation++;
+}
+
+void ArchetypeStorage::remove(Node& node)
+{
+	if (!node.archetype)
+		return;
+
+	if (auto* moved = node.archetype->remove(node.archetype_row))
+		moved->archetype_row = node.archetype_row;
+
+	node.archetype = nullptr;
+	node.archetype_row = 0;
+	generation++;
+}
+
+void ArchetypeStorage::update(Node& node)
+{
+	// Replacing a component of a type the node already has keeps it in its table
+	if (node.archetype && node.archetype->getTypes().size() == node.components.size()
+	    && std::equal(node.components.begin(), node.components.end(), node.archetype->getTypes().begin(),
+	        [](const auto& component, const auto& type) { return component.first == type; })) {
+		node.archetype->set(node.archetype_row, node.components);
+		generation++;
+		return;
+	}
+
+	remove(node);
+	insert(node);
+}
+
+const std::vector<std::unique_ptr<Archetype>>& ArchetypeStorage::getArchetypes() const
+{
+	return archetypes;
+}
+
+uint64_t ArchetypeStorage::getGeneration() const
+{
+	return generation;
+}
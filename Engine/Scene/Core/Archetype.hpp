@@ -0,0 +1,108 @@
+#pragma once
+
+#include <map>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "Component.hpp"
+#include "Core/Type/TypeId.hpp"
+
+class Node;
+
+template <typename T>
+concept IsComponent = std::is_base_of<Component, T>::value;
+
+// Every node of a scene carrying exactly the same set of component types. Rows are nodes, each column holds the
+// components of one type in row order, so a system walks plain arrays instead of looking components up per node
+class Archetype {
+private:
+	std::vector<TypeId>                  types;
+	std::vector<Node*>                   nodes;
+	std::vector<std::vector<Component*>> columns;
+
+public:
+	// Types must be sorted, the node keeps its components in the same order
+	Archetype(std::vector<TypeId> types);
+
+	auto getTypes() const -> const std::vector<TypeId>&;
+	auto getNodes() const -> const std::vector<Node*>&;
+	auto getColumn(size_t column) const -> const std::vector<Component*>&;
+	// Column of the type or -1, types are few and sorted
+	auto findColumn(TypeId type) const -> int32_t;
+
+	size_t size() const;
+
+	uint32_t add(Node& node, const std::vector<std::pair<TypeId, Component*>>& components);
+	void     set(uint32_t row, const std::vector<std::pair<TypeId, Component*>>& components);
+	// Swap-removes the row, returns the node moved into it or null when it was the last one
+	Node* remove(uint32_t row);
+};
+
+// Archetype tables of one scene. Nodes join when they enter the scene and move between tables when their set of
+// component types changes, the components themselves stay owned by the scene
+class ArchetypeStorage {
+private:
+	std::vector<std::unique_ptr<Archetype>>   archetypes;
+	std::map<std::vector<TypeId>, Archetype*> archetype_by_types;
+	uint64_t                                  generation{0};
+
+	auto findArchetype(const std::vector<std::pair<TypeId, Component*>>& components) -> Archetype&;
+
+	template <IsComponent... T, typename F, size_t... I>
+	static void eachRow(const Archetype& archetype, const std::array<int32_t, sizeof...(T)>& columns, F& function, std::index_sequence<I...>);
+
+public:
+	ArchetypeStorage() = default;
+	~ArchetypeStorage() = default;
+
+	ArchetypeStorage(const ArchetypeStorage&) = delete;
+	ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+	ArchetypeStorage(ArchetypeStorage&&) noexcept = delete;
+	ArchetypeStorage& operator=(ArchetypeStorage&&) noexcept = delete;
+
+	void insert(Node& node);
+	void remove(Node& node);
+	// The components of the node changed, it moves to the table of its new set or rewrites its row
+	void update(Node& node);
+
+	auto getArchetypes() const -> const std::vector<std::unique_ptr<Archetype>>&;
+	// Changes whenever a node joins, leaves or changes its components
+	uint64_t getGeneration() const;
+
+	// Calls function(Node&, T&...) for every node carrying all of the types, table by table in row order
+	template <IsComponent... T, typename F>
+	void each(F&& function) const;
+};
+
+template <IsComponent... T, typename F, size_t... I>
+void ArchetypeStorage::eachRow(const Archetype& archetype, const std::array<int32_t, sizeof...(T)>& columns, F& function, std::index_sequence<I...>)
+{
+	const auto& nodes = archetype.getNodes();
+	const std::array<const std::vector<Component*>*, sizeof...(T)> arrays{&archetype.getColumn(columns[I])...};
+
+	// Columns are keyed by the exact type the component was set with, so the cast needs no runtime check
+	for (size_t row = 0; row < nodes.size(); row++)
+		function(*nodes[row], static_cast<T&>(*(*arrays[I])[row])...);
+}
+
+template <IsComponent... T, typename F>
+void ArchetypeStorage::each(F&& function) const
+{
+	constexpr std::array<TypeId, sizeof...(T)> types{getTypeId<T>()...};
+
+	for (const auto& archetype : archetypes) {
+		std::array<int32_t, sizeof...(T)> columns{};
+		bool                              matches = archetype->size() > 0;
+		for (size_t index = 0; matches && index < types.size(); index++) {
+			columns[index] = archetype->findColumn(types[index]);
+			matches = columns[index] >= 0;
+		}
+
+		if (matches)
+			eachRow<T...>(*archetype, columns, function, std::index_sequence_for<T...>{});
+	}
+}
@@ -0,0 +1,64 @@
+#include "ChangeJournal.hpp"
+
+#include <algorithm>
+
+void ChangeJournal::recordTransform(uint32_t slot)
+{
+	if (slot >= recorded_transforms.size())
+		recorded_transforms.resize(slot + 1, 0);
+
+	if (recorded_transforms[slot])
+		return;
+
+	recorded_transforms[slot] = 1;
+	transforms.push_back(slot);
+}
+
+// Few materials and lights change per frame, a linear search keeps the lists unique
+void ChangeJournal::recordMaterial(Material& material)
+{
+	if (std::find(materials.begin(), materials.end(), &material) == materials.end())
+		materials.push_back(&material);
+}
+
+void ChangeJournal::recordLight(Light& light)
+{
+	if (std::find(lights.begin(), lights.end(), &light) == lights.end())
+		lights.push_back(&light);
+}
+
+void ChangeJournal::resetTransforms(size_t slot_count)
+{
+	transforms.clear();
+	recorded_transforms.assign(slot_count, 0);
+}
+
+void ChangeJournal::clear()
+{
+	for (auto slot : transforms)
+		recorded_transforms[slot] = 0;
+
+	transforms.clear();
+	materials.clear();
+	lights.clear();
+}
+
+bool ChangeJournal::empty() const
+{
+	return transforms.empty() && materials.empty() && lights.empty();
+}
+
+const std::vector<uint32_t>& ChangeJournal::getTransforms() const
+{
+	return transforms;
+}
+
+const std::vector<Material*>& ChangeJournal::getMaterials() const
+{
+	return materials;
+}
+
+const std::vector<Light*>& ChangeJournal::getLights() const
+{
+	return lights;
+}
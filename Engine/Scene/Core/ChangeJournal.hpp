@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+class Light;
+class Material;
+
+// What changed in a scene since the last consumer cleared it: transform store slots whose world matrix was recomputed,
+// materials and lights whose values were set. Each entry is listed once, pointers are only meant to be compared since
+// the object may be gone by the time the journal is read
+class ChangeJournal {
+private:
+	std::vector<uint32_t>  transforms;
+	std::vector<uint8_t>   recorded_transforms;
+	std::vector<Material*> materials;
+	std::vector<Light*>    lights;
+
+public:
+	ChangeJournal() = default;
+	~ChangeJournal() = default;
+
+	ChangeJournal(const ChangeJournal&) = delete;
+	ChangeJournal& operator=(const ChangeJournal&) = delete;
+
+	ChangeJournal(ChangeJournal&&) noexcept = delete;
+	ChangeJournal& operator=(ChangeJournal&&) noexcept = delete;
+
+	void recordTransform(uint32_t slot);
+	void recordMaterial(Material& material);
+	void recordLight(Light& light);
+
+	// Slots were renumbered, recorded ones no longer name the same nodes
+	void resetTransforms(size_t slot_count);
+	void clear();
+	bool empty() const;
+
+	auto getTransforms() const -> const std::vector<uint32_t>&;
+	auto getMaterials() const -> const std::vector<Material*>&;
+	auto getLights() const -> const std::vector<Light*>&;
+};
@@ -1,5 +1,10 @@
 #include "Node.hpp"
 
+#include <format>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
 #include "Scene.hpp"
 
 Node::Node(std::string name) :
@@ -9,6 +14,12 @@ Node::Node(std::string name) :
 	setComponent<Transform>(transform);
 }
 
+Node::~Node()
+{
+	if (scene)
+		scene->unregisterNode(*this);
+}
+
 std::type_index Node::getType()
 {
 	return typeid(Node);
@@ -21,7 +32,12 @@ const std::string& Node::getName() const
 
 void Node::setName(const std::string& name)
 {
-	this->name = name;
+	if (this->name == name)
+		return;
+
+	auto previous_name = std::exchange(this->name, name);
+	if (scene)
+		scene->renameNode(*this, previous_name);
 }
 
 Node* Node::getParent() const
@@ -41,7 +57,13 @@ Scene* Node::getScene() const
 
 void Node::setScene(Scene& scene)
 {
+	if (this->scene == &scene)
+		return;
+
+	if (this->scene)
+		this->scene->unregisterNode(*this);
 	this->scene = &scene;
+	scene.registerNode(*this);
 }
 
 World* Node::getWorld() const
@@ -49,20 +71,56 @@ World* Node::getWorld() const
 	return scene ? scene->getWorld() : world;
 }
 
-Component& Node::getComponent(const std::type_index& type) const
+bool Node::isStatic() const
 {
-	return *components.at(type);
+	return is_static;
 }
 
-void Node::setComponent(const std::type_index& type, Component& component)
+void Node::setStatic(bool is_static)
+{
+	if (this->is_static == is_static)
+		return;
+
+	this->is_static = is_static;
+	if (scene)
+		scene->getTransforms().invalidateHierarchy();
+}
+
+Component& Node::getComponent(TypeId type) const
+{
+	for (const auto& [component_type, component] : components)
+		if (component_type == type)
+			return *component;
+
+	throw std::out_of_range(std::format("Node {} has no component of type {:#x}", name, type));
+}
+
+// The component always learns its node here, so systems resolve component to node without searching
+void Node::setComponent(TypeId type, Component& component)
 {
-	components[type] = &component;
 	component.setNode(*this);
+
+	auto it = std::lower_bound(components.begin(), components.end(), type,
+	    [](const auto& entry, const TypeId& key) { return entry.first < key; });
+
+	if (it != components.end() && it->first == type)
+		it->second = &component;
+	else
+		components.insert(it, {type, &component});
+
+	if (scene)
+		scene->getArchetypes().update(*this);
 }
 
-bool Node::hasComponent(const std::type_index& type) const
+bool Node::hasComponent(TypeId type) const
 {
-	return components.count(type) > 0;
+	return std::any_of(components.begin(), components.end(),
+	    [&type](const auto& entry) { return entry.first == type; });
+}
+
+size_t Node::getComponentCount() const
+{
+	return components.size();
 }
 
 void Node::addBehaviour(Behaviour& behaviour)
@@ -79,6 +137,11 @@ void Node::removeBehaviour(Behaviour& behaviour)
 	    behaviours.end());
 }
 
+const std::vector<Behaviour*>& Node::getBehaviours() const
+{
+	return behaviours;
+}
+
 const std::vector<Node*>& Node::getChildren() const
 {
 	return children;
@@ -87,6 +150,25 @@ const std::vector<Node*>& Node::getChildren() const
 void Node::addChild(Node& child)
 {
 	child.parent = this;
-	child.transform.invalidateWorldMatrix();
 	children.push_back(&child);
+
+	// The rebuild recomputes every slot, a baked child is moved without being marked as moving
+	if (scene)
+		scene->getTransforms().invalidateHierarchy();
+	else
+		child.transform.invalidateWorldMatrix();
+}
+
+void Node::removeChild(Node& child)
+{
+	if (child.parent != this)
+		return;
+
+	std::erase(children, &child);
+	child.parent = nullptr;
+
+	if (scene)
+		scene->getTransforms().invalidateHierarchy();
+	else
+		child.transform.invalidateWorldMatrix();
 }
@@ -2,8 +2,8 @@
 
 #include <string>
 #include <vector>
-#include <unordered_map>
 
+#include "Archetype.hpp"
 #include "Component.hpp"
 #include "Behaviour.hpp"
 #include "Scene/Components/Transform.hpp"
@@ -11,9 +11,6 @@
 class Scene;
 class World;
 
-template <typename T>
-concept IsComponent = std::is_base_of<Component, T>::value;
-
 template <typename T>
 concept IsBehaviour = std::is_base_of<Behaviour, T>::value;
 
@@ -26,14 +23,25 @@ private:
 	Scene* scene{};
 	World* world{};
 
+	// Never moves once loaded, see TransformStore
+	bool is_static{false};
+
 	std::vector<Node*> children;
 
-	std::unordered_map<std::type_index, Component*> components;
-	std::vector<Behaviour*>                         behaviours;
+	// Sorted by type, a node carries a handful of components and this doubles as the key of its archetype
+	std::vector<std::pair<TypeId, Component*>> components;
+	std::vector<Behaviour*>                    behaviours;
+
+	Archetype* archetype{};
+	uint32_t   archetype_row{};
+	int32_t    spatial_proxy{-1};
+
+	friend class ArchetypeStorage;
+	friend class SpatialIndex;
 
 public:
 	Node(std::string name);
-	~Node() override = default;
+	~Node() override;
 
 	Node(const Node&) = delete;
 	Node& operator=(Node&) = delete;
@@ -56,17 +64,21 @@ public:
 
 	World* getWorld() const;
 
+	bool isStatic() const;
+	void setStatic(bool is_static);
+
 	template <IsComponent T>
 	T&         getComponent() const;
-	Component& getComponent(const std::type_index& type) const;
+	Component& getComponent(TypeId type) const;
 
 	template <IsComponent T>
 	void setComponent(T& component);
-	void setComponent(const std::type_index& type, Component& component);
+	void setComponent(TypeId type, Component& component);
 
 	template <IsComponent T>
-	bool hasComponent() const;
-	bool hasComponent(const std::type_index& type) const;
+	bool   hasComponent() const;
+	bool   hasComponent(TypeId type) const;
+	size_t getComponentCount() const;
 
 	template <IsBehaviour T>
 	T* getBehaviour() const;
@@ -78,24 +90,26 @@ public:
 
 	const std::vector<Node*>& getChildren() const;
 	void                      addChild(Node& child);
+	void                      removeChild(Node& child);
 };
 
 template <IsComponent T>
 T& Node::getComponent() const
 {
-	return dynamic_cast<T&>(getComponent(typeid(T)));
+	// Stored under exactly this type, no runtime check needed
+	return static_cast<T&>(getComponent(getTypeId<T>()));
 }
 
 template <IsComponent T>
 void Node::setComponent(T& component)
 {
-	components[typeid(T)] = &component;
+	setComponent(getTypeId<T>(), component);
 }
 
 template <IsComponent T>
 inline bool Node::hasComponent() const
 {
-	return hasComponent(typeid(T));
+	return hasComponent(getTypeId<T>());
 }
 
 template <IsBehaviour T>
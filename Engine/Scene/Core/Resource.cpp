@@ -8,3 +8,32 @@ const std::string& Resource::getName() const
 {
 	return name;
 }
+
+bool Resource::isResident() const
+{
+	return true;
+}
+
+void Resource::release()
+{}
+
+bool Resource::reload()
+{
+	if (isResident())
+		return true;
+	if (!reloader)
+		return false;
+
+	reloader(*this);
+	return isResident();
+}
+
+bool Resource::canReload() const
+{
+	return static_cast<bool>(reloader);
+}
+
+void Resource::setReloader(std::function<void(Resource&)> new_reloader)
+{
+	reloader = std::move(new_reloader);
+}
@@ -3,11 +3,14 @@
 #include "Entity.hpp"
 
 #include <string>
+#include <functional>
 
 class Resource : public Entity {
 private:
 	std::string name;
 
+	std::function<void(Resource&)> reloader;
+
 public:
 	Resource() = default;
 	Resource(std::string name);
@@ -15,4 +18,13 @@ public:
 
 	auto getName() const -> const std::string&;
 	void setName(const std::string& name);
+
+	// Whether the CPU copy of the data is in memory, release drops it and keeps the metadata (sizes, bounds, mips)
+	virtual bool isResident() const;
+	virtual void release();
+
+	// Restores released data through the reloader the loader installed, false when there is none
+	bool reload();
+	bool canReload() const;
+	void setReloader(std::function<void(Resource&)> new_reloader);
 };
@@ -1,6 +1,14 @@
 #include "Scene.hpp"
 
-#include <queue>
+#include <cmath>
+#include <unordered_set>
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include "Scene/Resources/Material.hpp"
+
+// Largest difference a folded child matrix may show against the product it replaces
+constexpr float COLLAPSE_TOLERANCE = 1e-4f;
 
 Scene::Scene(std::string name) :
     name(std::move(name))
@@ -9,7 +17,18 @@ Scene::Scene(std::string name) :
 Scene::Scene(const std::string& name) :
     root(new Node(name)),
     name(name)
-{}
+{
+	transforms->setRoot(root);
+}
+
+// Shared resources can outlive the scene, they must not keep writing into its journal
+Scene::~Scene()
+{
+	for (auto& [type, resource_list] : resources)
+		for (auto& resource : resource_list)
+			if (resource)
+				unwatchResource(type, *resource);
+}
 
 std::type_index Scene::getType()
 {
@@ -33,12 +52,14 @@ void Scene::setNodes(std::vector<std::unique_ptr<Node>>&& nodes)
 	for (auto& node : nodes)
 		node->setScene(*this);
 	this->nodes = std::move(nodes);
+	transforms->invalidateHierarchy();
 }
 
 void Scene::addNode(std::unique_ptr<Node>&& node)
 {
 	node->setScene(*this);
 	nodes.push_back(std::move(node));
+	transforms->invalidateHierarchy();
 }
 
 World* Scene::getWorld() const
@@ -59,6 +80,7 @@ Node* Scene::getRoot()
 void Scene::setRoot(Node& node)
 {
 	this->root = &node;
+	transforms->setRoot(root);
 }
 
 void Scene::addChild(Node& child)
@@ -66,68 +88,139 @@ void Scene::addChild(Node& child)
 	root->addChild(child);
 }
 
-auto Scene::getComponents(const std::type_index& type) const -> const std::vector<std::unique_ptr<Component>>&
+TransformStore& Scene::getTransforms() const
 {
-	return components.at(type);
+	return *transforms;
 }
 
-void Scene::setComponents(const std::type_index& type, std::vector<std::unique_ptr<Component>>&& components)
+ChangeJournal& Scene::getJournal() const
 {
-	this->components[type] = std::move(components);
+	return *journal;
 }
 
-void Scene::removeComponent(Component& component)
+ArchetypeStorage& Scene::getArchetypes() const
 {
-	auto it = components.find(component.getType());
+	return *archetypes;
+}
+
+auto Scene::getComponents(TypeId type) const -> std::span<const std::unique_ptr<Component>>
+{
+	auto it = components.find(type);
 	if (it == components.end())
-		return;
+		return {};
+
+	return it->second;
+}
 
-	auto& component_list = it->second;
-	component_list.erase(std::remove_if(component_list.begin(), component_list.end(),
-	                         [&component](const std::unique_ptr<Component>& c) {
-		                         return c.get() == &component;
-	                         }),
-	    component_list.end());
+void Scene::setComponents(TypeId type, std::vector<std::unique_ptr<Component>>&& components)
+{
+	if (components.empty())
+		this->components.erase(type);
+	else
+		this->components[type] = std::move(components);
+	bumpGeneration(type);
+}
 
-	if (component_list.empty())
-		components.erase(it);
+// Components of a derived type live in the bucket of the type they were added as, so every bucket is searched
+void Scene::removeComponent(Component& component)
+{
+	for (auto it = components.begin(); it != components.end(); ++it) {
+		auto& component_list = it->second;
+		auto  found = std::find_if(component_list.begin(), component_list.end(),
+		    [&component](const std::unique_ptr<Component>& c) { return c.get() == &component; });
+		if (found == component_list.end())
+			continue;
+
+		auto type = it->first;
+		component_list.erase(found);
+		if (component_list.empty())
+			components.erase(it);
+		bumpGeneration(type);
+		return;
+	}
 }
 
-bool Scene::hasComponent(const std::type_index& type) const
+bool Scene::hasComponent(TypeId type) const
 {
 	return components.count(type) > 0;
 }
 
-auto Scene::getResources(const std::type_index& type) const -> const std::vector<std::shared_ptr<Resource>>&
+auto Scene::getResources(TypeId type) const -> std::span<const std::shared_ptr<Resource>>
 {
-	return resources.at(type);
+	auto it = resources.find(type);
+	if (it == resources.end())
+		return {};
+
+	return it->second;
 }
 
-void Scene::setResources(const std::type_index& type, std::vector<std::shared_ptr<Resource>>&& resources)
+void Scene::setResources(TypeId type, std::vector<std::shared_ptr<Resource>>&& resources)
 {
-	this->resources[type] = std::move(resources);
+	if (auto it = this->resources.find(type); it != this->resources.end())
+		for (auto& resource : it->second)
+			if (resource)
+				unwatchResource(type, *resource);
+	for (auto& resource : resources)
+		if (resource)
+			watchResource(type, *resource);
+
+	if (resources.empty())
+		this->resources.erase(type);
+	else
+		this->resources[type] = std::move(resources);
+	bumpGeneration(type);
 }
 
 void Scene::removeResource(Resource& resource)
 {
-	auto it = resources.find(resource.getType());
-	if (it == resources.end())
+	for (auto it = resources.begin(); it != resources.end(); ++it) {
+		auto& resource_list = it->second;
+		auto  found = std::find_if(resource_list.begin(), resource_list.end(),
+		    [&resource](const std::shared_ptr<Resource>& r) { return r.get() == &resource; });
+		if (found == resource_list.end())
+			continue;
+
+		auto type = it->first;
+		unwatchResource(type, resource);
+		resource_list.erase(found);
+		if (resource_list.empty())
+			resources.erase(it);
+		bumpGeneration(type);
 		return;
+	}
+}
 
-	auto& resource_list = it->second;
-	resource_list.erase(std::remove_if(resource_list.begin(), resource_list.end(),
-	                        [&resource](const std::shared_ptr<Resource>& r) {
-		                        return r.get() == &resource;
-	                        }),
-	    resource_list.end());
+bool Scene::hasResource(TypeId type) const
+{
+	return resources.count(type) > 0;
+}
 
-	if (resource_list.empty())
-		resources.erase(it);
+uint64_t Scene::getGeneration(TypeId type) const
+{
+	auto it = generations.find(type);
+	return it != generations.end() ? it->second : 0;
 }
 
-bool Scene::hasResource(const std::type_index& type) const
+void Scene::bumpGeneration(TypeId type)
 {
-	return resources.count(type) > 0;
+	++generations[type];
+}
+
+// Materials are the only resources edited after load, their setters report to the journal of the scene holding them
+void Scene::watchResource(TypeId type, Resource& resource)
+{
+	if (type == getTypeId<Material>())
+		static_cast<Material&>(resource).setJournal(journal.get());
+}
+
+void Scene::unwatchResource(TypeId type, Resource& resource)
+{
+	if (type != getTypeId<Material>())
+		return;
+
+	auto& material = static_cast<Material&>(resource);
+	if (material.getJournal() == journal.get())
+		material.setJournal(nullptr);
 }
 
 auto Scene::getBehaviours() const -> const std::vector<std::unique_ptr<Behaviour>>&
@@ -166,23 +259,170 @@ void Scene::refreshBehaviours()
 		tickable_behaviours.push_back(behaviour.get());
 }
 
-Node* Scene::findNode(const std::string& name)
+Node* Scene::findNode(const std::string& name) const
+{
+	auto it = nodes_by_name.find(name);
+	return it != nodes_by_name.end() ? it->second.front() : nullptr;
+}
+
+Node* Scene::findNode(uint64_t uid) const
+{
+	auto it = node_by_uid.find(uid);
+	return it != node_by_uid.end() ? it->second : nullptr;
+}
+
+auto Scene::findNodes(const std::string& name) const -> std::span<Node* const>
+{
+	auto it = nodes_by_name.find(name);
+	if (it == nodes_by_name.end())
+		return {};
+
+	return it->second;
+}
+
+auto Scene::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) -> std::optional<RaycastHit>
+{
+	spatial->update();
+	return spatial->raycast(origin, direction, max_distance);
+}
+
+void Scene::overlapBox(const Aabb& bounds, std::vector<Node*>& result)
+{
+	spatial->update();
+	spatial->overlapBox(bounds, result);
+}
+
+void Scene::overlapSphere(const glm::vec3& center, float radius, std::vector<Node*>& result)
+{
+	spatial->update();
+	spatial->overlapSphere(center, radius, result);
+}
+
+void Scene::findNearest(const glm::vec3& point, size_t count, std::vector<Node*>& result)
+{
+	spatial->update();
+	spatial->findNearest(point, count, result);
+}
+
+SpatialIndex& Scene::getSpatialIndex() const
+{
+	return *spatial;
+}
+
+void Scene::registerNode(Node& node)
 {
-	for (auto* node : root->getChildren()) {
-		std::queue<Node*> traverse_node;
-		traverse_node.push(node);
+	archetypes->insert(node);
+	nodes_by_name[node.getName()].push_back(&node);
+	node_by_uid[node.getUid()] = &node;
+}
 
-		while (!traverse_node.empty()) {
-			auto* node = traverse_node.front();
-			traverse_node.pop();
-			if (node->getName() == name)
-				return node;
+void Scene::unregisterNode(Node& node)
+{
+	archetypes->remove(node);
+	spatial->remove(node);
+	node_by_uid.erase(node.getUid());
+
+	if (auto it = nodes_by_name.find(node.getName()); it != nodes_by_name.end()) {
+		std::erase(it->second, &node);
+		if (it->second.empty())
+			nodes_by_name.erase(it);
+	}
+}
+
+void Scene::renameNode(Node& node, const std::string& previous_name)
+{
+	if (auto it = nodes_by_name.find(previous_name); it != nodes_by_name.end()) {
+		std::erase(it->second, &node);
+		if (it->second.empty())
+			nodes_by_name.erase(it);
+	}
+
+	nodes_by_name[node.getName()].push_back(&node);
+}
 
-			for (auto* child_node : node->getChildren())
-				traverse_node.push(child_node);
+size_t Scene::collapseStaticHierarchy()
+{
+	if (!root)
+		return 0;
+
+	std::unordered_set<Node*> owned;
+	for (auto& node : nodes)
+		owned.insert(node.get());
+
+	// Children before their parents, so a chain of grouping nodes folds one link at a time
+	std::vector<Node*> post_order;
+	std::vector<std::pair<Node*, size_t>> stack{{root, 0}};
+	while (!stack.empty()) {
+		auto& [node, next_child] = stack.back();
+		if (next_child < node->getChildren().size()) {
+			auto* child = node->getChildren()[next_child++];
+			stack.emplace_back(child, 0);
+			continue;
+		}
+		post_order.push_back(node);
+		stack.pop_back();
+	}
+
+	std::unordered_set<Node*> removed;
+	for (auto* node : post_order) {
+		auto* parent = node->getParent();
+		if (!parent || node->getChildren().empty() || !node->isStatic() || !parent->isStatic() || !owned.contains(node)
+		    || node->getComponentCount() > 1 || !node->getBehaviours().empty())
+			continue;
+
+		// Every child must keep its world matrix as a plain translation, rotation and scaling
+		struct Folded {
+			Node*     child;
+			glm::vec3 translation;
+			glm::quat rotation;
+			glm::vec3 scaling;
+		};
+		std::vector<Folded> folded;
+		auto                local = node->getTransform().getMatrix();
+		for (auto* child : node->getChildren()) {
+			auto      combined = local * child->getTransform().getMatrix();
+			Folded    result{child};
+			glm::vec3 skew;
+			glm::vec4 perspective;
+			if (!child->isStatic() || !glm::decompose(combined, result.scaling, result.rotation, result.translation, skew, perspective))
+				break;
+
+			auto  recomposed = TransformStore::compose(result.translation, result.rotation, result.scaling);
+			float difference = 0.0f;
+			for (int column = 0; column < 4; column++)
+				for (int row = 0; row < 4; row++)
+					difference = std::max(difference, std::abs(recomposed[column][row] - combined[column][row]));
+			if (difference > COLLAPSE_TOLERANCE)
+				break;
+
+			folded.push_back(result);
+		}
+		if (folded.size() != node->getChildren().size())
+			continue;
+
+		for (auto& [child, translation, rotation, scaling] : folded) {
+			node->removeChild(*child);
+			parent->addChild(*child);
+
+			// Writing into a baked slot marks the child as moving, it is static again once folded
+			auto& transform = child->getTransform();
+			transform.setTranslation(translation);
+			transform.setRotation(rotation);
+			transform.setScaling(scaling);
+			child->setStatic(true);
 		}
+		parent->removeChild(*node);
+		removed.insert(node);
 	}
-	return nullptr;
+
+	if (removed.empty())
+		return 0;
+
+	// The store drops the removed nodes before they are destroyed
+	transforms->update();
+	std::erase_if(nodes, [&removed](const std::unique_ptr<Node>& node) { return removed.contains(node.get()); });
+
+	return removed.size();
 }
 
 void Scene::start()
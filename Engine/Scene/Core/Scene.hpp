@@ -3,12 +3,16 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <typeindex>
 #include <algorithm>
 
 #include "Node.hpp"
 #include "Component.hpp"
 #include "Resource.hpp"
+#include "TypedView.hpp"
+#include "Archetype.hpp"
+#include "SpatialIndex.hpp"
+#include "ChangeJournal.hpp"
+#include "TransformStore.hpp"
 
 template <typename T>
 concept IsResource = std::is_base_of<Resource, T>::value;
@@ -20,25 +24,47 @@ private:
 	Node*  root{};
 	World* world{};
 
-	std::vector<std::unique_ptr<Node>> nodes;
+	std::unique_ptr<ChangeJournal> journal{std::make_unique<ChangeJournal>()};
 
-	std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> components;
-	std::unordered_map<std::type_index, std::vector<std::shared_ptr<Resource>>>  resources;
+	// Declared before the nodes so they can leave their tables, the lookup maps and the spatial index when destroyed
+	std::unique_ptr<ArchetypeStorage>                   archetypes{std::make_unique<ArchetypeStorage>()};
+	std::unordered_map<std::string, std::vector<Node*>> nodes_by_name;
+	std::unordered_map<uint64_t, Node*>                 node_by_uid;
+	std::unique_ptr<SpatialIndex>                       spatial{std::make_unique<SpatialIndex>(*this)};
+	std::vector<std::unique_ptr<Node>>                  nodes;
+	// Declared after the nodes so it is destroyed first and can hand the values back to them
+	std::unique_ptr<TransformStore> transforms{std::make_unique<TransformStore>(journal.get())};
+
+	std::unordered_map<TypeId, std::vector<std::unique_ptr<Component>>> components;
+	std::unordered_map<TypeId, std::vector<std::shared_ptr<Resource>>>  resources;
+	// Bumped whenever the bucket of a type changes, kept when the bucket is erased
+	std::unordered_map<TypeId, uint64_t> generations;
 
 	std::vector<std::unique_ptr<Behaviour>> behaviours;
 	std::vector<Behaviour*>                 tickable_behaviours;
 
+	friend class Node;
+
+	// Called by nodes entering or leaving the scene and on rename
+	void registerNode(Node& node);
+	void unregisterNode(Node& node);
+	void renameNode(Node& node, const std::string& previous_name);
+
+	void watchResource(TypeId type, Resource& resource);
+	void unwatchResource(TypeId type, Resource& resource);
+	void bumpGeneration(TypeId type);
+
 public:
 	Scene() = default;
 	Scene(std::string name);
 	Scene(const std::string& name);
-	~Scene() override = default;
+	~Scene() override;
 
 	Scene(const Scene&) = delete;
 	Scene& operator=(const Scene&) = delete;
 
-	Scene(Scene&&) noexcept = default;
-	Scene& operator=(Scene&&) noexcept = default;
+	Scene(Scene&&) noexcept = delete;
+	Scene& operator=(Scene&&) noexcept = delete;
 
 	std::type_index getType() override;
 
@@ -55,13 +81,21 @@ public:
 	void  setRoot(Node& node);
 	void  addChild(Node& child);
 
+	auto getTransforms() const -> TransformStore&;
+	auto getJournal() const -> ChangeJournal&;
+	auto getArchetypes() const -> ArchetypeStorage&;
+
+	// Calls function(Node&, T&...) for every node of the scene carrying all of the component types
+	template <IsComponent... T, typename F>
+	void each(F&& function) const;
+
 	template <IsComponent T>
-	auto getComponents() const -> std::vector<T*>;
-	auto getComponents(const std::type_index& type) const -> const std::vector<std::unique_ptr<Component>>&;
+	auto getComponents() const -> ComponentView<T>;
+	auto getComponents(TypeId type) const -> std::span<const std::unique_ptr<Component>>;
 
 	template <IsComponent T>
 	void setComponents(std::vector<std::unique_ptr<T>>&& components);
-	void setComponents(const std::type_index& type, std::vector<std::unique_ptr<Component>>&& components);
+	void setComponents(TypeId type, std::vector<std::unique_ptr<Component>>&& components);
 
 	template <IsComponent T>
 	void addComponent(std::unique_ptr<T>&& component);
@@ -74,15 +108,15 @@ public:
 
 	template <IsComponent T>
 	bool hasComponent() const;
-	bool hasComponent(const std::type_index& type) const;
+	bool hasComponent(TypeId type) const;
 
 	template <IsResource T>
-	auto getResources() const -> std::vector<std::shared_ptr<T>>;
-	auto getResources(const std::type_index& type) const -> const std::vector<std::shared_ptr<Resource>>&;
+	auto getResources() const -> ResourceView<T>;
+	auto getResources(TypeId type) const -> std::span<const std::shared_ptr<Resource>>;
 
 	template <IsResource T>
 	void setResources(std::vector<std::shared_ptr<T>>&& resources);
-	void setResources(const std::type_index& type, std::vector<std::shared_ptr<Resource>>&& resources);
+	void setResources(TypeId type, std::vector<std::shared_ptr<Resource>>&& resources);
 
 	template <IsResource T>
 	void addResource(std::shared_ptr<T> resource);
@@ -93,7 +127,12 @@ public:
 
 	template <IsResource T>
 	bool hasResource() const;
-	bool hasResource(const std::type_index& type) const;
+	bool hasResource(TypeId type) const;
+
+	// Changes whenever components or resources stored under the type are set, added or removed
+	template <typename T>
+	uint64_t getGeneration() const;
+	uint64_t getGeneration(TypeId type) const;
 
 	template <IsBehaviour T>
 	auto getBehaviour() const -> T*;
@@ -105,24 +144,36 @@ public:
 	void removeBehaviour(Behaviour& behaviour);
 	void refreshBehaviours();
 
-	Node* findNode(const std::string& name);
+	// Hash lookups maintained as nodes enter and leave the scene, the first node given a name wins
+	Node* findNode(const std::string& name) const;
+	Node* findNode(uint64_t uid) const;
+	auto  findNodes(const std::string& name) const -> std::span<Node* const>;
+
+	// Queries against the world bounds of nodes carrying a mesh, the spatial index catches up with the scene first
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) -> std::optional<RaycastHit>;
+	void overlapBox(const Aabb& bounds, std::vector<Node*>& result);
+	void overlapSphere(const glm::vec3& center, float radius, std::vector<Node*>& result);
+	void findNearest(const glm::vec3& point, size_t count, std::vector<Node*>& result);
+	auto getSpatialIndex() const -> SpatialIndex&;
+
+	// Removes static nodes that only group static children, folding their local transform into each child. Returns the
+	// number of nodes removed, their names no longer resolve
+	size_t collapseStaticHierarchy();
 
 	void start();
 	void update(float dt);
 };
 
+template <IsComponent... T, typename F>
+void Scene::each(F&& function) const
+{
+	archetypes->each<T...>(std::forward<F>(function));
+}
+
 template <IsComponent T>
-auto Scene::getComponents() const -> std::vector<T*>
+auto Scene::getComponents() const -> ComponentView<T>
 {
-	std::vector<T*> result;
-	if (hasComponent(typeid(T))) {
-		auto& scene_components = getComponents(typeid(T));
-		result.resize(scene_components.size());
-		std::transform(
-		    scene_components.begin(), scene_components.end(), result.begin(),
-		    [](auto& component) { return dynamic_cast<T*>(component.get()); });
-	}
-	return result;
+	return ComponentView<T>(getComponents(getTypeId<T>()));
 }
 
 template <IsComponent T>
@@ -130,49 +181,41 @@ void Scene::setComponents(std::vector<std::unique_ptr<T>>&& components)
 {
 	std::vector<std::unique_ptr<Component>> result(components.size());
 	std::move(components.begin(), components.end(), result.begin());
-	setComponents(typeid(T), std::move(result));
+	setComponents(getTypeId<T>(), std::move(result));
 }
 
 template <IsComponent T>
 void Scene::addComponent(std::unique_ptr<T>&& component)
 {
-	if (component)
-		components[typeid(T)].push_back(std::move(component));
+	if (component) {
+		components[getTypeId<T>()].push_back(std::move(component));
+		bumpGeneration(getTypeId<T>());
+	}
 }
 
 template <IsComponent T>
 void Scene::addComponent(std::unique_ptr<T>&& component, Node& node)
 {
 	node.setComponent(*component);
-	if (component)
-		components[typeid(T)].push_back(std::move(component));
+	addComponent(std::move(component));
 }
 
 template <IsComponent T>
 void Scene::clearComponents()
 {
-	setComponents<T>(typeid(T), {});
+	setComponents(getTypeId<T>(), {});
 }
 
 template <IsComponent T>
 bool Scene::hasComponent() const
 {
-	return hasComponent(typeid(T));
+	return hasComponent(getTypeId<T>());
 }
 
 template <IsResource T>
-auto Scene::getResources() const -> std::vector<std::shared_ptr<T>>
+auto Scene::getResources() const -> ResourceView<T>
 {
-	std::vector<std::shared_ptr<T>> result;
-	if (hasResource(typeid(T))) {
-		auto& scene_resources = getResources(typeid(T));
-		result.resize(scene_resources.size());
-		std::transform(scene_resources.begin(), scene_resources.end(),
-		    result.begin(), [](const auto& resource) {
-			    return std::dynamic_pointer_cast<T>(resource);
-		    });
-	}
-	return result;
+	return ResourceView<T>(getResources(getTypeId<T>()));
 }
 
 template <IsResource T>
@@ -181,26 +224,35 @@ void Scene::setResources(std::vector<std::shared_ptr<T>>&& resources)
 	std::vector<std::shared_ptr<Resource>> result(
 	    std::make_move_iterator(resources.begin()),
 	    std::make_move_iterator(resources.end()));
-	setResources(typeid(T), std::move(result));
+	setResources(getTypeId<T>(), std::move(result));
 }
 
 template <IsResource T>
 void Scene::addResource(std::shared_ptr<T> resource)
 {
-	if (resource)
-		resources[typeid(T)].push_back(std::move(resource));
+	if (resource) {
+		watchResource(getTypeId<T>(), *resource);
+		resources[getTypeId<T>()].push_back(std::move(resource));
+		bumpGeneration(getTypeId<T>());
+	}
 }
 
 template <IsResource T>
 void Scene::clearResources()
 {
-	resources.erase(typeid(T));
+	setResources(getTypeId<T>(), {});
 }
 
 template <IsResource T>
 bool Scene::hasResource() const
 {
-	return hasResource(typeid(T));
+	return hasResource(getTypeId<T>());
+}
+
+template <typename T>
+uint64_t Scene::getGeneration() const
+{
+	return getGeneration(getTypeId<T>());
 }
 
 template <IsBehaviour T>
@@ -0,0 +1,120 @@
+#include "SpatialIndex.hpp"
+
+#include "Scene.hpp"
+#include "Scene/Components/Mesh.hpp"
+
+SpatialIndex::SpatialIndex(Scene& scene) :
+    scene(&scene)
+{}
+
+void SpatialIndex::update()
+{
+	// The store is created after the index, so the journal is attached on first use
+	auto& transforms = scene->getTransforms();
+	if (!attached) {
+		transforms.addJournal(journal);
+		attached = true;
+	}
+	transforms.update();
+
+	if (archetype_generation != scene->getArchetypes().getGeneration())
+		rebuild();
+	else
+		refit();
+
+	journal.clear();
+}
+
+void SpatialIndex::rebuild()
+{
+	tree.each([this](int32_t proxy) { tree.getNode(proxy)->spatial_proxy = -1; });
+	tree.clear();
+	local_bounds.clear();
+
+	scene->each<Mesh, Transform>([this](Node& node, Mesh&, Transform&) { insert(node); });
+	archetype_generation = scene->getArchetypes().getGeneration();
+}
+
+void SpatialIndex::refit()
+{
+	const auto& nodes = scene->getTransforms().getNodes();
+	const auto& world_matrices = scene->getTransforms().getWorldMatrices();
+
+	for (auto slot : journal.getTransforms()) {
+		auto proxy = nodes[slot]->spatial_proxy;
+		if (proxy >= 0)
+			tree.moveProxy(proxy, local_bounds[proxy].transformed(world_matrices[slot]));
+	}
+}
+
+void SpatialIndex::insert(Node& node)
+{
+	Aabb bounds;
+	for (const auto& submesh : node.getComponent<Mesh>().getSubmeshes())
+		if (submesh && submesh->hasBounds())
+			bounds = Aabb::merge(bounds, {submesh->getBoundsMin(), submesh->getBoundsMax()});
+
+	// Meshes without bounds cannot be hit and stay out of the tree
+	if (!bounds.valid())
+		return;
+
+	auto proxy = tree.createProxy(bounds.transformed(node.getTransform().getWorldMatrix()), &node);
+	if (static_cast<size_t>(proxy) >= local_bounds.size())
+		local_bounds.resize(proxy + 1);
+	local_bounds[proxy] = bounds;
+	node.spatial_proxy = proxy;
+}
+
+void SpatialIndex::remove(Node& node)
+{
+	if (node.spatial_proxy < 0)
+		return;
+
+	tree.destroyProxy(node.spatial_proxy);
+	node.spatial_proxy = -1;
+}
+
+auto SpatialIndex::raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<RaycastHit>
+{
+	float distance = 0.0f;
+	auto  proxy = tree.raycast(origin, direction, max_distance, distance);
+	if (proxy < 0)
+		return std::nullopt;
+
+	return RaycastHit{tree.getNode(proxy), distance};
+}
+
+void SpatialIndex::overlapBox(const Aabb& bounds, std::vector<Node*>& result) const
+{
+	result.clear();
+	tree.query(bounds, [&](int32_t proxy) {
+		if (tree.getBounds(proxy).overlaps(bounds))
+			result.push_back(tree.getNode(proxy));
+		return true;
+	});
+}
+
+void SpatialIndex::overlapSphere(const glm::vec3& center, float radius, std::vector<Node*>& result) const
+{
+	result.clear();
+	tree.query({center - glm::vec3(radius), center + glm::vec3(radius)}, [&](int32_t proxy) {
+		if (tree.getBounds(proxy).distance2(center) <= radius * radius)
+			result.push_back(tree.getNode(proxy));
+		return true;
+	});
+}
+
+void SpatialIndex::findNearest(const glm::vec3& point, size_t count, std::vector<Node*>& result) const
+{
+	std::vector<int32_t> proxies;
+	tree.findNearest(point, count, proxies);
+
+	result.clear();
+	for (auto proxy : proxies)
+		result.push_back(tree.getNode(proxy));
+}
+
+const AabbTree& SpatialIndex::getTree() const
+{
+	return tree;
+}
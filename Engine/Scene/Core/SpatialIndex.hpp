@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+
+#include <glm/glm.hpp>
+
+#include "AabbTree.hpp"
+#include "ChangeJournal.hpp"
+
+class Node;
+class Scene;
+
+struct RaycastHit {
+	Node* node{};
+	float distance{};
+};
+
+// World bounds of every node carrying a mesh, kept in an AabbTree. Moved nodes are refitted from a transform journal
+// of its own, the tree is rebuilt when nodes join, leave or change their components
+class SpatialIndex {
+private:
+	Scene*            scene{};
+	AabbTree          tree;
+	ChangeJournal     journal;
+	std::vector<Aabb> local_bounds;
+	uint64_t          archetype_generation{~0ull};
+	bool              attached{false};
+
+	void rebuild();
+	void refit();
+	void insert(Node& node);
+
+public:
+	explicit SpatialIndex(Scene& scene);
+	~SpatialIndex() = default;
+
+	SpatialIndex(const SpatialIndex&) = delete;
+	SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+	SpatialIndex(SpatialIndex&&) noexcept = delete;
+	SpatialIndex& operator=(SpatialIndex&&) noexcept = delete;
+
+	// Brings the tree in line with the scene, called by every query of the scene
+	void update();
+	void remove(Node& node);
+
+	auto raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const -> std::optional<RaycastHit>;
+	void overlapBox(const Aabb& bounds, std::vector<Node*>& result) const;
+	void overlapSphere(const glm::vec3& center, float radius, std::vector<Node*>& result) const;
+	void findNearest(const glm::vec3& point, size_t count, std::vector<Node*>& result) const;
+
+	auto getTree() const -> const AabbTree&;
+};
@@ -0,0 +1,239 @@
+#include "TransformStore.hpp"
+
+#include <algorithm>
+
+#include "Node.hpp"
+#include "ChangeJournal.hpp"
+#include "Core/Thread/ThreadPool.hpp"
+
+// Levels below this many slots are cheaper to run on the calling thread than to hand out
+constexpr size_t PARALLEL_LEVEL_SIZE = 4096;
+constexpr size_t PARALLEL_GRAIN = 1024;
+
+TransformStore::TransformStore(ChangeJournal* journal)
+{
+	if (journal)
+		journals.push_back(journal);
+}
+
+TransformStore::~TransformStore()
+{
+	// Nodes outliving the store fall back to their own values
+	for (auto* node : nodes)
+		node->getTransform().detach();
+}
+
+void TransformStore::addJournal(ChangeJournal& journal)
+{
+	journal.resetTransforms(nodes.size());
+	journals.push_back(&journal);
+
+	// A late consumer starts from every slot so it sees the current matrices once
+	for (uint32_t index = 0; index < nodes.size(); index++)
+		journal.recordTransform(index);
+}
+
+void TransformStore::removeJournal(ChangeJournal& journal)
+{
+	std::erase(journals, &journal);
+}
+
+void TransformStore::setRoot(Node* new_root)
+{
+	root = new_root;
+	invalidateHierarchy();
+}
+
+void TransformStore::invalidateHierarchy()
+{
+	hierarchy_dirty = true;
+}
+
+void TransformStore::markDirty(uint32_t index)
+{
+	// A baked node that moves is not static after all
+	if (index < static_count) {
+		nodes[index]->setStatic(false);
+		hierarchy_dirty = true;
+		return;
+	}
+
+	dirty[index] = 1;
+	any_dirty = true;
+}
+
+void TransformStore::build()
+{
+	std::vector<Node*>    breadth_first{root};
+	std::vector<int32_t>  breadth_first_parents{-1};
+	std::vector<uint32_t> depths{0};
+	std::vector<uint8_t>  baked{root->isStatic()};
+
+	// Breadth first, so depths never decrease and parents precede their children
+	for (size_t index = 0; index < breadth_first.size(); index++)
+		for (auto* child : breadth_first[index]->getChildren()) {
+			breadth_first.push_back(child);
+			breadth_first_parents.push_back(static_cast<int32_t>(index));
+			depths.push_back(depths[index] + 1);
+			baked.push_back(baked[index] && child->isStatic());
+		}
+
+	// Baked slots first, then every depth of the dynamic ones as one level
+	std::vector<uint32_t> slots(breadth_first.size());
+	uint32_t              baked_count = static_cast<uint32_t>(std::count(baked.begin(), baked.end(), uint8_t{1}));
+	for (uint32_t index = 0, next_baked = 0, next_dynamic = baked_count; index < breadth_first.size(); index++)
+		slots[index] = baked[index] ? next_baked++ : next_dynamic++;
+
+	std::vector<Node*>    order(breadth_first.size());
+	std::vector<int32_t>  order_parents(breadth_first.size());
+	std::vector<uint32_t> offsets{baked_count};
+	for (uint32_t index = 0; index < breadth_first.size(); index++) {
+		order[slots[index]] = breadth_first[index];
+		order_parents[slots[index]] = breadth_first_parents[index] >= 0 ? static_cast<int32_t>(slots[breadth_first_parents[index]]) : -1;
+	}
+	for (uint32_t index = 0, previous_depth = 0; index < breadth_first.size(); index++) {
+		if (baked[index])
+			continue;
+		if (slots[index] > baked_count && depths[index] != previous_depth)
+			offsets.push_back(slots[index]);
+		previous_depth = depths[index];
+	}
+	offsets.push_back(static_cast<uint32_t>(order.size()));
+
+	// Values are read through the handles, nodes may come from this store or still hold their own
+	std::vector<glm::vec3> new_translations;
+	std::vector<glm::quat> new_rotations;
+	std::vector<glm::vec3> new_scalings;
+	new_translations.reserve(order.size());
+	new_rotations.reserve(order.size());
+	new_scalings.reserve(order.size());
+	for (auto* node : order) {
+		auto& transform = node->getTransform();
+		new_translations.push_back(transform.getTranslation());
+		new_rotations.push_back(transform.getRotation());
+		new_scalings.push_back(transform.getScaling());
+	}
+
+	for (auto* node : nodes)
+		node->getTransform().detach();
+
+	translations = std::move(new_translations);
+	rotations = std::move(new_rotations);
+	scalings = std::move(new_scalings);
+	parents = std::move(order_parents);
+	nodes = std::move(order);
+	level_offsets = std::move(offsets);
+	static_count = baked_count;
+	world_matrices.assign(nodes.size(), glm::mat4(1.0f));
+	dirty.assign(nodes.size(), 1);
+	std::fill(dirty.begin(), dirty.begin() + static_count, 0);
+	any_dirty = true;
+	for (auto* journal : journals)
+		journal->resetTransforms(nodes.size());
+
+	// Computed once here, the levels never visit them again
+	for (uint32_t index = 0; index < static_count; index++) {
+		auto local = compose(translations[index], rotations[index], scalings[index]);
+		world_matrices[index] = parents[index] >= 0 ? world_matrices[parents[index]] * local : local;
+		for (auto* journal : journals)
+			journal->recordTransform(index);
+	}
+
+	for (uint32_t index = 0; index < nodes.size(); index++)
+		nodes[index]->getTransform().attach(*this, index);
+
+	hierarchy_dirty = false;
+}
+
+void TransformStore::update()
+{
+	if (hierarchy_dirty && root)
+		build();
+
+	if (!any_dirty)
+		return;
+
+	// Each slot reads only its parent one level up, so the result does not depend on how a level is split
+	for (size_t level = 0; level + 1 < level_offsets.size(); level++) {
+		size_t begin = level_offsets[level];
+		size_t end = level_offsets[level + 1];
+
+		if (end - begin < PARALLEL_LEVEL_SIZE) {
+			updateRange(begin, end);
+			continue;
+		}
+
+		size_t chunk_count = (end - begin + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+		ThreadPool::instance().parallelFor(chunk_count, [this, begin, end](size_t chunk) {
+			size_t chunk_begin = begin + chunk * PARALLEL_GRAIN;
+			updateRange(chunk_begin, std::min(end, chunk_begin + PARALLEL_GRAIN));
+		});
+	}
+
+	// Flags now cover every descendant of a changed slot, so they are exactly the recomputed world matrices
+	for (uint32_t index = static_count; !journals.empty() && index < dirty.size(); index++)
+		if (dirty[index])
+			for (auto* journal : journals)
+				journal->recordTransform(index);
+
+	std::fill(dirty.begin() + static_count, dirty.end(), 0);
+	any_dirty = false;
+}
+
+// A dirty flag reaches every descendant because parents were processed with the level above
+void TransformStore::updateRange(size_t begin, size_t end)
+{
+	for (size_t index = begin; index < end; index++) {
+		auto parent = parents[index];
+		if (parent >= 0)
+			dirty[index] |= dirty[parent];
+
+		if (!dirty[index])
+			continue;
+
+		auto local = compose(translations[index], rotations[index], scalings[index]);
+		world_matrices[index] = parent >= 0 ? world_matrices[parent] * local : local;
+	}
+}
+
+size_t TransformStore::size() const
+{
+	return nodes.size();
+}
+
+size_t TransformStore::getLevelCount() const
+{
+	return level_offsets.empty() ? 0 : level_offsets.size() - 1;
+}
+
+size_t TransformStore::getStaticCount() const
+{
+	return static_count;
+}
+
+const std::vector<Node*>& TransformStore::getNodes() const
+{
+	return nodes;
+}
+
+const std::vector<int32_t>& TransformStore::getParents() const
+{
+	return parents;
+}
+
+const std::vector<glm::mat4>& TransformStore::getWorldMatrices() const
+{
+	return world_matrices;
+}
+
+// Same result as translate * mat4_cast * scale without the two full matrix products
+glm::mat4 TransformStore::compose(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scaling)
+{
+	auto matrix = glm::mat4_cast(rotation);
+	matrix[0] *= scaling.x;
+	matrix[1] *= scaling.y;
+	matrix[2] *= scaling.z;
+	matrix[3] = glm::vec4(translation, 1.0f);
+
+	return matrix;
+}
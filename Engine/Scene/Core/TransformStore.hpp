@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+class Node;
+class ChangeJournal;
+
+// Scene-wide local TRS and world matrices as structure of arrays in breadth-first order, so every depth level is one
+// contiguous range whose slots only read the level above. Transform components are handles into it, world matrices of
+// changed slots and their descendants are refreshed level by level, large levels split across the thread pool. Every
+// recomputed slot is recorded in each attached journal, one per consumer.
+// Static nodes under static parents are baked: they lead the arrays, their world matrices are computed by the build
+// and the levels only cover the slots after them. Moving a baked node makes it dynamic and rebuilds the order
+class TransformStore {
+private:
+	std::vector<glm::vec3> translations;
+	std::vector<glm::quat> rotations;
+	std::vector<glm::vec3> scalings;
+	std::vector<glm::mat4> world_matrices;
+	std::vector<int32_t>   parents;
+	std::vector<uint8_t>   dirty;
+	std::vector<Node*>     nodes;
+	std::vector<uint32_t>  level_offsets;
+
+	std::vector<ChangeJournal*> journals;
+
+	Node*    root{};
+	uint32_t static_count{0};
+	bool     hierarchy_dirty{true};
+	bool     any_dirty{false};
+
+	friend class Transform;
+
+	void build();
+	void markDirty(uint32_t index);
+	void updateRange(size_t begin, size_t end);
+
+public:
+	TransformStore() = default;
+	explicit TransformStore(ChangeJournal* journal);
+	~TransformStore();
+
+	TransformStore(const TransformStore&) = delete;
+	TransformStore& operator=(const TransformStore&) = delete;
+
+	TransformStore(TransformStore&&) noexcept = delete;
+	TransformStore& operator=(TransformStore&&) noexcept = delete;
+
+	void addJournal(ChangeJournal& journal);
+	void removeJournal(ChangeJournal& journal);
+
+	void setRoot(Node* new_root);
+	// Nodes were added or reparented, the order is rebuilt by the next update
+	void invalidateHierarchy();
+	void update();
+
+	size_t size() const;
+	size_t getLevelCount() const;
+	size_t getStaticCount() const;
+	auto   getNodes() const -> const std::vector<Node*>&;
+	auto   getParents() const -> const std::vector<int32_t>&;
+	auto   getWorldMatrices() const -> const std::vector<glm::mat4>&;
+
+	static glm::mat4 compose(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scaling);
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <iterator>
+
+class Component;
+class Resource;
+
+// Non-owning range over one type bucket of a scene, yields T* without copying the owners. Elements were stored under
+// T, so the cast needs no runtime check. Invalidated when the bucket changes, like an iterator of the vector behind it
+template <typename T, typename Owner>
+class TypedView {
+private:
+	std::span<const Owner> items;
+
+public:
+	class Iterator {
+	private:
+		const Owner* current{};
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = T*;
+		using difference_type = std::ptrdiff_t;
+
+		Iterator() = default;
+		explicit Iterator(const Owner* current) :
+		    current(current)
+		{}
+
+		T* operator*() const { return static_cast<T*>(current->get()); }
+
+		Iterator& operator++()
+		{
+			++current;
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			auto previous = *this;
+			++current;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const = default;
+	};
+
+	TypedView() = default;
+	explicit TypedView(std::span<const Owner> items) :
+	    items(items)
+	{}
+
+	Iterator begin() const { return Iterator(items.data()); }
+	Iterator end() const { return Iterator(items.data() + items.size()); }
+
+	size_t size() const { return items.size(); }
+	bool   empty() const { return items.empty(); }
+
+	T* operator[](size_t index) const { return static_cast<T*>(items[index].get()); }
+	T* front() const { return static_cast<T*>(items.front().get()); }
+
+	// Owning copies for callers that keep resources past a change of the bucket, allocates and touches every refcount
+	auto share(size_t index) const -> std::shared_ptr<T> { return std::static_pointer_cast<T>(items[index]); }
+	auto share() const -> std::vector<std::shared_ptr<T>>
+	{
+		std::vector<std::shared_ptr<T>> result;
+		result.reserve(items.size());
+		for (const auto& item : items)
+			result.push_back(std::static_pointer_cast<T>(item));
+		return result;
+	}
+};
+
+template <typename T>
+using ComponentView = TypedView<T, std::unique_ptr<Component>>;
+
+template <typename T>
+using ResourceView = TypedView<T, std::shared_ptr<Resource>>;
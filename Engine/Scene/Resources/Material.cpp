@@ -1,5 +1,7 @@
 #include "Material.hpp"
 
+#include "Scene/Core/ChangeJournal.hpp"
+
 Material::Material(const std::string& name) :
     Resource(name)
 {}
@@ -9,6 +11,22 @@ std::type_index Material::getType()
 	return typeid(Material);
 }
 
+ChangeJournal* Material::getJournal() const
+{
+	return journal;
+}
+
+void Material::setJournal(ChangeJournal* new_journal)
+{
+	journal = new_journal;
+}
+
+void Material::markChanged()
+{
+	if (journal)
+		journal->recordMaterial(*this);
+}
+
 glm::vec3 Material::getEmissive()
 {
 	return emissive;
@@ -17,6 +35,7 @@ glm::vec3 Material::getEmissive()
 void Material::setEmissive(const glm::vec3& emissive)
 {
 	this->emissive = emissive;
+	markChanged();
 }
 
 bool Material::getDoubleSided() const
@@ -27,6 +46,7 @@ bool Material::getDoubleSided() const
 void Material::setDoubleSided(bool double_sided)
 {
 	this->double_sided = double_sided;
+	markChanged();
 }
 
 float Material::getAlphaCutoff() const
@@ -37,6 +57,7 @@ float Material::getAlphaCutoff() const
 void Material::setAlphaCutoff(float alpha_cutoff)
 {
 	this->alpha_cutoff = alpha_cutoff;
+	markChanged();
 }
 
 AlphaMode Material::getAlphaMode()
@@ -47,6 +68,7 @@ AlphaMode Material::getAlphaMode()
 void Material::setAlphaMode(AlphaMode alpha_mode)
 {
 	this->alpha_mode = alpha_mode;
+	markChanged();
 }
 
 auto Material::getTextures() -> std::unordered_map<std::string, std::shared_ptr<Texture>>&
@@ -82,6 +104,7 @@ std::type_index PBRMaterial::getType()
 void PBRMaterial::setBaseColorFactor(const glm::vec4& base_color_factor)
 {
 	this->base_color_factor = base_color_factor;
+	markChanged();
 }
 
 glm::vec4 PBRMaterial::getBaseColorFactor() const
@@ -92,6 +115,7 @@ glm::vec4 PBRMaterial::getBaseColorFactor() const
 void PBRMaterial::setMetallicFactor(float metallic_factor)
 {
 	this->metallic_factor = metallic_factor;
+	markChanged();
 }
 
 float PBRMaterial::getMetallicFactor() const
@@ -102,6 +126,7 @@ float PBRMaterial::getMetallicFactor() const
 void PBRMaterial::setRoughnessFactor(float roughness_factor)
 {
 	this->roughness_factor = roughness_factor;
+	markChanged();
 }
 
 float PBRMaterial::getRoughnessFactor() const
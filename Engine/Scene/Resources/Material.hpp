@@ -9,6 +9,8 @@
 #include "Texture.hpp"
 #include "Scene/Core/Resource.hpp"
 
+class ChangeJournal;
+
 enum class AlphaMode : uint8_t {
 	Opaque,
 	Mask,
@@ -25,6 +27,11 @@ protected:
 
 	std::unordered_map<std::string, std::shared_ptr<Texture>> textures;
 
+	// Set by the scene holding the material, value setters record the change there
+	ChangeJournal* journal{};
+
+	void markChanged();
+
 public:
 	Material(const std::string& name);
 
@@ -32,6 +39,9 @@ public:
 
 	std::type_index getType() override;
 
+	ChangeJournal* getJournal() const;
+	void           setJournal(ChangeJournal* new_journal);
+
 	auto getEmissive() -> glm::vec3;
 	void setEmissive(const glm::vec3& emissive);
 
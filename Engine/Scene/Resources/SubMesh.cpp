@@ -1,5 +1,12 @@
 #include "SubMesh.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "Core/Hash/Hash.hpp"
+
 SubMesh::SubMesh(const std::string& name) :
     Resource(name)
 {}
@@ -14,31 +21,86 @@ uint32_t SubMesh::getVerticesCount() const
 	return vertices_count;
 }
 
+void SubMesh::setVerticesCount(uint32_t count)
+{
+	vertices_count = count;
+}
+
 uint32_t SubMesh::getIndicesCount() const
 {
 	return indices_count;
 }
 
-auto SubMesh::getVertices() const -> const std::vector<float>&
+uint32_t SubMesh::getIndexSize() const
 {
-	return vertex_data;
+	return index_size;
 }
 
-void SubMesh::setVertices(std::vector<float> vertex_data, uint32_t count)
+auto SubMesh::getIndexData() const -> std::span<const uint8_t>
 {
-	this->vertex_data = std::move(vertex_data);
-	vertices_count = count;
+	return index_data;
 }
 
-auto SubMesh::getIndices() const -> const std::vector<uint32_t>&
+auto SubMesh::getIndices() const -> std::vector<uint32_t>
 {
-	return index_data;
+	std::vector<uint32_t> indices(indices_count);
+	copyIndices(indices);
+	return indices;
+}
+
+// Converts the stored indices into a caller provided range (e.g. mapped staging memory), narrowing is the caller's call
+template <typename T>
+static void convertIndices(std::span<const uint8_t> index_data, uint32_t index_size, std::span<T> indices)
+{
+	size_t count = std::min(index_data.size() / index_size, indices.size());
+	switch (index_size) {
+	case 1:
+		std::copy_n(index_data.data(), count, indices.begin());
+		break;
+	case 2:
+		std::copy_n(reinterpret_cast<const uint16_t*>(index_data.data()), count, indices.begin());
+		break;
+	case 4:
+		std::copy_n(reinterpret_cast<const uint32_t*>(index_data.data()), count, indices.begin());
+		break;
+	default:
+		throw std::runtime_error("Unsupported index byte size");
+	}
+}
+
+void SubMesh::copyIndices(std::span<uint32_t> indices) const
+{
+	convertIndices(index_data, index_size, indices);
+}
+
+void SubMesh::copyIndices(std::span<uint16_t> indices) const
+{
+	convertIndices(index_data, index_size, indices);
+}
+
+void SubMesh::setIndices(std::span<const uint8_t> index_data, uint32_t index_size, std::shared_ptr<const void> storage)
+{
+	if (index_size != 1 && index_size != 2 && index_size != 4)
+		throw std::runtime_error("Unsupported index byte size");
+
+	this->index_data = index_data;
+	this->index_size = index_size;
+	index_storage = std::move(storage);
+	indices_count = static_cast<uint32_t>(index_data.size() / index_size);
 }
 
 void SubMesh::setIndices(std::vector<uint32_t> index_data)
 {
-	this->index_data = std::move(index_data);
-	indices_count = static_cast<uint32_t>(this->index_data.size());
+	auto storage = std::make_shared<const std::vector<uint32_t>>(std::move(index_data));
+	auto bytes = std::span(reinterpret_cast<const uint8_t*>(storage->data()), storage->size() * sizeof(uint32_t));
+	setIndices(bytes, sizeof(uint32_t), std::move(storage));
+}
+
+void SubMesh::setIndices(std::vector<uint16_t> index_data)
+{
+	auto storage = std::make_shared<const std::vector<uint16_t>>(std::move(index_data));
+	auto bytes = std::span(reinterpret_cast<const uint8_t*>(storage->data()), storage->size() * sizeof(uint16_t));
+	setIndices(bytes, sizeof(uint16_t), std::move(storage));
 }
 
 auto SubMesh::getAttributes() const -> const std::unordered_map<std::string, VertexAttribute>&
@@ -62,6 +124,109 @@ void SubMesh::setAttribute(const std::string& attribute_name, const VertexAttrib
 	vertex_attributes[attribute_name] = attribute;
 }
 
+bool SubMesh::hasBounds() const
+{
+	return bounds_min.x <= bounds_max.x;
+}
+
+const glm::vec3& SubMesh::getBoundsMin() const
+{
+	return bounds_min;
+}
+
+const glm::vec3& SubMesh::getBoundsMax() const
+{
+	return bounds_max;
+}
+
+void SubMesh::setBounds(const glm::vec3& min, const glm::vec3& max)
+{
+	bounds_min = min;
+	bounds_max = max;
+}
+
+auto SubMesh::getLods() const -> const std::vector<SubMeshLod>&
+{
+	return lods;
+}
+
+auto SubMesh::getLodIndices() const -> std::span<const uint32_t>
+{
+	return lod_indices;
+}
+
+void SubMesh::setLods(std::vector<SubMeshLod> lods, std::span<const uint32_t> lod_indices, std::shared_ptr<const void> storage)
+{
+	this->lods = std::move(lods);
+	this->lod_indices = lod_indices;
+	lod_storage = std::move(storage);
+}
+
+void SubMesh::setLods(std::vector<SubMeshLod> lods, std::vector<uint32_t> lod_indices)
+{
+	auto storage = std::make_shared<const std::vector<uint32_t>>(std::move(lod_indices));
+	auto indices = std::span<const uint32_t>(*storage);
+	setLods(std::move(lods), indices, std::move(storage));
+}
+
+auto SubMesh::getMeshlets() const -> const std::vector<Meshlet>&
+{
+	return meshlets;
+}
+
+void SubMesh::setMeshlets(std::vector<Meshlet> meshlets)
+{
+	this->meshlets = std::move(meshlets);
+}
+
+void SubMesh::shareGeometry(const SubMesh& source)
+{
+	vertices_count = source.vertices_count;
+	indices_count = source.indices_count;
+	index_data = source.index_data;
+	index_size = source.index_size;
+	index_storage = source.index_storage;
+	vertex_attributes = source.vertex_attributes;
+	bounds_min = source.bounds_min;
+	bounds_max = source.bounds_max;
+	lods = source.lods;
+	lod_indices = source.lod_indices;
+	lod_storage = source.lod_storage;
+	meshlets = source.meshlets;
+}
+
+GeometryKey SubMesh::getGeometryKey() const
+{
+	GeometryKey key{
+	    .vertices_count = vertices_count,
+	    .index_data = index_data.data(),
+	    .index_size = index_data.size(),
+	    .lod_index_data = lod_indices.data(),
+	    .lod_index_count = lod_indices.size(),
+	};
+
+	// Attribute order in the map is not stable across submeshes, so the names decide the order
+	for (const auto& [name, attribute] : vertex_attributes)
+		key.attributes.push_back({name, attribute.data.data(), attribute.data.size(), attribute.stride});
+	std::sort(key.attributes.begin(), key.attributes.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+	return key;
+}
+
+size_t GeometryKeyHash::operator()(const GeometryKey& key) const
+{
+	auto combine = [](uint64_t seed, const void* data, size_t size) {
+		return Hash::combine(Hash::combine(seed, reinterpret_cast<uintptr_t>(data)), size);
+	};
+
+	auto seed = combine(key.vertices_count, key.index_data, key.index_size);
+	seed = combine(seed, key.lod_index_data, key.lod_index_count);
+	for (const auto& stream : key.attributes)
+		seed = Hash::combine(combine(seed, stream.data, stream.size), stream.stride);
+
+	return static_cast<size_t>(seed);
+}
+
 std::shared_ptr<Material> SubMesh::getMaterial() const
 {
 	return material;
@@ -82,6 +247,28 @@ void SubMesh::setShaderName(const std::string& shader_name)
 	this->shader_name = shader_name;
 }
 
+bool SubMesh::isResident() const
+{
+	if (vertices_count > 0 && std::ranges::all_of(vertex_attributes, [](const auto& entry) { return entry.second.data.empty(); }))
+		return false;
+
+	return indices_count == 0 || !index_data.empty();
+}
+
+void SubMesh::release()
+{
+	for (auto& [name, attribute] : vertex_attributes) {
+		attribute.data = {};
+		attribute.storage.reset();
+	}
+
+	index_data = {};
+	index_storage.reset();
+
+	lod_indices = {};
+	lod_storage.reset();
+}
+
 bool SubMesh::isVisible() const
 {
 	return visible;
@@ -1,14 +1,78 @@
 #pragma once
 
+#include <span>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
 #include "Material.hpp"
 
+enum class ComponentType : uint8_t {
+	Byte,
+	UnsignedByte,
+	Short,
+	UnsignedShort,
+	UnsignedInt,
+	Float,
+};
+
+// A strided view over one vertex stream, storage keeps the backing memory (mapped file or buffer) alive
 struct VertexAttribute {
-	uint32_t size = 0;
-	uint32_t offset = 0;
+	uint32_t      size = 0;
+	uint32_t      stride = 0;
+	uint32_t      components = 0;
+	ComponentType component_type{ComponentType::Float};
+	bool          normalized{false};
+
+	std::span<const uint8_t>    data{};
+	std::shared_ptr<const void> storage{};
+};
+
+// A simplified level as a range of the LOD index buffer, error is its object space deviation from the full mesh
+struct SubMeshLod {
+	uint32_t index_offset = 0;
+	uint32_t index_count = 0;
+	float    error = 0.0f;
+};
+
+// A small cluster of triangles as a range of the submesh indices. Bounds are in object space, every triangle
+// faces away from a point p with dot(cone_apex - p, cone_axis) >= cone_cutoff * |cone_apex - p|
+struct Meshlet {
+	uint32_t  index_offset = 0;
+	uint32_t  index_count = 0;
+	glm::vec3 center{};
+	float     radius = 0.0f;
+	glm::vec3 cone_apex{};
+	glm::vec3 cone_axis{0.0f, 0.0f, 1.0f};
+	float     cone_cutoff = 1.0f; // 1 disables the cone test
+};
+
+// Addresses and sizes of the streams backing a submesh, equal for submeshes sharing their geometry. Lookups compare
+// the whole key, the hash only picks the bucket
+struct GeometryKey {
+	struct Stream {
+		std::string name;
+		const void* data{};
+		size_t      size{};
+		uint32_t    stride{};
+
+		bool operator==(const Stream& other) const = default;
+	};
+
+	uint32_t            vertices_count{};
+	const void*         index_data{};
+	size_t              index_size{};
+	const void*         lod_index_data{};
+	size_t              lod_index_count{};
+	std::vector<Stream> attributes;
+
+	bool operator==(const GeometryKey& other) const = default;
+};
+
+struct GeometryKeyHash {
+	size_t operator()(const GeometryKey& key) const;
 };
 
 class SubMesh : public Resource {
@@ -19,11 +83,21 @@ private:
 	uint32_t    vertices_count{0};
 	uint32_t    indices_count{0};
 
-	std::vector<float>    vertex_data;
-	std::vector<uint32_t> index_data;
+	std::span<const uint8_t>    index_data{};
+	uint32_t                    index_size{sizeof(uint32_t)};
+	std::shared_ptr<const void> index_storage{};
 
 	std::unordered_map<std::string, VertexAttribute> vertex_attributes;
 
+	glm::vec3 bounds_min{std::numeric_limits<float>::max()};
+	glm::vec3 bounds_max{std::numeric_limits<float>::lowest()};
+
+	std::vector<SubMeshLod>     lods;
+	std::span<const uint32_t>   lod_indices{};
+	std::shared_ptr<const void> lod_storage{};
+
+	std::vector<Meshlet> meshlets;
+
 	bool visible{true};
 
 public:
@@ -33,19 +107,45 @@ public:
 	std::type_index getType() override;
 
 	uint32_t getVerticesCount() const;
-	uint32_t getIndicesCount() const;
+	void     setVerticesCount(uint32_t count);
 
-	auto getVertices() const -> const std::vector<float>&;
-	void setVertices(std::vector<float> vertex_data, uint32_t count = 0);
+	uint32_t getIndicesCount() const;
+	uint32_t getIndexSize() const;
 
-	auto getIndices() const -> const std::vector<uint32_t>&;
+	auto getIndexData() const -> std::span<const uint8_t>;
+	auto getIndices() const -> std::vector<uint32_t>;
+	void copyIndices(std::span<uint32_t> indices) const;
+	void copyIndices(std::span<uint16_t> indices) const;
+	void setIndices(std::span<const uint8_t> index_data, uint32_t index_size, std::shared_ptr<const void> storage);
 	void setIndices(std::vector<uint32_t> index_data);
+	void setIndices(std::vector<uint16_t> index_data);
 
 	auto getAttributes() const -> const std::unordered_map<std::string, VertexAttribute>&;
 	auto getAttribute(const std::string& name) -> VertexAttribute*;
 	auto getAttribute(const std::string& name) const -> const VertexAttribute*;
 	void setAttribute(const std::string& name, const VertexAttribute& attribute);
 
+	bool hasBounds() const;
+	auto getBoundsMin() const -> const glm::vec3&;
+	auto getBoundsMax() const -> const glm::vec3&;
+	void setBounds(const glm::vec3& min, const glm::vec3& max);
+
+	auto getLods() const -> const std::vector<SubMeshLod>&;
+	auto getLodIndices() const -> std::span<const uint32_t>;
+	void setLods(std::vector<SubMeshLod> lods, std::span<const uint32_t> lod_indices, std::shared_ptr<const void> storage);
+	void setLods(std::vector<SubMeshLod> lods, std::vector<uint32_t> lod_indices);
+
+	auto getMeshlets() const -> const std::vector<Meshlet>&;
+	void setMeshlets(std::vector<Meshlet> meshlets);
+
+	// Points every vertex, index, LOD and meshlet stream at the ones of source, material and name stay as they are
+	void shareGeometry(const SubMesh& source);
+	auto getGeometryKey() const -> GeometryKey;
+
+	// Vertex, index and LOD index streams, counts, bounds, LOD ranges and meshlets stay after release
+	bool isResident() const override;
+	void release() override;
+
 	auto getMaterial() const -> std::shared_ptr<Material>;
 	void setMaterial(std::shared_ptr<Material> material);
 
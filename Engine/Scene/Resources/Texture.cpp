@@ -9,22 +9,40 @@ std::type_index Texture::getType()
 	return typeid(Texture);
 }
 
-const std::vector<uint8_t>& Texture::getData() const
+std::span<const uint8_t> Texture::getData() const
 {
 	return data;
 }
 
 void Texture::setData(std::vector<uint8_t> new_data)
 {
-	data = std::move(new_data);
+	auto owned = std::make_shared<const std::vector<uint8_t>>(std::move(new_data));
+	setData(*owned, owned);
 }
 
-uint32_t Texture::getFormat() const
+void Texture::setData(std::span<const uint8_t> new_data, std::shared_ptr<const void> new_storage)
+{
+	data = new_data;
+	storage = std::move(new_storage);
+}
+
+bool Texture::isResident() const
+{
+	return !data.empty();
+}
+
+void Texture::release()
+{
+	data = {};
+	storage.reset();
+}
+
+TextureFormat Texture::getFormat() const
 {
 	return format;
 }
 
-void Texture::setFormat(uint32_t new_format)
+void Texture::setFormat(TextureFormat new_format)
 {
 	format = new_format;
 }
@@ -49,7 +67,65 @@ void Texture::setHeight(uint32_t new_height)
 	height = new_height;
 }
 
+bool Texture::isSrgb() const
+{
+	return srgb;
+}
+
+void Texture::setSrgb(bool new_srgb)
+{
+	srgb = new_srgb;
+}
+
+uint32_t Texture::getMipCount() const
+{
+	return mips.empty() ? 1 : static_cast<uint32_t>(mips.size());
+}
+
+TextureMip Texture::getMip(uint32_t level) const
+{
+	if (mips.empty())
+		return {width, height, 0, data.size()};
+
+	return mips.at(level);
+}
+
+std::span<const uint8_t> Texture::getMipData(uint32_t level) const
+{
+	auto mip = getMip(level);
+	return data.subspan(mip.offset, mip.size);
+}
+
+void Texture::setMips(std::vector<TextureMip> new_mips)
+{
+	mips = std::move(new_mips);
+}
+
 bool Texture::valid() const
 {
-	return !data.empty() && width > 0 && height > 0 && format > 0;
+	return !data.empty() && width > 0 && height > 0 && format != TextureFormat::Undefined;
+}
+
+bool Texture::isCompressed(TextureFormat format)
+{
+	return format != TextureFormat::Undefined && format != TextureFormat::RGBA8;
+}
+
+// Block formats store 4x4 pixel blocks, partial blocks at the edges of small levels are padded
+uint64_t Texture::getDataSize(TextureFormat format, uint32_t width, uint32_t height)
+{
+	uint64_t blocks = uint64_t{(width + 3) / 4} * ((height + 3) / 4);
+	switch (format) {
+	case TextureFormat::RGBA8:
+		return uint64_t{width} * height * 4;
+	case TextureFormat::BC1:
+	case TextureFormat::BC4:
+		return blocks * 8;
+	case TextureFormat::BC3:
+	case TextureFormat::BC5:
+	case TextureFormat::BC7:
+		return blocks * 16;
+	default:
+		return 0;
+	}
 }
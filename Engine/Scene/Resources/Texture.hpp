@@ -1,17 +1,42 @@
 #pragma once
 
+#include <span>
+#include <memory>
 #include <vector>
 #include <string>
 
 #include "Scene/Core/Resource.hpp"
 
+enum class TextureFormat : uint32_t {
+	Undefined = 0,
+	RGBA8 = 4, // Keeps the value of the channel count stored before block compression
+	BC1 = 16,
+	BC3,
+	BC4,
+	BC5,
+	BC7,
+};
+
+// One level of the mip chain as a byte range of the texture data
+struct TextureMip {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint64_t offset = 0;
+	uint64_t size = 0;
+};
+
 class Texture : public Resource {
 private:
-	std::vector<uint8_t> data;
+	std::span<const uint8_t>    data{};
+	std::shared_ptr<const void> storage{};
+
+	TextureFormat format{TextureFormat::Undefined};
+	uint32_t      width{0};
+	uint32_t      height{0};
+	bool          srgb{true};
 
-	uint32_t format{0};
-	uint32_t width{0};
-	uint32_t height{0};
+	// Empty until a chain is generated, data then holds every level back to back
+	std::vector<TextureMip> mips;
 
 public:
 	Texture(const std::string& name);
@@ -19,11 +44,15 @@ public:
 
 	std::type_index getType() override;
 
-	auto getData() const -> const std::vector<uint8_t>&;
+	auto getData() const -> std::span<const uint8_t>;
 	void setData(std::vector<uint8_t> new_data);
+	void setData(std::span<const uint8_t> new_data, std::shared_ptr<const void> new_storage);
 
-	auto getFormat() const -> uint32_t;
-	void setFormat(uint32_t new_format);
+	bool isResident() const override;
+	void release() override;
+
+	auto getFormat() const -> TextureFormat;
+	void setFormat(TextureFormat new_format);
 
 	auto getWidth() const -> uint32_t;
 	void setWidth(uint32_t new_width);
@@ -31,5 +60,16 @@ public:
 	auto getHeight() const -> uint32_t;
 	void setHeight(uint32_t new_height);
 
+	bool isSrgb() const;
+	void setSrgb(bool new_srgb);
+
+	auto getMipCount() const -> uint32_t;
+	auto getMip(uint32_t level) const -> TextureMip;
+	auto getMipData(uint32_t level) const -> std::span<const uint8_t>;
+	void setMips(std::vector<TextureMip> new_mips);
+
 	bool valid() const;
+
+	static bool isCompressed(TextureFormat format);
+	static auto getDataSize(TextureFormat format, uint32_t width, uint32_t height) -> uint64_t;
 };
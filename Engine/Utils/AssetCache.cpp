@@ -0,0 +1,251 @@
+#include "AssetCache.hpp"
+
+#include <format>
+#include <cstring>
+#include <algorithm>
+
+#include "Core/File/FileSystem.hpp"
+#include "Core/File/JsonParser.hpp"
+#include "Core/File/MappedFile.hpp"
+#include "Core/Hash/Hash.hpp"
+#include "Core/Log/Logger.hpp"
+
+static constexpr uint32_t manifest_version = 1;
+
+static std::filesystem::path normalize(const std::filesystem::path& path)
+{
+	return std::filesystem::absolute(path).lexically_normal();
+}
+
+uint64_t CookSettings::hash() const
+{
+	auto seed = Hash::combine(Hash::xxh64(std::string_view("CookSettings")), scene_format);
+	seed = Hash::combine(seed, optimize_meshes);
+	seed = Hash::combine(seed, generate_lods);
+	seed = Hash::combine(seed, build_meshlets);
+	seed = Hash::combine(seed, generate_mips);
+	seed = Hash::combine(seed, compress_textures);
+	seed = Hash::combine(seed, deduplicate_assets);
+	seed = Hash::combine(seed, bake_static);
+	return Hash::combine(seed, collapse_static);
+}
+
+AssetCache::AssetCache(const std::filesystem::path& assets_dir, const std::filesystem::path& cache_dir) :
+    assets_dir(normalize(assets_dir)), cache_dir(normalize(cache_dir))
+{
+	if (!FileSystem::exists(getManifestPath()))
+		return;
+
+	try {
+		auto manifest = JsonParser::readJson(getManifestPath());
+		if (manifest.value("version", 0u) != manifest_version)
+			return;
+
+		for (const auto& [key, json_entry] : manifest["entries"].items()) {
+			CacheEntry entry{
+			    .source_hash = std::stoull(json_entry.at("source_hash").get<std::string>(), nullptr, 16),
+			    .settings_hash = std::stoull(json_entry.at("settings_hash").get<std::string>(), nullptr, 16),
+			    .output = json_entry.at("output").get<std::string>(),
+			};
+
+			for (const auto& json_stamp : json_entry.at("files"))
+				entry.stamps.push_back({
+				    .path = json_stamp.at("path").get<std::string>(),
+				    .size = json_stamp.at("size").get<uint64_t>(),
+				    .time = json_stamp.at("time").get<int64_t>(),
+				});
+
+			entries[key] = std::move(entry);
+		}
+	} catch (const std::exception& e) {
+		Logger::warn(std::format("Ignoring asset cache manifest: {}", e.what()));
+		entries.clear();
+	}
+}
+
+auto AssetCache::getKey(const std::filesystem::path& source) const -> std::optional<std::string>
+{
+	auto relative = normalize(source).lexically_relative(assets_dir);
+	if (relative.empty() || *relative.begin() == "..")
+		return std::nullopt;
+
+	return relative.generic_string();
+}
+
+auto AssetCache::getStamps(const std::vector<std::filesystem::path>& files) const -> std::vector<CacheStamp>
+{
+	std::vector<CacheStamp> stamps;
+	for (const auto& file : files) {
+		CacheStamp      stamp{.path = normalize(file).lexically_relative(assets_dir).generic_string()};
+		std::error_code error;
+		if (auto size = std::filesystem::file_size(file, error); !error)
+			stamp.size = size;
+		if (auto time = std::filesystem::last_write_time(file, error); !error)
+			stamp.time = time.time_since_epoch().count();
+
+		stamps.push_back(std::move(stamp));
+	}
+
+	return stamps;
+}
+
+std::filesystem::path AssetCache::getManifestPath() const
+{
+	return cache_dir / "manifest.json";
+}
+
+std::filesystem::path AssetCache::getCookedPath(const std::filesystem::path& source) const
+{
+	auto key = getKey(source);
+	if (!key)
+		throw std::runtime_error("Asset is outside the assets directory: " + source.string());
+
+	return (cache_dir / *key).replace_extension(".vxscene");
+}
+
+auto AssetCache::findCooked(const std::filesystem::path& source, const CookSettings& settings) -> std::optional<std::filesystem::path>
+{
+	auto key = getKey(source);
+	if (!key)
+		return std::nullopt;
+
+	auto it = entries.find(*key);
+	if (it == entries.end() || it->second.settings_hash != settings.hash())
+		return std::nullopt;
+
+	auto& entry = it->second;
+	auto        cooked_path = cache_dir / entry.output;
+	if (!FileSystem::exists(cooked_path))
+		return std::nullopt;
+
+	// Unchanged stamps are trusted, otherwise the content decides (e.g. after a fresh checkout)
+	std::vector<std::filesystem::path> files;
+	for (const auto& stamp : entry.stamps)
+		files.push_back(assets_dir / stamp.path);
+
+	auto stamps = getStamps(files);
+	bool stamps_match = std::equal(stamps.begin(), stamps.end(), entry.stamps.begin(), entry.stamps.end(),
+	    [](const CacheStamp& a, const CacheStamp& b) { return a.path == b.path && a.size == b.size && a.time == b.time; });
+
+	if (stamps_match)
+		return cooked_path;
+	if (hashSource(source) != entry.source_hash)
+		return std::nullopt;
+
+	// Same content under new stamps, recorded so the next lookup does not hash again
+	entry.stamps = getStamps(getDependencies(source));
+	dirty = true;
+
+	return cooked_path;
+}
+
+CacheEntry AssetCache::makeEntry(const std::filesystem::path& source, const CookSettings& settings) const
+{
+	// Stamps are taken before hashing so a concurrent edit never gets recorded as current
+	CacheEntry entry{
+	    .settings_hash = settings.hash(),
+	    .output = normalize(getCookedPath(source)).lexically_relative(cache_dir).generic_string(),
+	    .stamps = getStamps(getDependencies(source)),
+	};
+	entry.source_hash = hashSource(source);
+
+	return entry;
+}
+
+void AssetCache::addEntry(const std::filesystem::path& source, CacheEntry entry)
+{
+	if (auto key = getKey(source)) {
+		entries[*key] = std::move(entry);
+		dirty = true;
+	}
+}
+
+bool AssetCache::isDirty() const
+{
+	return dirty;
+}
+
+bool AssetCache::save()
+{
+	nlohmann::json json_entries = nlohmann::json::object();
+	for (const auto& [key, entry] : entries) {
+		nlohmann::json json_stamps = nlohmann::json::array();
+		for (const auto& stamp : entry.stamps)
+			json_stamps.push_back({{"path", stamp.path}, {"size", stamp.size}, {"time", stamp.time}});
+
+		json_entries[key] = {
+		    {"source_hash", std::format("{:016x}", entry.source_hash)},
+		    {"settings_hash", std::format("{:016x}", entry.settings_hash)},
+		    {"output", entry.output},
+		    {"files", std::move(json_stamps)},
+		};
+	}
+
+	FileSystem::createDirectories(cache_dir);
+	if (!JsonParser::writeJson(getManifestPath(), {{"version", manifest_version}, {"entries", std::move(json_entries)}}, 4))
+		return false;
+
+	dirty = false;
+	return true;
+}
+
+// JSON of a .gltf, or the JSON chunk of a .glb which the spec places first
+static nlohmann::json readGltfJson(const std::filesystem::path& source, bool binary)
+{
+	if (!binary)
+		return JsonParser::readJson(source);
+
+	constexpr uint32_t glb_magic = 0x46546C67;
+	constexpr uint32_t glb_chunk_json = 0x4E4F534A;
+
+	MappedFile file(source);
+	auto       bytes = file.getData();
+
+	auto read_u32 = [&bytes](size_t offset) {
+		uint32_t value;
+		std::memcpy(&value, bytes.data() + offset, sizeof(uint32_t));
+		return value;
+	};
+
+	if (bytes.size() < 20 || read_u32(0) != glb_magic || read_u32(16) != glb_chunk_json || 20 + size_t{read_u32(12)} > bytes.size())
+		throw std::runtime_error("Invalid GLB file: " + source.string());
+
+	return nlohmann::json::parse(bytes.begin() + 20, bytes.begin() + 20 + read_u32(12));
+}
+
+// A glTF depends on the external buffers and images its JSON references, a .glb usually has none
+std::vector<std::filesystem::path> AssetCache::getDependencies(const std::filesystem::path& source)
+{
+	std::vector<std::filesystem::path> files{source};
+
+	auto extension = source.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	if (extension != ".gltf" && extension != ".glb")
+		return files;
+
+	auto json = readGltfJson(source, extension == ".glb");
+	for (const auto* group : {"buffers", "images"}) {
+		if (!json.contains(group))
+			continue;
+
+		// Decoded like the importer resolves them, so the stamps name the files it reads
+		for (const auto& item : json[group]) {
+			auto uri = item.value("uri", std::string{});
+			if (!uri.empty() && !uri.starts_with("data:"))
+				files.push_back(source.parent_path() / FileSystem::decodeUri(uri));
+		}
+	}
+
+	return files;
+}
+
+uint64_t AssetCache::hashSource(const std::filesystem::path& source)
+{
+	uint64_t hash = 0;
+	for (const auto& file : getDependencies(source)) {
+		hash = Hash::combine(hash, Hash::xxh64(file.filename().generic_string()));
+		hash = Hash::combine(hash, FileSystem::exists(file) ? Hash::xxh64(MappedFile(file).getData()) : 0);
+	}
+
+	return hash;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+
+#include "Utils/SceneSerializer.hpp"
+
+// Everything that changes the cooked output, part of every cache key
+struct CookSettings {
+	uint32_t scene_format{SceneSerializer::version};
+	bool     optimize_meshes{true};
+	bool     generate_lods{true};
+	bool     build_meshlets{true};
+	bool     generate_mips{true};
+	bool     compress_textures{true};
+	bool     deduplicate_assets{true};
+	bool     bake_static{true};
+	bool     collapse_static{false};
+
+	uint64_t hash() const;
+};
+
+struct CacheStamp {
+	std::string path;
+	uint64_t    size{};
+	int64_t     time{};
+};
+
+struct CacheEntry {
+	uint64_t                source_hash{};
+	uint64_t                settings_hash{};
+	std::string             output;
+	std::vector<CacheStamp> stamps;
+};
+
+// Manifest of cooked assets under the cache directory, keyed by the source path relative to the assets directory.
+// An entry is current when its settings hash matches and either every file stamp or the content hash does
+class AssetCache {
+private:
+	std::filesystem::path assets_dir;
+	std::filesystem::path cache_dir;
+
+	std::unordered_map<std::string, CacheEntry> entries;
+	// Entries changed since the manifest was read or saved
+	bool dirty{false};
+
+	auto getKey(const std::filesystem::path& source) const -> std::optional<std::string>;
+	auto getStamps(const std::vector<std::filesystem::path>& files) const -> std::vector<CacheStamp>;
+
+public:
+	AssetCache(const std::filesystem::path& assets_dir, const std::filesystem::path& cache_dir);
+
+	auto getManifestPath() const -> std::filesystem::path;
+	auto getCookedPath(const std::filesystem::path& source) const -> std::filesystem::path;
+	// A hit on the content hash alone refreshes the stamps of the entry, save keeps them for the next run
+	auto findCooked(const std::filesystem::path& source, const CookSettings& settings = {}) -> std::optional<std::filesystem::path>;
+
+	auto makeEntry(const std::filesystem::path& source, const CookSettings& settings) const -> CacheEntry;
+	void addEntry(const std::filesystem::path& source, CacheEntry entry);
+	bool isDirty() const;
+	bool save();
+
+	static auto getDependencies(const std::filesystem::path& source) -> std::vector<std::filesystem::path>;
+	static auto hashSource(const std::filesystem::path& source) -> uint64_t;
+};
@@ -0,0 +1,122 @@
+#include "AssetDeduplicator.hpp"
+
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+
+#include "Core/Hash/Hash.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+#include "Scene/Resources/Texture.hpp"
+
+// Element bytes of an attribute without the stride padding, tightly packed data is returned in place
+static std::span<const uint8_t> packElements(const VertexAttribute& attribute, uint32_t count, std::vector<uint8_t>& scratch)
+{
+	uint32_t stride = attribute.stride > 0 ? attribute.stride : attribute.size;
+	if (count == 0 || attribute.data.size() < size_t{count - 1} * stride + attribute.size)
+		return {};
+	if (stride == attribute.size)
+		return attribute.data.first(size_t{count} * attribute.size);
+
+	scratch.resize(size_t{count} * attribute.size);
+	for (uint32_t i = 0; i < count; i++)
+		std::copy_n(attribute.data.data() + size_t{i} * stride, attribute.size, scratch.data() + size_t{i} * attribute.size);
+	return scratch;
+}
+
+// Attributes by name, the map order is not stable across submeshes
+static auto sortedAttributes(const SubMesh& submesh) -> std::vector<const std::pair<const std::string, VertexAttribute>*>
+{
+	std::vector<const std::pair<const std::string, VertexAttribute>*> attributes;
+	for (const auto& attribute : submesh.getAttributes())
+		attributes.push_back(&attribute);
+	std::sort(attributes.begin(), attributes.end(), [](auto a, auto b) { return a->first < b->first; });
+	return attributes;
+}
+
+static bool sameLayout(const VertexAttribute& a, const VertexAttribute& b)
+{
+	return a.size == b.size && a.components == b.components && a.component_type == b.component_type && a.normalized == b.normalized;
+}
+
+uint64_t AssetDeduplicator::hashTexture(const Texture& texture)
+{
+	auto seed = Hash::combine(Hash::xxh64(texture.getData()), static_cast<uint64_t>(texture.getFormat()));
+	seed = Hash::combine(seed, texture.getWidth());
+	seed = Hash::combine(seed, texture.getHeight());
+	seed = Hash::combine(seed, texture.isSrgb());
+	return Hash::combine(seed, texture.getMipCount());
+}
+
+// Indices are hashed as 32-bit values, so the same triangles stored at different widths still match
+uint64_t AssetDeduplicator::hashGeometry(const SubMesh& submesh)
+{
+	auto indices = submesh.getIndices();
+	auto seed = Hash::xxh64({reinterpret_cast<const uint8_t*>(indices.data()), indices.size() * sizeof(uint32_t)}, submesh.getVerticesCount());
+
+	std::vector<uint8_t> scratch;
+	for (const auto* attribute : sortedAttributes(submesh)) {
+		const auto& [name, data] = *attribute;
+		seed = Hash::combine(seed, Hash::xxh64(name));
+		seed = Hash::combine(seed, data.size);
+		seed = Hash::combine(seed, static_cast<uint64_t>(data.component_type));
+		seed = Hash::combine(seed, Hash::xxh64(packElements(data, submesh.getVerticesCount(), scratch)));
+	}
+	return seed;
+}
+
+bool AssetDeduplicator::equalTextures(const Texture& a, const Texture& b)
+{
+	if (a.getFormat() != b.getFormat() || a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.isSrgb() != b.isSrgb()
+	    || a.getMipCount() != b.getMipCount())
+		return false;
+
+	for (uint32_t level = 0; level < a.getMipCount(); level++) {
+		auto a_data = a.getMipData(level), b_data = b.getMipData(level);
+		if (!std::equal(a_data.begin(), a_data.end(), b_data.begin(), b_data.end()))
+			return false;
+	}
+	return true;
+}
+
+bool AssetDeduplicator::equalGeometry(const SubMesh& a, const SubMesh& b)
+{
+	if (a.getVerticesCount() != b.getVerticesCount() || a.getIndicesCount() != b.getIndicesCount()
+	    || a.getAttributes().size() != b.getAttributes().size() || a.getIndices() != b.getIndices())
+		return false;
+
+	std::vector<uint8_t> a_scratch, b_scratch;
+	for (const auto& [name, a_attribute] : a.getAttributes()) {
+		const auto* b_attribute = b.getAttribute(name);
+		if (!b_attribute || !sameLayout(a_attribute, *b_attribute))
+			return false;
+
+		auto a_data = packElements(a_attribute, a.getVerticesCount(), a_scratch);
+		auto b_data = packElements(*b_attribute, b.getVerticesCount(), b_scratch);
+		if (!std::equal(a_data.begin(), a_data.end(), b_data.begin(), b_data.end()))
+			return false;
+	}
+	return true;
+}
+
+uint64_t AssetDeduplicator::getGeometrySize(const SubMesh& submesh)
+{
+	uint64_t size = submesh.getIndexData().size() + submesh.getLodIndices().size_bytes();
+	for (const auto& [name, attribute] : submesh.getAttributes())
+		size += uint64_t{attribute.size} * submesh.getVerticesCount();
+	return size;
+}
+
+std::vector<uint32_t> AssetDeduplicator::findDuplicates(std::span<const uint64_t> hashes, const std::function<bool(size_t, size_t)>& equal)
+{
+	std::vector<uint32_t>                               canonical(hashes.size());
+	std::unordered_map<uint64_t, std::vector<uint32_t>> candidates;
+	for (uint32_t index = 0; index < hashes.size(); index++) {
+		auto& bucket = candidates[hashes[index]];
+		auto  it = std::find_if(bucket.begin(), bucket.end(), [&](uint32_t candidate) { return equal(candidate, index); });
+
+		canonical[index] = it != bucket.end() ? *it : index;
+		if (it == bucket.end())
+			bucket.push_back(index);
+	}
+	return canonical;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+class SubMesh;
+class Texture;
+
+// Content hashes of decoded pixels and vertex/index streams, so resources that only differ by identity can be merged
+class AssetDeduplicator {
+public:
+	static uint64_t hashTexture(const Texture& texture);
+	static uint64_t hashGeometry(const SubMesh& submesh);
+
+	static bool equalTextures(const Texture& a, const Texture& b);
+	static bool equalGeometry(const SubMesh& a, const SubMesh& b);
+
+	static uint64_t getGeometrySize(const SubMesh& submesh);
+
+	// For every item the index of the first item with the same content, hashes only pick the candidates to compare
+	static auto findDuplicates(std::span<const uint64_t> hashes, const std::function<bool(size_t, size_t)>& equal) -> std::vector<uint32_t>;
+};
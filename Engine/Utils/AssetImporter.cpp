@@ -4,9 +4,31 @@
 
 #include "AssetImporter.hpp"
 
+#include <format>
 #include <queue>
+#include <numeric>
+#include <mutex>
 #include <stdexcept>
 
+#include <nlohmann/json.hpp>
+
+#include "Core/Clock/Timer.hpp"
+#include "Core/Hash/Hash.hpp"
+#include "Core/File/FileSystem.hpp"
+#include "Core/File/MappedFile.hpp"
+#include "Core/File/PathResolver.hpp"
+#include "Core/Log/Logger.hpp"
+#include "Core/Thread/ThreadPool.hpp"
+#include "Utils/AssetCache.hpp"
+#include "Utils/AssetDeduplicator.hpp"
+#include "Utils/KtxLoader.hpp"
+#include "Utils/MeshOptimizer.hpp"
+#include "Utils/MeshSimplifier.hpp"
+#include "Utils/MeshletBuilder.hpp"
+#include "Utils/MipmapGenerator.hpp"
+#include "Utils/SceneSerializer.hpp"
+#include "Utils/TextureCompressor.hpp"
+
 static constexpr std::array attributes_names = {
     "POSITION",
     "NORMAL",
@@ -14,24 +36,142 @@ static constexpr std::array attributes_names = {
     "COLOR_0",
 };
 
-std::weak_ptr<Material> AssetImporter::default_pbr_material{};
-std::weak_ptr<Texture>  AssetImporter::default_base_color_texture{};
-std::weak_ptr<Texture>  AssetImporter::default_metallic_roughness_texture{};
+class ImportReport {
+private:
+	Timer total_timer;
+	Timer stage_timer;
+
+	std::vector<std::pair<std::string_view, float>> stages;
+
+	std::function<void(std::string_view)> on_stage;
+
+public:
+	ImportReport(std::function<void(std::string_view)> on_stage = {}) :
+	    on_stage(std::move(on_stage))
+	{
+		total_timer.start();
+		stage_timer.start();
+	}
+
+	void mark(std::string_view stage)
+	{
+		stages.emplace_back(stage, stage_timer.getElapsedMilliseconds());
+		stage_timer.start();
+
+		if (on_stage)
+			on_stage(stage);
+	}
+
+	void log(std::string_view scene_path, uint32_t thread_count) const
+	{
+		Logger::info(std::format("Imported {} in {:.2f} ms on {} thread(s)", scene_path, total_timer.getElapsedMilliseconds(), thread_count));
+		for (const auto& [stage, milliseconds] : stages)
+			Logger::info(std::format("    {:<14} {:>10.2f} ms", stage, milliseconds));
+	}
+};
+
+// Keep the encoded bytes and let the importer decode every image in parallel later
+static bool storeEncodedImage(tinygltf::Image* image, const int image_index, std::string* error, std::string* warning,
+    int req_width, int req_height, const unsigned char* bytes, int size, void* user_data)
+{
+	image->as_is = true;
+	image->image.assign(bytes, bytes + size);
+
+	return true;
+}
 
-std::unique_ptr<Scene> AssetImporter::loadScene(std::string_view scene_path)
+static void throwLoadError(const std::string& error, const std::string& warn)
 {
+	if (!error.empty())
+		throw std::runtime_error("Error: " + error);
+	if (!warn.empty())
+		throw std::runtime_error("Warning: " + warn);
+	throw std::runtime_error("Failed to load glTF file");
+}
+
+static std::span<const uint8_t> getByteRange(std::span<const uint8_t> bytes, size_t offset, size_t size)
+{
+	if (offset > bytes.size() || size > bytes.size() - offset)
+		throw std::runtime_error("glTF data range exceeds its buffer");
+
+	return bytes.subspan(offset, size);
+}
+
+static ComponentType toComponentType(int component_type)
+{
+	switch (component_type) {
+	case TINYGLTF_COMPONENT_TYPE_BYTE:
+		return ComponentType::Byte;
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		return ComponentType::UnsignedByte;
+	case TINYGLTF_COMPONENT_TYPE_SHORT:
+		return ComponentType::Short;
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		return ComponentType::UnsignedShort;
+	case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+		return ComponentType::UnsignedInt;
+	case TINYGLTF_COMPONENT_TYPE_FLOAT:
+		return ComponentType::Float;
+	default:
+		throw std::runtime_error("Unsupported accessor component type");
+	}
+}
+
+std::unique_ptr<Scene> AssetImporter::loadScene(std::string_view scene_path, const ImportSettings& settings)
+{
+	ImportReport report(settings.on_stage);
+
+	auto for_each = [&settings](size_t count, const std::function<void(size_t)>& func) {
+		if (settings.parallel)
+			ThreadPool::instance().parallelFor(count, func);
+		else
+			for (size_t i = 0; i < count; i++)
+				func(i);
+	};
+
 	// Load Scene
-	tinygltf::Model    model;
-	tinygltf::TinyGLTF loader;
-	std::string        error, warn;
-	if (!loader.LoadASCIIFromFile(&model, &error, &warn, scene_path.data())) {
-		if (!error.empty())
-			throw std::runtime_error("Error: " + error);
-		if (!warn.empty())
-			throw std::runtime_error("Warning: " + warn);
-		throw std::runtime_error("Failed to load glTF file");
+	std::filesystem::path path(scene_path);
+	auto                  extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+	std::optional<std::filesystem::path> cooked_path;
+	if (extension == ".vxscene")
+		cooked_path = path;
+	else if (settings.use_cache) {
+		// Scenes may load in parallel, the manifest is read and rewritten by one of them at a time
+		static std::mutex manifest_mutex;
+		std::lock_guard   lock(manifest_mutex);
+
+		AssetCache cache(PathResolver::getAssetsDir(), PathResolver::getCacheDir());
+		cooked_path = cache.findCooked(path, {
+		    .optimize_meshes = settings.optimize_meshes,
+		    .generate_lods = settings.generate_lods,
+		    .build_meshlets = settings.build_meshlets,
+		    .generate_mips = settings.generate_mips,
+		    .compress_textures = settings.compress_textures,
+		    .deduplicate_assets = settings.deduplicate_assets,
+		    .bake_static = settings.bake_static,
+		    .collapse_static = settings.collapse_static,
+		});
+		if (cache.isDirty() && !cache.save())
+			Logger::warn("Failed to update " + cache.getManifestPath().string());
+	}
+
+	if (cooked_path) {
+		auto scene = SceneSerializer::load(*cooked_path);
+		initDefaultCameraController(*scene);
+		report.mark("Load Cooked");
+
+		if (settings.report_timings)
+			report.log(scene_path, 1);
+
+		return scene;
 	}
 
+	auto  document = extension == ".glb" ? loadGlb(path) : loadGltf(path);
+	auto& model = document.model;
+	report.mark("Parse");
+
 	auto scene = std::make_unique<Scene>();
 	scene->setName("Default Scene");
 
@@ -49,60 +189,190 @@ std::unique_ptr<Scene> AssetImporter::loadScene(std::string_view scene_path)
 	if (!lights.empty())
 		scene->setComponents(std::move(lights));
 
+	// Decode Images
+	document.image_textures.resize(model.images.size());
+	for_each(model.images.size(), [&document](size_t index) {
+		auto& tfimage = document.model.images[index];
+		if (KtxLoader::isKtx2(document.images[index])) {
+			try {
+				document.image_textures[index] = KtxLoader::load(tfimage.name, document.images[index], document.image_storages[index]);
+			} catch (const std::exception& e) {
+				Logger::warn(std::format("Skipping KTX2 image {}: {}", tfimage.name.empty() ? tfimage.uri : tfimage.name, e.what()));
+			}
+		} else
+			decodeImage(tfimage, document.images[index]);
+	});
+	document.images.clear();
+	document.image_storages.clear();
+	report.mark("Decode Images");
+
 	// Load Textures
-	std::vector<std::shared_ptr<Texture>> textures;
-	for (const auto& tftexture : model.textures)
-		textures.push_back(parseTexture(tftexture, model));
+	std::vector<std::shared_ptr<Texture>> textures(model.textures.size());
+	for_each(model.textures.size(), [&](size_t index) {
+		textures[index] = parseTexture(model.textures[index], document);
+	});
 	if (!textures.empty())
 		scene->setResources(std::move(textures));
-	initDefaultTextures(*scene);
+	ImportDefaults defaults;
+	initDefaultTextures(*scene, defaults);
+	report.mark("Textures");
 
 	// Load Materials
 	std::vector<std::shared_ptr<Material>> materials;
+	auto                                   material_textures = scene->getResources<Texture>().share();
 	for (size_t i = 0; i < model.materials.size(); i++)
-		materials.push_back(parseMaterial(model.materials[i], model, scene->getResources<Texture>()));
+		materials.push_back(parseMaterial(model.materials[i], model, material_textures, defaults));
 	if (!materials.empty())
 		scene->setResources(std::move(materials));
-	initDefaultMaterials(*scene);
+	initDefaultMaterials(*scene, defaults);
+	report.mark("Materials");
+
+	// Identical images collapse once the materials have decided sRGB, before any per texture work
+	uint64_t saved_bytes = 0;
+	size_t   texture_duplicates = 0;
+	if (settings.deduplicate_assets) {
+		auto                  scene_textures = scene->getResources<Texture>().share();
+		std::vector<uint64_t> hashes(scene_textures.size());
+		for_each(scene_textures.size(), [&](size_t index) {
+			hashes[index] = AssetDeduplicator::hashTexture(*scene_textures[index]);
+		});
+
+		auto canonical = AssetDeduplicator::findDuplicates(hashes, [&](size_t a, size_t b) {
+			return AssetDeduplicator::equalTextures(*scene_textures[a], *scene_textures[b]);
+		});
+
+		std::unordered_map<const Texture*, std::shared_ptr<Texture>> replacements;
+		std::vector<std::shared_ptr<Texture>>                        unique_textures;
+		for (size_t index = 0; index < scene_textures.size(); index++) {
+			if (canonical[index] == index) {
+				unique_textures.push_back(scene_textures[index]);
+				continue;
+			}
+			replacements[scene_textures[index].get()] = scene_textures[canonical[index]];
+			saved_bytes += scene_textures[index]->getData().size();
+		}
+
+		for (const auto& material : scene->getResources<Material>())
+			for (auto& [slot, texture] : material->getTextures())
+				if (auto it = replacements.find(texture.get()); it != replacements.end())
+					texture = it->second;
+
+		texture_duplicates = replacements.size();
+		if (texture_duplicates > 0)
+			scene->setResources(std::move(unique_textures));
+		report.mark("Dedup Textures");
+	}
+
+	// Mip chains wait for the materials, they decide which textures hold color and which hold linear data
+	if (settings.generate_mips) {
+		auto scene_textures = scene->getResources<Texture>();
+		for_each(scene_textures.size(), [&](size_t index) {
+			MipmapGenerator::generateMips(*scene_textures[index]);
+		});
+		report.mark("Mipmaps");
+	}
+
+	if (settings.compress_textures) {
+		auto scene_textures = scene->getResources<Texture>();
+		for_each(scene_textures.size(), [&](size_t index) {
+			TextureCompressor::compress(*scene_textures[index]);
+		});
+		report.mark("Compress");
+	}
 
 	// Load Meshes
-	for (const auto& tfmesh : model.meshes) {
-		auto mesh = parseMesh(tfmesh);
-		for (auto index = 0; index < tfmesh.primitives.size(); index++) {
-			auto submesh = parseSubmesh(tfmesh, model, index, scene->getResources<Material>());
-			auto shared_submesh = std::shared_ptr<SubMesh>(std::move(submesh));
-			mesh->addSubmesh(shared_submesh);
-			scene->addResource<SubMesh>(shared_submesh);
+	std::vector<std::pair<uint32_t, uint32_t>> primitives;
+	for (uint32_t mesh_index = 0; mesh_index < model.meshes.size(); mesh_index++)
+		for (uint32_t primitive_index = 0; primitive_index < model.meshes[mesh_index].primitives.size(); primitive_index++)
+			primitives.emplace_back(mesh_index, primitive_index);
+
+	auto primitive_mode = [&](size_t index) {
+		auto mode = model.meshes[primitives[index].first].primitives[primitives[index].second].mode;
+		return mode == -1 ? TINYGLTF_MODE_TRIANGLES : mode;
+	};
+
+	auto                                  scene_materials = scene->getResources<Material>().share();
+	std::vector<std::shared_ptr<SubMesh>> submeshes(primitives.size());
+	std::vector<uint64_t>                 geometry_hashes(primitives.size());
+	for_each(primitives.size(), [&](size_t index) {
+		auto [mesh_index, primitive_index] = primitives[index];
+		submeshes[index] = parseSubmesh(model.meshes[mesh_index], document, primitive_index, scene_materials, defaults);
+		if (settings.deduplicate_assets)
+			geometry_hashes[index] = Hash::combine(AssetDeduplicator::hashGeometry(*submeshes[index]), primitive_mode(index));
+	});
+
+	// Duplicated primitives keep their own submesh (material, transform) but are processed once and share its streams
+	std::vector<uint32_t> geometry_sources(primitives.size());
+	std::iota(geometry_sources.begin(), geometry_sources.end(), 0u);
+	if (settings.deduplicate_assets)
+		geometry_sources = AssetDeduplicator::findDuplicates(geometry_hashes, [&](size_t a, size_t b) {
+			return primitive_mode(a) == primitive_mode(b) && AssetDeduplicator::equalGeometry(*submeshes[a], *submeshes[b]);
+		});
+
+	size_t geometry_duplicates = 0;
+	for (size_t index = 0; index < primitives.size(); index++) {
+		if (geometry_sources[index] != index) {
+			saved_bytes += AssetDeduplicator::getGeometrySize(*submeshes[index]);
+			geometry_duplicates++;
+		}
+	}
+
+	for_each(primitives.size(), [&](size_t index) {
+		if (geometry_sources[index] != index || primitive_mode(index) != TINYGLTF_MODE_TRIANGLES)
+			return;
+		if (settings.optimize_meshes)
+			MeshOptimizer::optimize(*submeshes[index]);
+		if (settings.generate_lods)
+			MeshSimplifier::generateLods(*submeshes[index]);
+		if (settings.build_meshlets)
+			MeshletBuilder::buildMeshlets(*submeshes[index]);
+	});
+
+	for (size_t index = 0; index < primitives.size(); index++)
+		if (geometry_sources[index] != index)
+			submeshes[index]->shareGeometry(*submeshes[geometry_sources[index]]);
+	report.mark("SubMeshes");
+
+	if (settings.deduplicate_assets)
+		Logger::info(std::format("Deduplicated {} texture(s) and {} submesh(es) of {}, {:.2f} MB saved", texture_duplicates,
+		    geometry_duplicates, scene_path, static_cast<double>(saved_bytes) / (1024.0 * 1024.0)));
+
+	for (size_t mesh_index = 0, submesh_index = 0; mesh_index < model.meshes.size(); mesh_index++) {
+		auto mesh = parseMesh(model.meshes[mesh_index]);
+		for (; submesh_index < primitives.size() && primitives[submesh_index].first == mesh_index; submesh_index++) {
+			mesh->addSubmesh(submeshes[submesh_index]);
+			scene->addResource<SubMesh>(submeshes[submesh_index]);
 		}
 		scene->addComponent(std::move(mesh));
 	}
 
 	// Load Nodes
+	auto scene_meshes = scene->getComponents<Mesh>();
+	auto scene_cameras = scene->getComponents<Camera>();
+	auto scene_lights = scene->getComponents<Light>();
+
 	std::vector<std::unique_ptr<Node>> nodes;
 	for (size_t index = 0; index < model.nodes.size(); index++) {
-		auto tfnode = model.nodes[index];
-		auto node = parseNode(tfnode);
+		const auto& tfnode = model.nodes[index];
+		auto        node = parseNode(tfnode);
 
 		if (tfnode.mesh >= 0) {
-			auto meshes = scene->getComponents<Mesh>();
-			assert(tfnode.mesh < meshes.size());
-			auto mesh = meshes[tfnode.mesh];
+			assert(tfnode.mesh < scene_meshes.size());
+			auto mesh = scene_meshes[tfnode.mesh];
 			node->setComponent(*mesh);
 			mesh->setNode(*node);
 		}
 
 		if (tfnode.camera >= 0) {
-			auto cameras = scene->getComponents<Camera>();
-			assert(tfnode.camera < cameras.size());
-			auto camera = cameras[tfnode.camera];
+			assert(tfnode.camera < scene_cameras.size());
+			auto camera = scene_cameras[tfnode.camera];
 			node->setComponent(*camera);
 			camera->setNode(*node);
 		}
 
 		if (tfnode.light >= 0) {
-			auto lights = scene->getComponents<Light>();
-			assert(tfnode.light < lights.size());
-			auto light = lights[tfnode.light];
+			assert(tfnode.light < scene_lights.size());
+			auto light = scene_lights[tfnode.light];
 			node->setComponent(*light);
 			light->setNode(*node);
 		}
@@ -110,14 +380,27 @@ std::unique_ptr<Scene> AssetImporter::loadScene(std::string_view scene_path)
 		nodes.push_back(std::move(node));
 	}
 
+	// Nothing moves a glTF node after import but its animations, and cameras are driven by controllers
+	if (settings.bake_static) {
+		std::vector<uint8_t> animated(model.nodes.size(), 0);
+		for (const auto& animation : model.animations)
+			for (const auto& channel : animation.channels)
+				if (channel.target_node >= 0 && static_cast<size_t>(channel.target_node) < animated.size())
+					animated[channel.target_node] = 1;
+
+		for (size_t index = 0; index < nodes.size(); index++)
+			nodes[index]->setStatic(!animated[index] && model.nodes[index].camera < 0);
+	}
+
 	// Load Scenes
 	std::queue<std::pair<Node&, int>> traverse_nodes;
 
-	tinygltf::Scene* tfscene = &model.scenes.front();
-	if (!tfscene)
+	if (model.scenes.empty())
 		throw std::runtime_error("No default scene found in glTF file");
+	tinygltf::Scene* tfscene = &model.scenes.front();
 
 	auto root_node = std::make_unique<Node>(tfscene->name);
+	root_node->setStatic(settings.bake_static);
 	for (auto node_index : tfscene->nodes)
 		traverse_nodes.push({std::ref(*root_node), node_index});
 
@@ -142,6 +425,18 @@ std::unique_ptr<Scene> AssetImporter::loadScene(std::string_view scene_path)
 	initDefaultCamera(*scene);
 	initDefaultLight(*scene);
 	initDefaultCameraController(*scene);
+	if (settings.collapse_static)
+		scene->collapseStaticHierarchy();
+	report.mark("Scene Graph");
+
+	if (settings.write_cooked) {
+		auto cooked_path = path;
+		SceneSerializer::save(*scene, cooked_path.replace_extension(".vxscene"));
+		report.mark("Write Cooked");
+	}
+
+	if (settings.report_timings)
+		report.log(scene_path, settings.parallel ? ThreadPool::instance().getWorkerCount() + 1 : 1);
 
 	return scene;
 }
@@ -221,113 +516,123 @@ std::unique_ptr<Light> AssetImporter::parseLight(const tinygltf::Light& tflight)
 	return light;
 }
 
-std::shared_ptr<SubMesh> AssetImporter::parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& tfmodel, uint32_t index, const std::vector<std::shared_ptr<Material>>& materials)
+std::shared_ptr<SubMesh> AssetImporter::parseSubmesh(const tinygltf::Mesh& tfmesh, const GltfDocument& document, uint32_t index, const std::vector<std::shared_ptr<Material>>& materials, const ImportDefaults& defaults)
 {
 	auto submesh = std::make_shared<SubMesh>(tfmesh.name);
 
+	const auto& tfmodel = document.model;
 	const auto& tfprimitive = tfmesh.primitives[index];
 
-	// Load Vertices
-	struct AttributeData {
-		std::string              name;
-		uint32_t                 size;
-		std::span<const uint8_t> data_view;
+	auto get_storage = [&document, &tfmodel](uint32_t accessor_id) -> std::shared_ptr<const void> {
+		const auto& buffer_view = tfmodel.bufferViews[tfmodel.accessors[accessor_id].bufferView];
+		return document.buffer_storages[buffer_view.buffer];
 	};
 
-	std::map<std::string, AttributeData> attributes_map;
+	// Load Vertices, attributes stay as views into the source buffers
+	uint32_t vertex_count = 0;
 	for (const auto& [attr_name, accessor_id] : tfprimitive.attributes) {
 		auto upper_name = attr_name;
 		std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
 		if (std::find(attributes_names.begin(), attributes_names.end(), upper_name) == attributes_names.end())
 			continue;
 
-		attributes_map[upper_name] = AttributeData{
-		    .name = upper_name,
+		auto data_view = getAttributeDataView(document, accessor_id);
+		if (data_view.empty())
+			continue;
+
+		const auto&     accessor = tfmodel.accessors[accessor_id];
+		VertexAttribute attribute{
 		    .size = getAttributeSize(&tfmodel, accessor_id),
-		    .data_view = getAttributeDataView(tfmodel, accessor_id),
+		    .stride = getAttributeStride(&tfmodel, accessor_id),
+		    .components = static_cast<uint32_t>(tinygltf::GetNumComponentsInType(accessor.type)),
+		    .component_type = toComponentType(accessor.componentType),
+		    .normalized = accessor.normalized,
+		    .data = data_view,
+		    .storage = get_storage(accessor_id),
 		};
-	}
-
-	uint32_t vertex_count = getAttributeCount(&tfmodel, tfprimitive.attributes.begin()->second);
-	uint32_t vertex_stride = 0;
-	for (const auto& attribute_name : attributes_names) {
-		if (!attributes_map.contains(attribute_name))
-			continue;
+		submesh->setAttribute(upper_name, attribute);
 
-		auto&    attribute = attributes_map.at(attribute_name);
-		uint32_t offset = vertex_stride;
+		auto count = getAttributeCount(&tfmodel, accessor_id);
+		vertex_count = vertex_count == 0 ? count : std::min(vertex_count, count);
 
-		submesh->setAttribute(attribute_name, {attribute.size, offset});
-		vertex_stride += attribute.size;
+		// glTF requires min/max on float positions, they become the submesh bounds
+		if (upper_name == "POSITION" && accessor.minValues.size() == 3 && accessor.maxValues.size() == 3 && !accessor.normalized && attribute.component_type == ComponentType::Float)
+			submesh->setBounds(
+			    {static_cast<float>(accessor.minValues[0]), static_cast<float>(accessor.minValues[1]), static_cast<float>(accessor.minValues[2])},
+			    {static_cast<float>(accessor.maxValues[0]), static_cast<float>(accessor.maxValues[1]), static_cast<float>(accessor.maxValues[2])});
 	}
-
-	std::vector<uint8_t> vertices_raw_data(vertex_count * vertex_stride);
-	for (const auto& attribute_name : attributes_names) {
-		if (!attributes_map.contains(attribute_name))
-			continue;
-
-		const auto& attribute = attributes_map.at(attribute_name);
-		const auto& submesh_attribute = submesh->getAttribute(attribute_name);
-		uint32_t    offset = submesh_attribute->offset;
-
-		for (uint32_t vertex_index = 0; vertex_index < vertex_count; vertex_index++) {
-			std::memcpy(&vertices_raw_data[vertex_index * vertex_stride + offset],
-			    &attribute.data_view[vertex_index * attribute.size],
-			    attribute.size);
+	submesh->setVerticesCount(vertex_count);
+
+	if (!submesh->hasBounds()) {
+		auto positions = MeshOptimizer::getPositions(*submesh);
+		if (!positions.empty()) {
+			glm::vec3 min = positions.front(), max = positions.front();
+			for (const auto& p : positions) {
+				min = glm::min(min, p);
+				max = glm::max(max, p);
+			}
+			submesh->setBounds(min, max);
 		}
 	}
 
-	std::vector<float> vertices_data(vertices_raw_data.size() / sizeof(float));
-	std::memcpy(vertices_data.data(), vertices_raw_data.data(), vertices_raw_data.size());
-	submesh->setVertices(std::move(vertices_data), vertex_count);
-
 	// Load Indices
 	if (tfprimitive.indices >= 0) {
-		auto indices_raw_data = getAttributeDataView(tfmodel, tfprimitive.indices);
-		auto index_byte_size = getAttributeSize(&tfmodel, tfprimitive.indices);
-
-		std::vector<uint32_t> indices_data;
-		switch (index_byte_size) {
-		case 1:
-			indices_data = convertData<uint8_t, uint32_t>(indices_raw_data);
-			break;
-		case 2:
-			indices_data = convertData<uint16_t, uint32_t>(indices_raw_data);
-			break;
-		case 4:
-			indices_data = convertData<uint32_t, uint32_t>(indices_raw_data);
-			break;
-		default:
-			throw std::runtime_error("Unsupported index byte size");
-		}
-
-		submesh->setIndices(std::move(indices_data));
+		auto index_view = getAttributeDataView(document, tfprimitive.indices);
+		if (!index_view.empty())
+			submesh->setIndices(index_view, getAttributeSize(&tfmodel, tfprimitive.indices), get_storage(tfprimitive.indices));
 	}
 
 	// Load Materials
 	if (tfprimitive.material >= 0 && tfprimitive.material < tfmodel.materials.size())
 		submesh->setMaterial(materials[tfprimitive.material]);
 	else
-		submesh->setMaterial(default_pbr_material.lock());
+		submesh->setMaterial(defaults.material);
 
 	return submesh;
 }
 
-std::shared_ptr<Texture> AssetImporter::parseTexture(const tinygltf::Texture& tftexture, const tinygltf::Model& tfmodel)
+std::shared_ptr<Texture> AssetImporter::parseTexture(const tinygltf::Texture& tftexture, const GltfDocument& document)
 {
-	auto texture = std::make_shared<Texture>(tftexture.name);
+	const auto& tfmodel = document.model;
+	auto        texture = std::make_shared<Texture>(tftexture.name);
+
+	// KHR_texture_basisu points at a KTX2 image, the plain source stays the fallback when it could not be loaded
+	auto source = tftexture.source;
+	if (auto it = tftexture.extensions.find("KHR_texture_basisu"); it != tftexture.extensions.end() && it->second.Has("source")) {
+		auto ktx_source = it->second.Get("source").GetNumberAsInt();
+		if (ktx_source >= 0 && ktx_source < static_cast<int>(document.image_textures.size()) && document.image_textures[ktx_source])
+			source = ktx_source;
+	}
 
-	const auto& tfimage = tfmodel.images[tftexture.source];
-	if (tftexture.source < 0 || tftexture.source >= static_cast<int>(tfmodel.images.size()))
+	if (source < 0 || source >= static_cast<int>(tfmodel.images.size()))
 		return texture;
-	else if (tfimage.width == 0 || tfimage.height == 0 || tfimage.image.empty())
+
+	// Textures sharing a KTX2 image reference its levels instead of copying them
+	if (source < static_cast<int>(document.image_textures.size()) && document.image_textures[source]) {
+		const auto& image_texture = document.image_textures[source];
+		texture->setWidth(image_texture->getWidth());
+		texture->setHeight(image_texture->getHeight());
+		texture->setFormat(image_texture->getFormat());
+		texture->setSrgb(image_texture->isSrgb());
+		texture->setData(image_texture->getData(), image_texture);
+
+		std::vector<TextureMip> mips;
+		for (uint32_t level = 0; image_texture->getMipCount() > 1 && level < image_texture->getMipCount(); level++)
+			mips.push_back(image_texture->getMip(level));
+		texture->setMips(std::move(mips));
+
+		return texture;
+	}
+
+	const auto& tfimage = tfmodel.images[source];
+	if (tfimage.as_is || tfimage.width == 0 || tfimage.height == 0 || tfimage.image.empty())
 		return texture;
 	else if (tfimage.component != 3 && tfimage.component != 4)
 		throw std::runtime_error("Unsupported image component count");
 
 	texture->setWidth(tfimage.width);
 	texture->setHeight(tfimage.height);
-	texture->setFormat(4);
+	texture->setFormat(TextureFormat::RGBA8);
 
 	std::vector<uint8_t> rgba_data;
 	if (tfimage.component == 4)
@@ -347,7 +652,7 @@ std::shared_ptr<Texture> AssetImporter::parseTexture(const tinygltf::Texture& tf
 	return texture;
 }
 
-std::shared_ptr<Material> AssetImporter::parseMaterial(const tinygltf::Material& tfmaterial, const tinygltf::Model& tfmodel, const std::vector<std::shared_ptr<Texture>>& textures)
+std::shared_ptr<Material> AssetImporter::parseMaterial(const tinygltf::Material& tfmaterial, const tinygltf::Model& tfmodel, const std::vector<std::shared_ptr<Texture>>& textures, const ImportDefaults& defaults)
 {
 	auto material = std::make_shared<PBRMaterial>(tfmaterial.name);
 
@@ -364,12 +669,13 @@ std::shared_ptr<Material> AssetImporter::parseMaterial(const tinygltf::Material&
 	if (pbr.baseColorTexture.index >= 0 && pbr.baseColorTexture.index < textures.size())
 		material->addTexture("baseColor", textures[pbr.baseColorTexture.index]);
 	else
-		material->addTexture("baseColor", default_base_color_texture.lock());
+		material->addTexture("baseColor", defaults.base_color_texture);
 
-	if (pbr.metallicRoughnessTexture.index >= 0 && pbr.metallicRoughnessTexture.index < textures.size())
+	if (pbr.metallicRoughnessTexture.index >= 0 && pbr.metallicRoughnessTexture.index < textures.size()) {
+		textures[pbr.metallicRoughnessTexture.index]->setSrgb(false);
 		material->addTexture("metallicRoughness", textures[pbr.metallicRoughnessTexture.index]);
-	else
-		material->addTexture("metallicRoughness", default_metallic_roughness_texture.lock());
+	} else
+		material->addTexture("metallicRoughness", defaults.metallic_roughness_texture);
 
 	material->setEmissive({static_cast<float>(tfmaterial.emissiveFactor[0]),
 	    static_cast<float>(tfmaterial.emissiveFactor[1]),
@@ -388,6 +694,27 @@ std::shared_ptr<Material> AssetImporter::parseMaterial(const tinygltf::Material&
 	return material;
 }
 
+void AssetImporter::decodeImage(tinygltf::Image& tfimage, std::span<const uint8_t> encoded)
+{
+	if (!tfimage.as_is || encoded.empty())
+		return;
+
+	int  width = 0, height = 0, channels = 0;
+	auto pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, 4);
+	if (!pixels)
+		throw std::runtime_error(std::format("Failed to decode image {}: {}", tfimage.name.empty() ? tfimage.uri : tfimage.name, stbi_failure_reason()));
+
+	tfimage.width = width;
+	tfimage.height = height;
+	tfimage.component = 4;
+	tfimage.bits = 8;
+	tfimage.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+	tfimage.image.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+	tfimage.as_is = false;
+
+	stbi_image_free(pixels);
+}
+
 std::unique_ptr<Camera> AssetImporter::createDefaultCamera(const std::string& name)
 {
 	auto camera = std::make_unique<PerspectiveCamera>(name);
@@ -413,7 +740,7 @@ std::shared_ptr<Texture> AssetImporter::createDefaultTexture(const std::string&
 	auto texture = std::make_shared<Texture>(name);
 	texture->setWidth(1);
 	texture->setHeight(1);
-	texture->setFormat(4);
+	texture->setFormat(TextureFormat::RGBA8);
 	texture->setData({255, 255, 255, 255});
 
 	return texture;
@@ -473,51 +800,177 @@ void AssetImporter::initDefaultCameraController(Scene& scene)
 	scene.addBehaviour(std::move(camera_controller), *default_camera->getNode());
 }
 
-void AssetImporter::initDefaultTextures(Scene& scene)
+void AssetImporter::initDefaultTextures(Scene& scene, ImportDefaults& defaults)
 {
 	auto dbct = createDefaultTexture("Default_Base_Color_Texture");
 	dbct->setData({255, 255, 255, 255});
-	default_base_color_texture = dbct;
+	defaults.base_color_texture = dbct;
 	scene.addResource<Texture>(dbct);
 
 	auto dmrt = createDefaultTexture("Default_Metallic_Roughness_Texture");
 	dmrt->setData({255, 255, 255, 255});
-	default_metallic_roughness_texture = dmrt;
+	dmrt->setSrgb(false);
+	defaults.metallic_roughness_texture = dmrt;
 	scene.addResource<Texture>(dmrt);
 }
 
-void AssetImporter::initDefaultMaterials(Scene& scene)
+void AssetImporter::initDefaultMaterials(Scene& scene, ImportDefaults& defaults)
 {
 	auto dpm = createDefaultMaterial("Default_PBR_Material");
-	dpm->addTexture("baseColor", default_base_color_texture.lock());
-	dpm->addTexture("metallicRoughness", default_metallic_roughness_texture.lock());
-	default_pbr_material = dpm;
+	dpm->addTexture("baseColor", defaults.base_color_texture);
+	dpm->addTexture("metallicRoughness", defaults.metallic_roughness_texture);
+	defaults.material = dpm;
 	scene.addResource<Material>(dpm);
 }
 
-std::vector<uint8_t> AssetImporter::getAttributeData(const tinygltf::Model& tfmodel, uint32_t accessor_index)
+GltfDocument AssetImporter::loadGltf(const std::filesystem::path& path)
 {
-	auto view = getAttributeDataView(tfmodel, accessor_index);
+	GltfDocument       document;
+	tinygltf::TinyGLTF loader;
+	std::string        error, warn;
+	loader.SetImageLoader(storeEncodedImage, nullptr);
+	if (!loader.LoadASCIIFromFile(&document.model, &error, &warn, path.string()))
+		throwLoadError(error, warn);
+
+	// Buffers move into shared storage so submesh views outlive the model
+	auto buffers = std::make_shared<const std::vector<tinygltf::Buffer>>(std::move(document.model.buffers));
+	for (const auto& buffer : *buffers) {
+		document.buffers.emplace_back(buffer.data);
+		document.buffer_storages.push_back(buffers);
+	}
+
+	for (const auto& image : document.model.images) {
+		document.images.emplace_back(image.image);
+		document.image_storages.emplace_back();
+	}
+
+	return document;
+}
+
+GltfDocument AssetImporter::loadGlb(const std::filesystem::path& path)
+{
+	constexpr uint32_t glb_magic = 0x46546C67;
+	constexpr uint32_t glb_version = 2;
+	constexpr uint32_t glb_chunk_json = 0x4E4F534A;
+	constexpr uint32_t glb_chunk_bin = 0x004E4942;
+
+	auto file = std::make_shared<const MappedFile>(path);
+	auto bytes = file->getData();
+
+	auto read_u32 = [&bytes](size_t offset) {
+		uint32_t value;
+		std::memcpy(&value, bytes.data() + offset, sizeof(uint32_t));
+		return value;
+	};
+
+	if (bytes.size() < 12 || read_u32(0) != glb_magic || read_u32(4) != glb_version)
+		throw std::runtime_error("Invalid GLB header: " + path.string());
+
+	std::span<const uint8_t> json_chunk, bin_chunk;
+	size_t                   length = std::min<size_t>(read_u32(8), bytes.size());
+	for (size_t offset = 12; offset + 8 <= length;) {
+		size_t   chunk_length = read_u32(offset);
+		uint32_t chunk_type = read_u32(offset + 4);
+		offset += 8;
+
+		auto chunk = getByteRange(bytes.first(length), offset, chunk_length);
+		if (chunk_type == glb_chunk_json && json_chunk.empty())
+			json_chunk = chunk;
+		else if (chunk_type == glb_chunk_bin && bin_chunk.empty())
+			bin_chunk = chunk;
+
+		offset += (chunk_length + 3) & ~size_t{3};
+	}
+
+	if (json_chunk.empty())
+		throw std::runtime_error("GLB file has no JSON chunk: " + path.string());
 
-	return {view.begin(), view.end()};
+	// tinygltf only sees the JSON, buffers and images are resolved here so the binary chunk is never copied
+	auto json = nlohmann::json::parse(json_chunk.begin(), json_chunk.end());
+	auto json_buffers = json.contains("buffers") ? std::move(json["buffers"]) : nlohmann::json::array();
+	auto json_images = json.contains("images") ? std::move(json["images"]) : nlohmann::json::array();
+	json.erase("buffers");
+	json.erase("images");
+
+	GltfDocument       document;
+	tinygltf::TinyGLTF loader;
+	std::string        error, warn;
+	auto               json_string = json.dump();
+	auto               base_dir = path.parent_path();
+	if (!loader.LoadASCIIFromString(&document.model, &error, &warn, json_string.data(), static_cast<unsigned int>(json_string.size()), base_dir.string()))
+		throwLoadError(error, warn);
+
+	auto resolve_uri = [&base_dir](const std::string& uri) -> std::pair<std::span<const uint8_t>, std::shared_ptr<const void>> {
+		if (tinygltf::IsDataURI(uri)) {
+			auto        decoded = std::make_shared<std::vector<unsigned char>>();
+			std::string mime_type;
+			if (!tinygltf::DecodeDataURI(decoded.get(), mime_type, uri, 0, false))
+				throw std::runtime_error("Failed to decode data URI");
+			return {*decoded, decoded};
+		}
+
+		auto mapped = std::make_shared<const MappedFile>(base_dir / FileSystem::decodeUri(uri));
+		return {mapped->getData(), mapped};
+	};
+
+	for (const auto& json_buffer : json_buffers) {
+		auto [data, storage] = json_buffer.contains("uri") ? resolve_uri(json_buffer["uri"].get<std::string>()) : std::pair{bin_chunk, std::shared_ptr<const void>(file)};
+
+		document.buffers.push_back(getByteRange(data, 0, json_buffer.value("byteLength", size_t{0})));
+		document.buffer_storages.push_back(std::move(storage));
+	}
+
+	for (const auto& json_image : json_images) {
+		tinygltf::Image image;
+		image.name = json_image.value("name", "");
+		image.uri = json_image.value("uri", "");
+		image.mimeType = json_image.value("mimeType", "");
+		image.bufferView = json_image.value("bufferView", -1);
+		image.as_is = true;
+
+		std::pair<std::span<const uint8_t>, std::shared_ptr<const void>> source{};
+		if (image.bufferView >= 0) {
+			if (image.bufferView >= static_cast<int>(document.model.bufferViews.size()))
+				throw std::runtime_error("Image bufferView index out of range");
+
+			const auto& buffer_view = document.model.bufferViews[image.bufferView];
+			if (buffer_view.buffer < 0 || buffer_view.buffer >= static_cast<int>(document.buffers.size()))
+				throw std::runtime_error("BufferView buffer index out of range");
+
+			source.first = getByteRange(document.buffers[buffer_view.buffer], buffer_view.byteOffset, buffer_view.byteLength);
+		} else if (!image.uri.empty())
+			source = resolve_uri(image.uri);
+
+		document.model.images.push_back(std::move(image));
+		document.images.push_back(source.first);
+		document.image_storages.push_back(std::move(source.second));
+	}
+
+	return document;
 }
 
-std::span<const uint8_t> AssetImporter::getAttributeDataView(const tinygltf::Model& tfmodel, uint32_t accessor_index)
+std::span<const uint8_t> AssetImporter::getAttributeDataView(const GltfDocument& document, uint32_t accessor_index)
 {
-	assert(accessor_index < tfmodel.accessors.size());
+	const auto& tfmodel = document.model;
+	if (accessor_index >= tfmodel.accessors.size())
+		throw std::runtime_error("Accessor index out of range");
+
 	const auto& accessor = tfmodel.accessors[accessor_index];
+	if (accessor.bufferView < 0 || accessor.count == 0)
+		return {};
+	if (accessor.bufferView >= static_cast<int>(tfmodel.bufferViews.size()))
+		throw std::runtime_error("Accessor bufferView index out of range");
 
-	assert(accessor.bufferView < tfmodel.bufferViews.size());
 	const auto& buffer_view = tfmodel.bufferViews[accessor.bufferView];
+	if (buffer_view.buffer < 0 || buffer_view.buffer >= static_cast<int>(document.buffers.size()))
+		throw std::runtime_error("BufferView buffer index out of range");
 
-	assert(buffer_view.buffer < tfmodel.buffers.size());
-	const auto& buffer = tfmodel.buffers[buffer_view.buffer];
-
-	auto stride = accessor.ByteStride(buffer_view);
-	auto start_byte = accessor.byteOffset + buffer_view.byteOffset;
-	auto end_byte = start_byte + accessor.count * stride;
+	// The last element only spans its own size, not a full stride
+	size_t stride = getAttributeStride(&tfmodel, accessor_index);
+	size_t length = (accessor.count - 1) * stride + getAttributeSize(&tfmodel, accessor_index);
+	auto   view_data = getByteRange(document.buffers[buffer_view.buffer], buffer_view.byteOffset, buffer_view.byteLength);
 
-	return {buffer.data.begin() + start_byte, buffer.data.begin() + end_byte};
+	return getByteRange(view_data, accessor.byteOffset, length);
 }
 
 uint32_t AssetImporter::getAttributeCount(const tinygltf::Model* tfmodel, uint32_t accessor_id)
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <span>
+#include <memory>
+#include <functional>
 #include <string_view>
+#include <filesystem>
 
 #include <tiny_gltf.h>
 
@@ -13,38 +16,76 @@
 #include "Scene/Behaviours/CameraController.hpp"
 #include "Scene/Resources/Material.hpp"
 
+struct ImportSettings {
+	bool parallel{true};
+	bool report_timings{true};
+	bool write_cooked{false};
+	bool use_cache{true};
+	bool optimize_meshes{true};
+	bool generate_lods{true};
+	bool build_meshlets{true};
+	bool generate_mips{true};
+	bool compress_textures{true};
+	bool deduplicate_assets{true};
+	// Flags every node no animation targets as static, its world matrix is baked by the TransformStore
+	bool bake_static{true};
+	// Also removes static nodes that only group others, their names no longer resolve
+	bool collapse_static{false};
+
+	// Called after every import stage, from the importing thread
+	std::function<void(std::string_view stage)> on_stage;
+};
+
+// Fallback resources of the scene being imported, kept per import so scenes can load concurrently
+struct ImportDefaults {
+	std::shared_ptr<Material> material;
+	std::shared_ptr<Texture>  base_color_texture;
+	std::shared_ptr<Texture>  metallic_roughness_texture;
+};
+
+// Parsed glTF plus the raw bytes of every buffer and encoded image, either memory-mapped (.glb) or owned by tinygltf (.gltf)
+struct GltfDocument {
+	tinygltf::Model model;
+
+	std::vector<std::span<const uint8_t>>    buffers;
+	std::vector<std::shared_ptr<const void>> buffer_storages;
+
+	std::vector<std::span<const uint8_t>>    images;
+	std::vector<std::shared_ptr<const void>> image_storages;
+
+	// Images already in a GPU layout (KTX2), indexed like the model images
+	std::vector<std::shared_ptr<Texture>> image_textures;
+};
+
 class AssetImporter {
 private:
-	template <typename S, typename D>
-	static std::vector<D> convertData(std::span<const uint8_t> data);
+	static GltfDocument loadGltf(const std::filesystem::path& path);
+	static GltfDocument loadGlb(const std::filesystem::path& path);
 
-	static std::vector<uint8_t>     getAttributeData(const tinygltf::Model& tfmodel, uint32_t accessor_index);
-	static std::span<const uint8_t> getAttributeDataView(const tinygltf::Model& tfmodel, uint32_t accessor_index);
+	static std::span<const uint8_t> getAttributeDataView(const GltfDocument& document, uint32_t accessor_index);
 
 	static uint32_t getAttributeCount(const tinygltf::Model* tfmodel, uint32_t accessor_id);
 	static uint32_t getAttributeSize(const tinygltf::Model* tfmodel, uint32_t accessor_id);
 	static uint32_t getAttributeStride(const tinygltf::Model* tfmodel, uint32_t accessor_id);
 
-	static std::weak_ptr<Material> default_pbr_material;
-	static std::weak_ptr<Texture>  default_base_color_texture;
-	static std::weak_ptr<Texture>  default_metallic_roughness_texture;
-
 	static void initDefaultCamera(Scene& scene);
 	static void initDefaultLight(Scene& scene);
-	static void initDefaultTextures(Scene& scene);
-	static void initDefaultMaterials(Scene& scene);
+	static void initDefaultTextures(Scene& scene, ImportDefaults& defaults);
+	static void initDefaultMaterials(Scene& scene, ImportDefaults& defaults);
 	static void initDefaultCameraController(Scene& scene);
 
+	static void decodeImage(tinygltf::Image& tfimage, std::span<const uint8_t> encoded);
+
 public:
-	static std::unique_ptr<Scene> loadScene(std::string_view scene_path);
+	static std::unique_ptr<Scene> loadScene(std::string_view scene_path, const ImportSettings& settings = {});
 
 	static std::unique_ptr<Node>     parseNode(const tinygltf::Node& tfnode);
 	static std::unique_ptr<Mesh>     parseMesh(const tinygltf::Mesh& tfmesh);
 	static std::unique_ptr<Camera>   parseCamera(const tinygltf::Camera& tfcamera);
 	static std::unique_ptr<Light>    parseLight(const tinygltf::Light& tflight);
-	static std::shared_ptr<SubMesh>  parseSubmesh(const tinygltf::Mesh& tfmesh, const tinygltf::Model& tfmodel, uint32_t indexm, const std::vector<std::shared_ptr<Material>>& materials);
-	static std::shared_ptr<Texture>  parseTexture(const tinygltf::Texture& tftexture, const tinygltf::Model& tfmodel);
-	static std::shared_ptr<Material> parseMaterial(const tinygltf::Material& tfmaterial, const tinygltf::Model& tfmodel, const std::vector<std::shared_ptr<Texture>>& textures);
+	static std::shared_ptr<SubMesh>  parseSubmesh(const tinygltf::Mesh& tfmesh, const GltfDocument& document, uint32_t index, const std::vector<std::shared_ptr<Material>>& materials, const ImportDefaults& defaults);
+	static std::shared_ptr<Texture>  parseTexture(const tinygltf::Texture& tftexture, const GltfDocument& document);
+	static std::shared_ptr<Material> parseMaterial(const tinygltf::Material& tfmaterial, const tinygltf::Model& tfmodel, const std::vector<std::shared_ptr<Texture>>& textures, const ImportDefaults& defaults);
 
 	static std::unique_ptr<Camera>           createDefaultCamera(const std::string& = "Default_Camera");
 	static std::unique_ptr<Light>            createDefaultLight(const std::string& = "Default_Light");
@@ -52,19 +93,3 @@ public:
 	static std::shared_ptr<Material>         createDefaultMaterial(const std::string& = "Default_Material");
 	static std::unique_ptr<CameraController> createDefaultCameraController(const std::string& = "Default_Camera_Controller");
 };
-
-template <typename S, typename D>
-std::vector<D> AssetImporter::convertData(std::span<const uint8_t> data)
-{
-	static_assert(sizeof(S) <= sizeof(D),
-	    "Source type size must be less than or equal to destination type size");
-
-	const size_t   count = data.size() / sizeof(S);
-	std::vector<D> result(count);
-
-	const S* src_ptr = reinterpret_cast<const S*>(data.data());
-	for (size_t i = 0; i < count; i++)
-		result[i] = static_cast<D>(src_ptr[i]);
-
-	return result;
-}
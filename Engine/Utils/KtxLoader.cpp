@@ -0,0 +1,129 @@
+#include "KtxLoader.hpp"
+
+#include <array>
+#include <format>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#include "Scene/Resources/Texture.hpp"
+
+constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+constexpr size_t KTX2_HEADER_SIZE = 80;
+constexpr size_t KTX2_LEVEL_SIZE = 24;
+
+struct Ktx2Header {
+	uint32_t vk_format;
+	uint32_t type_size;
+	uint32_t pixel_width;
+	uint32_t pixel_height;
+	uint32_t pixel_depth;
+	uint32_t layer_count;
+	uint32_t face_count;
+	uint32_t level_count;
+	uint32_t supercompression_scheme;
+};
+
+struct Ktx2Level {
+	uint64_t byte_offset;
+	uint64_t byte_length;
+	uint64_t uncompressed_byte_length;
+};
+
+static_assert(sizeof(Ktx2Level) == KTX2_LEVEL_SIZE);
+
+// VkFormat values of the supported formats, the sRGB variant follows the UNORM one
+static std::pair<TextureFormat, bool> getTextureFormat(uint32_t vk_format)
+{
+	switch (vk_format) {
+	case 37: // VK_FORMAT_R8G8B8A8_UNORM
+	case 43: // VK_FORMAT_R8G8B8A8_SRGB
+		return {TextureFormat::RGBA8, vk_format == 43};
+	case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+	case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+	case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+	case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+		return {TextureFormat::BC1, vk_format % 2 == 0};
+	case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+	case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+		return {TextureFormat::BC3, vk_format == 138};
+	case 139: // VK_FORMAT_BC4_UNORM_BLOCK
+		return {TextureFormat::BC4, false};
+	case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+		return {TextureFormat::BC5, false};
+	case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+	case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+		return {TextureFormat::BC7, vk_format == 146};
+	default:
+		return {TextureFormat::Undefined, false};
+	}
+}
+
+bool KtxLoader::isKtx2(std::span<const uint8_t> bytes)
+{
+	return bytes.size() >= KTX2_IDENTIFIER.size() && std::equal(KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end(), bytes.begin());
+}
+
+std::shared_ptr<Texture> KtxLoader::load(const std::string& name, std::span<const uint8_t> bytes, std::shared_ptr<const void> storage)
+{
+	if (!isKtx2(bytes) || bytes.size() < KTX2_HEADER_SIZE)
+		throw std::runtime_error("Not a KTX2 file");
+
+	Ktx2Header header;
+	std::memcpy(&header, bytes.data() + KTX2_IDENTIFIER.size(), sizeof(header));
+
+	auto [format, srgb] = getTextureFormat(header.vk_format);
+	if (format == TextureFormat::Undefined)
+		throw std::runtime_error(std::format("Unsupported KTX2 format {}", header.vk_format));
+	if (header.supercompression_scheme != 0)
+		throw std::runtime_error("Supercompressed KTX2 files are not supported");
+	if (header.pixel_width == 0 || header.pixel_height == 0 || header.pixel_depth > 1 || header.layer_count > 1 || header.face_count != 1)
+		throw std::runtime_error("Only single 2D KTX2 images are supported");
+
+	// A level count of 0 asks the loader to generate the chain, the file then holds only the base level
+	uint32_t level_count = std::max(header.level_count, 1u);
+	if (level_count > 32 || bytes.size() < KTX2_HEADER_SIZE + size_t{level_count} * KTX2_LEVEL_SIZE)
+		throw std::runtime_error("KTX2 level index out of range");
+
+	std::vector<Ktx2Level> levels(level_count);
+	std::memcpy(levels.data(), bytes.data() + KTX2_HEADER_SIZE, levels.size() * KTX2_LEVEL_SIZE);
+
+	// Levels are stored smallest first, the texture data spans all of them so they are offset from the lowest one
+	uint64_t begin = bytes.size(), end = 0;
+	for (uint32_t level = 0; level < level_count; level++) {
+		uint32_t width = std::max(header.pixel_width >> level, 1u);
+		uint32_t height = std::max(header.pixel_height >> level, 1u);
+		if (levels[level].byte_length < Texture::getDataSize(format, width, height) || levels[level].byte_offset > bytes.size()
+		    || levels[level].byte_length > bytes.size() - levels[level].byte_offset)
+			throw std::runtime_error(std::format("KTX2 level {} out of range", level));
+
+		begin = std::min(begin, levels[level].byte_offset);
+		end = std::max(end, levels[level].byte_offset + levels[level].byte_length);
+	}
+
+	std::vector<TextureMip> mips;
+	for (uint32_t level = 0; level < level_count; level++) {
+		uint32_t width = std::max(header.pixel_width >> level, 1u);
+		uint32_t height = std::max(header.pixel_height >> level, 1u);
+		mips.push_back({.width = width, .height = height, .offset = levels[level].byte_offset - begin, .size = Texture::getDataSize(format, width, height)});
+	}
+
+	auto texture = std::make_shared<Texture>(name);
+	texture->setWidth(header.pixel_width);
+	texture->setHeight(header.pixel_height);
+	texture->setFormat(format);
+	texture->setSrgb(srgb);
+
+	auto data = bytes.subspan(begin, end - begin);
+	if (storage)
+		texture->setData(data, std::move(storage));
+	else
+		texture->setData(std::vector<uint8_t>(data.begin(), data.end()));
+
+	if (level_count > 1)
+		texture->setMips(std::move(mips));
+
+	return texture;
+}
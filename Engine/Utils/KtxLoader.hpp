@@ -0,0 +1,17 @@
+#pragma once
+
+#include <span>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+class Texture;
+
+// KTX2 containers holding RGBA8 or BC1/BC3/BC4/BC5/BC7 levels. Supercompressed files, cube maps and arrays are rejected.
+// Level data is referenced in place when a storage owning the bytes is given, copied otherwise
+class KtxLoader {
+public:
+	static bool isKtx2(std::span<const uint8_t> bytes);
+
+	static auto load(const std::string& name, std::span<const uint8_t> bytes, std::shared_ptr<const void> storage) -> std::shared_ptr<Texture>;
+};
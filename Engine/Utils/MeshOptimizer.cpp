@@ -0,0 +1,362 @@
+#include "MeshOptimizer.hpp"
+
+#include <cmath>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include "Core/Log/Logger.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+
+// Size of the LRU cache modelled while reordering, larger than the FIFO used for statistics as in Forsyth's paper
+constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+constexpr uint32_t FORSYTH_MAX_VALENCE = 32;
+
+class ForsythScores {
+private:
+	float cache_scores[FORSYTH_CACHE_SIZE]{};
+	float valence_scores[FORSYTH_MAX_VALENCE]{};
+
+public:
+	ForsythScores()
+	{
+		for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++)
+			cache_scores[i] = i < 3 ? 0.75f : std::pow(1.0f - static_cast<float>(i - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+		for (uint32_t i = 1; i < FORSYTH_MAX_VALENCE; i++)
+			valence_scores[i] = 2.0f / std::sqrt(static_cast<float>(i));
+	}
+
+	float get(int cache_position, uint32_t live_triangles) const
+	{
+		if (live_triangles == 0)
+			return -1.0f;
+
+		float score = cache_position >= 0 ? cache_scores[cache_position] : 0.0f;
+		return score + valence_scores[std::min(live_triangles, FORSYTH_MAX_VALENCE - 1)];
+	}
+};
+
+// FIFO cache simulated with timestamps, a vertex is resident while fewer than cache_size misses happened since it was loaded
+class FifoCache {
+private:
+	std::vector<uint32_t> timestamps;
+	uint32_t              cache_size;
+	uint32_t              time;
+
+public:
+	FifoCache(uint32_t vertex_count, uint32_t cache_size) :
+	    timestamps(vertex_count, 0), cache_size(cache_size), time(cache_size + 1)
+	{}
+
+	bool access(uint32_t vertex)
+	{
+		if (time - timestamps[vertex] <= cache_size)
+			return false;
+
+		timestamps[vertex] = time++;
+		return true;
+	}
+
+	uint32_t triangle(const uint32_t* corners)
+	{
+		return access(corners[0]) + access(corners[1]) + access(corners[2]);
+	}
+
+	void flush()
+	{
+		time += cache_size + 1;
+	}
+};
+
+void MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertex_count)
+{
+	static const ForsythScores scores;
+
+	size_t triangle_count = indices.size() / 3;
+	if (triangle_count < 2)
+		return;
+
+	// Triangle adjacency per vertex, the live triangles of a vertex are kept at the front of its range
+	std::vector<uint32_t> live(vertex_count, 0);
+	for (size_t i = 0; i < triangle_count * 3; i++)
+		live[indices[i]]++;
+
+	std::vector<uint32_t> offsets(vertex_count + 1, 0);
+	for (uint32_t v = 0; v < vertex_count; v++)
+		offsets[v + 1] = offsets[v] + live[v];
+
+	std::vector<uint32_t> adjacency(triangle_count * 3);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangle_count; t++)
+		for (size_t c = 0; c < 3; c++)
+			adjacency[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t);
+
+	std::vector<int>   cache_position(vertex_count, -1);
+	std::vector<float> vertex_score(vertex_count);
+	for (uint32_t v = 0; v < vertex_count; v++)
+		vertex_score[v] = scores.get(-1, live[v]);
+
+	std::vector<float> triangle_score(triangle_count);
+	std::vector<bool>  emitted(triangle_count, false);
+	for (size_t t = 0; t < triangle_count; t++)
+		triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+
+	std::vector<uint32_t> output;
+	output.reserve(triangle_count * 3);
+
+	std::vector<uint32_t> cache, next_cache;
+	cache.reserve(FORSYTH_CACHE_SIZE + 3);
+	next_cache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+	auto   best = static_cast<size_t>(std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin());
+	size_t cursor = 0;
+	for (size_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+		// Dead end, nothing in the cache has live triangles left, continue in input order
+		if (best == triangle_count) {
+			while (emitted[cursor])
+				cursor++;
+			best = cursor;
+		}
+
+		const uint32_t* corners = &indices[best * 3];
+		output.insert(output.end(), corners, corners + 3);
+		emitted[best] = true;
+
+		for (size_t c = 0; c < 3; c++) {
+			uint32_t v = corners[c];
+			auto     begin = adjacency.begin() + offsets[v];
+			auto     it = std::find(begin, begin + live[v], static_cast<uint32_t>(best));
+			std::iter_swap(it, begin + --live[v]);
+		}
+
+		next_cache.clear();
+		for (size_t c = 0; c < 3; c++)
+			if (std::find(next_cache.begin(), next_cache.end(), corners[c]) == next_cache.end())
+				next_cache.push_back(corners[c]);
+		auto corners_end = next_cache.size();
+		for (uint32_t v : cache)
+			if (std::find(next_cache.begin(), next_cache.begin() + corners_end, v) == next_cache.begin() + corners_end)
+				next_cache.push_back(v);
+
+		for (size_t i = 0; i < next_cache.size(); i++) {
+			uint32_t v = next_cache[i];
+			cache_position[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+			vertex_score[v] = scores.get(cache_position[v], live[v]);
+		}
+
+		// Only triangles touching the cache (including just evicted vertices) changed score
+		best = triangle_count;
+		float best_score = -1.0f;
+		for (uint32_t v : next_cache) {
+			for (uint32_t a = offsets[v]; a < offsets[v] + live[v]; a++) {
+				uint32_t t = adjacency[a];
+				triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+				if (triangle_score[t] > best_score) {
+					best_score = triangle_score[t];
+					best = t;
+				}
+			}
+		}
+
+		next_cache.resize(std::min<size_t>(next_cache.size(), FORSYTH_CACHE_SIZE));
+		std::swap(cache, next_cache);
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+// Splits the cache optimized order into clusters that keep ACMR within the threshold, then draws clusters facing
+// away from the mesh center first. Outer surfaces occlude inner ones from most viewpoints, so no view set is needed
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold)
+{
+	size_t triangle_count = indices.size() / 3;
+	if (triangle_count < 2)
+		return;
+
+	auto vertex_count = static_cast<uint32_t>(positions.size());
+
+	// Hard boundaries where the reordered stream restarts with three misses
+	std::vector<size_t> hard_clusters;
+	FifoCache           cache(vertex_count, cache_size);
+	for (size_t t = 0; t < triangle_count; t++)
+		if (cache.triangle(&indices[t * 3]) == 3 || t == 0)
+			hard_clusters.push_back(t);
+	hard_clusters.push_back(triangle_count);
+
+	// Soft boundaries inside each hard cluster, a cluster ends as soon as its ACMR is close enough to the whole run
+	std::vector<size_t> clusters;
+	for (size_t h = 0; h + 1 < hard_clusters.size(); h++) {
+		size_t begin = hard_clusters[h], end = hard_clusters[h + 1];
+
+		cache.flush();
+		uint32_t run_misses = 0;
+		for (size_t t = begin; t < end; t++)
+			run_misses += cache.triangle(&indices[t * 3]);
+		float run_acmr = static_cast<float>(run_misses) / static_cast<float>(end - begin);
+
+		cache.flush();
+		size_t   start = begin;
+		uint32_t misses = 0;
+		clusters.push_back(begin);
+		for (size_t t = begin; t + 1 < end; t++) {
+			misses += cache.triangle(&indices[t * 3]);
+			if (static_cast<float>(misses) <= run_acmr * threshold * static_cast<float>(t + 1 - start)) {
+				clusters.push_back(t + 1);
+				cache.flush();
+				start = t + 1;
+				misses = 0;
+			}
+		}
+	}
+	clusters.push_back(triangle_count);
+
+	size_t cluster_count = clusters.size() - 1;
+	if (cluster_count < 2)
+		return;
+
+	std::vector<glm::vec3> centroids(cluster_count, glm::vec3(0.0f));
+	std::vector<glm::vec3> normals(cluster_count, glm::vec3(0.0f));
+	std::vector<float>     areas(cluster_count, 0.0f);
+	glm::vec3              mesh_centroid(0.0f);
+	float                  mesh_area = 0.0f;
+	for (size_t c = 0; c < cluster_count; c++) {
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+			const auto& p0 = positions[indices[t * 3]];
+			const auto& p1 = positions[indices[t * 3 + 1]];
+			const auto& p2 = positions[indices[t * 3 + 2]];
+
+			auto  normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+			centroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			normals[c] += normal;
+			areas[c] += area;
+		}
+
+		mesh_centroid += centroids[c];
+		mesh_area += areas[c];
+		if (areas[c] > 0.0f)
+			centroids[c] /= areas[c];
+	}
+	if (mesh_area > 0.0f)
+		mesh_centroid /= mesh_area;
+
+	std::vector<float> sort_keys(cluster_count);
+	for (size_t c = 0; c < cluster_count; c++) {
+		float length = glm::length(normals[c]);
+		sort_keys[c] = length > 0.0f ? glm::dot(centroids[c] - mesh_centroid, normals[c] / length) : 0.0f;
+	}
+
+	std::vector<size_t> order(cluster_count);
+	for (size_t c = 0; c < cluster_count; c++)
+		order[c] = c;
+	std::stable_sort(order.begin(), order.end(), [&sort_keys](size_t a, size_t b) { return sort_keys[a] > sort_keys[b]; });
+
+	std::vector<uint32_t> output;
+	output.reserve(triangle_count * 3);
+	for (size_t c : order)
+		output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+// Renumbers vertices in first use order, returns the old to new remap (~0u for unreferenced vertices)
+std::vector<uint32_t> MeshOptimizer::optimizeVertexFetch(std::span<uint32_t> indices, uint32_t vertex_count)
+{
+	std::vector<uint32_t> remap(vertex_count, ~0u);
+	uint32_t              next = 0;
+	for (auto& index : indices) {
+		if (remap[index] == ~0u)
+			remap[index] = next++;
+		index = remap[index];
+	}
+
+	return remap;
+}
+
+// Float positions of the submesh, empty when the stream is missing or quantized
+std::vector<glm::vec3> MeshOptimizer::getPositions(const SubMesh& submesh)
+{
+	const auto* position = submesh.getAttribute("POSITION");
+	if (!position || position->component_type != ComponentType::Float || position->components < 3)
+		return {};
+
+	std::vector<glm::vec3> positions(submesh.getVerticesCount());
+	for (size_t v = 0; v < positions.size(); v++)
+		std::memcpy(&positions[v], position->data.data() + v * position->stride, sizeof(glm::vec3));
+
+	return positions;
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertex_count, uint32_t cache_size)
+{
+	size_t triangle_count = indices.size() / 3;
+	if (triangle_count == 0)
+		return {};
+
+	FifoCache         cache(vertex_count, cache_size);
+	std::vector<bool> referenced(vertex_count, false);
+	uint32_t          misses = 0, unique = 0;
+	for (size_t t = 0; t < triangle_count; t++) {
+		misses += cache.triangle(&indices[t * 3]);
+		for (size_t c = 0; c < 3; c++) {
+			if (!referenced[indices[t * 3 + c]]) {
+				referenced[indices[t * 3 + c]] = true;
+				unique++;
+			}
+		}
+	}
+
+	return {
+	    .acmr = static_cast<float>(misses) / static_cast<float>(triangle_count),
+	    .atvr = static_cast<float>(misses) / static_cast<float>(unique),
+	};
+}
+
+// Full pass over a triangle list submesh, attributes are rewritten into owned tightly packed streams in the new order
+void MeshOptimizer::optimize(SubMesh& submesh)
+{
+	uint32_t vertex_count = submesh.getVerticesCount();
+	if (vertex_count == 0 || submesh.getIndicesCount() < 6 || submesh.getIndicesCount() % 3 != 0)
+		return;
+
+	auto indices = submesh.getIndices();
+	if (std::any_of(indices.begin(), indices.end(), [vertex_count](uint32_t index) { return index >= vertex_count; })) {
+		Logger::warn(std::format("SubMesh {} references vertices out of range, skipping optimization", submesh.getName()));
+		return;
+	}
+
+	auto before = analyzeVertexCache(indices, vertex_count);
+
+	optimizeVertexCache(indices, vertex_count);
+
+	if (auto positions = getPositions(submesh); !positions.empty())
+		optimizeOverdraw(indices, positions);
+
+	auto     remap = optimizeVertexFetch(indices, vertex_count);
+	uint32_t used_count = static_cast<uint32_t>(vertex_count - std::count(remap.begin(), remap.end(), ~0u));
+
+	for (const auto& [name, attribute] : submesh.getAttributes()) {
+		auto     storage = std::make_shared<std::vector<uint8_t>>(size_t{used_count} * attribute.size);
+		uint8_t* dst = storage->data();
+		for (uint32_t v = 0; v < vertex_count; v++)
+			if (remap[v] != ~0u)
+				std::memcpy(dst + size_t{remap[v]} * attribute.size, attribute.data.data() + size_t{v} * attribute.stride, attribute.size);
+
+		auto packed = attribute;
+		packed.stride = attribute.size;
+		packed.data = *storage;
+		packed.storage = std::move(storage);
+		submesh.setAttribute(name, packed);
+	}
+
+	auto after = analyzeVertexCache(indices, used_count);
+	submesh.setVerticesCount(used_count);
+	if (used_count <= std::numeric_limits<uint16_t>::max())
+		submesh.setIndices(std::vector<uint16_t>(indices.begin(), indices.end()));
+	else
+		submesh.setIndices(std::move(indices));
+
+	Logger::info(std::format("Optimized {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+	    submesh.getName(), before.acmr, after.acmr, before.atvr, after.atvr));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+class SubMesh;
+
+struct VertexCacheStats {
+	float acmr{}; // Transformed vertices per triangle, 0.5 is ideal, 3 is the worst case
+	float atvr{}; // Transformed vertices per referenced vertex, 1 is ideal
+};
+
+// Import time triangle and vertex reordering: post-transform cache (Forsyth), overdraw (cluster sorting) and fetch locality
+class MeshOptimizer {
+public:
+	static constexpr uint32_t cache_size = 16;
+	static constexpr float    overdraw_threshold = 1.05f;
+
+	static void                  optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertex_count);
+	static void                  optimizeOverdraw(std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold = overdraw_threshold);
+	static std::vector<uint32_t> optimizeVertexFetch(std::span<uint32_t> indices, uint32_t vertex_count);
+
+	static std::vector<glm::vec3> getPositions(const SubMesh& submesh);
+	static VertexCacheStats       analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertex_count, uint32_t cache_size = MeshOptimizer::cache_size);
+
+	static void optimize(SubMesh& submesh);
+};
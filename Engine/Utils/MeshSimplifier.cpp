@@ -0,0 +1,328 @@
+#include "MeshSimplifier.hpp"
+
+#include <cmath>
+#include <format>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Core/Log/Logger.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+#include "Utils/MeshOptimizer.hpp"
+
+// Border planes are weighted up so open edges barely move
+constexpr double BORDER_WEIGHT = 10.0;
+
+enum class VertexKind : uint8_t {
+	Manifold,
+	Border,
+	Locked,
+};
+
+// Symmetric 4x4 plane quadric, error(p) is the weighted sum of squared distances to the accumulated planes
+struct Quadric {
+	double a2{}, b2{}, c2{}, ab{}, ac{}, bc{}, ad{}, bd{}, cd{}, d2{};
+
+	void addPlane(const glm::dvec3& n, double d, double weight)
+	{
+		a2 += weight * n.x * n.x;
+		b2 += weight * n.y * n.y;
+		c2 += weight * n.z * n.z;
+		ab += weight * n.x * n.y;
+		ac += weight * n.x * n.z;
+		bc += weight * n.y * n.z;
+		ad += weight * n.x * d;
+		bd += weight * n.y * d;
+		cd += weight * n.z * d;
+		d2 += weight * d * d;
+	}
+
+	void add(const Quadric& other)
+	{
+		a2 += other.a2, b2 += other.b2, c2 += other.c2;
+		ab += other.ab, ac += other.ac, bc += other.bc;
+		ad += other.ad, bd += other.bd, cd += other.cd;
+		d2 += other.d2;
+	}
+
+	double error(const glm::vec3& p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+		double e = a2 * x * x + b2 * y * y + c2 * z * z
+		    + 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+		    + 2.0 * (ad * x + bd * y + cd * z) + d2;
+		return std::max(e, 0.0);
+	}
+};
+
+struct Collapse {
+	double   cost;
+	uint32_t from;
+	uint32_t to;
+};
+
+static uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+	return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+static std::unordered_set<uint64_t> findOpenEdges(std::span<const uint32_t> indices)
+{
+	std::unordered_set<uint64_t> half_edges;
+	half_edges.reserve(indices.size());
+	for (size_t t = 0; t < indices.size(); t += 3)
+		for (size_t c = 0; c < 3; c++)
+			half_edges.insert(edgeKey(indices[t + c], indices[t + (c + 1) % 3]));
+
+	std::unordered_set<uint64_t> open_edges;
+	for (auto key : half_edges)
+		if (!half_edges.contains((key << 32) | (key >> 32)))
+			open_edges.insert(key);
+
+	return open_edges;
+}
+
+static std::vector<VertexKind> classifyVertices(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, const std::unordered_set<uint64_t>& open_edges)
+{
+	struct PositionHash {
+		size_t operator()(const glm::vec3& p) const
+		{
+			uint32_t bits[3];
+			std::memcpy(bits, &p, sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	std::unordered_map<glm::vec3, uint32_t, PositionHash> position_counts;
+	for (const auto& p : positions)
+		position_counts[p]++;
+
+	std::vector<VertexKind> kinds(positions.size(), VertexKind::Manifold);
+	for (size_t v = 0; v < positions.size(); v++)
+		if (position_counts[positions[v]] > 1)
+			kinds[v] = VertexKind::Locked;
+
+	for (auto key : open_edges) {
+		for (auto v : {static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key)})
+			if (kinds[v] == VertexKind::Manifold)
+				kinds[v] = VertexKind::Border;
+	}
+
+	return kinds;
+}
+
+static std::vector<Quadric> computeQuadrics(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, const std::unordered_set<uint64_t>& open_edges)
+{
+	std::vector<Quadric> quadrics(positions.size());
+	for (size_t t = 0; t < indices.size(); t += 3) {
+		glm::dvec3 p0(positions[indices[t]]), p1(positions[indices[t + 1]]), p2(positions[indices[t + 2]]);
+		glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+		double     area = glm::length(normal);
+		if (area == 0.0)
+			continue;
+
+		normal /= area;
+		Quadric plane;
+		plane.addPlane(normal, -glm::dot(normal, p0), area);
+		for (size_t c = 0; c < 3; c++)
+			quadrics[indices[t + c]].add(plane);
+
+		// A plane through each open edge, perpendicular to the triangle, keeps the border in place
+		for (size_t c = 0; c < 3; c++) {
+			uint32_t a = indices[t + c], b = indices[t + (c + 1) % 3];
+			if (!open_edges.contains(edgeKey(a, b)))
+				continue;
+
+			glm::dvec3 pa(positions[a]), pb(positions[b]);
+			glm::dvec3 edge = pb - pa;
+			double     length = glm::length(edge);
+			if (length == 0.0)
+				continue;
+
+			glm::dvec3 border_normal = glm::normalize(glm::cross(edge, normal));
+			Quadric    border;
+			border.addPlane(border_normal, -glm::dot(border_normal, pa), length * length * BORDER_WEIGHT);
+			quadrics[a].add(border);
+			quadrics[b].add(border);
+		}
+	}
+
+	return quadrics;
+}
+
+// Rejects collapses that would flip or degenerate a triangle which survives the collapse
+static bool flipsTriangles(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, std::span<const uint32_t> triangles, uint32_t from, uint32_t to)
+{
+	for (uint32_t t : triangles) {
+		const uint32_t* corners = &indices[t * 3];
+		if (corners[0] == to || corners[1] == to || corners[2] == to)
+			continue;
+
+		glm::vec3 p[3], q[3];
+		for (size_t c = 0; c < 3; c++) {
+			p[c] = positions[corners[c]];
+			q[c] = corners[c] == from ? positions[to] : p[c];
+		}
+
+		glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+		glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+		if (glm::dot(before, after) <= 0.0f)
+			return true;
+	}
+
+	return false;
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, size_t target_index_count, float target_error, float* result_error)
+{
+	std::vector<uint32_t> current(indices.begin(), indices.end() - indices.size() % 3);
+	auto                  vertex_count = static_cast<uint32_t>(positions.size());
+
+	auto open_edges = findOpenEdges(current);
+	auto kinds = classifyVertices(current, positions, open_edges);
+	auto quadrics = computeQuadrics(current, positions, open_edges);
+
+	double max_cost = static_cast<double>(target_error) * target_error;
+	double error = 0.0;
+
+	std::vector<uint32_t> offsets(vertex_count + 1), adjacency, collapse_to(vertex_count);
+	std::vector<bool>     touched(vertex_count);
+	std::vector<Collapse> collapses;
+
+	// Each pass collapses the cheapest independent edges, then the topology is rebuilt
+	while (current.size() > target_index_count) {
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (auto v : current)
+			offsets[v + 1]++;
+		for (uint32_t v = 0; v < vertex_count; v++)
+			offsets[v + 1] += offsets[v];
+
+		adjacency.resize(current.size());
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < current.size(); i++)
+			adjacency[fill[current[i]]++] = static_cast<uint32_t>(i / 3);
+
+		collapses.clear();
+		for (size_t t = 0; t < current.size(); t += 3) {
+			for (size_t c = 0; c < 3; c++) {
+				uint32_t a = current[t + c], b = current[t + (c + 1) % 3];
+				for (auto [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+					if (kinds[from] == VertexKind::Locked)
+						continue;
+					if (kinds[from] == VertexKind::Border && !open_edges.contains(edgeKey(from, to)) && !open_edges.contains(edgeKey(to, from)))
+						continue;
+
+					Quadric merged = quadrics[from];
+					merged.add(quadrics[to]);
+					double cost = merged.error(positions[to]);
+					if (cost <= max_cost)
+						collapses.push_back({cost, from, to});
+				}
+			}
+		}
+
+		if (collapses.empty())
+			break;
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+		size_t triangle_budget = (current.size() - target_index_count) / 3;
+		size_t collapse_limit = std::max<size_t>(triangle_budget / 2, 1);
+		size_t collapse_count = 0;
+
+		std::fill(touched.begin(), touched.end(), false);
+		for (uint32_t v = 0; v < vertex_count; v++)
+			collapse_to[v] = v;
+
+		for (const auto& collapse : collapses) {
+			if (touched[collapse.from] || touched[collapse.to])
+				continue;
+
+			std::span<const uint32_t> triangles(adjacency.data() + offsets[collapse.from], offsets[collapse.from + 1] - offsets[collapse.from]);
+			if (flipsTriangles(current, positions, triangles, collapse.from, collapse.to))
+				continue;
+
+			collapse_to[collapse.from] = collapse.to;
+			quadrics[collapse.to].add(quadrics[collapse.from]);
+			error = std::max(error, collapse.cost);
+
+			// The one ring of a collapsed vertex changes, keep the pass independent
+			for (uint32_t t : triangles)
+				for (size_t c = 0; c < 3; c++)
+					touched[current[t * 3 + c]] = true;
+
+			if (++collapse_count >= collapse_limit)
+				break;
+		}
+
+		if (collapse_count == 0)
+			break;
+
+		size_t write = 0;
+		for (size_t t = 0; t < current.size(); t += 3) {
+			uint32_t a = collapse_to[current[t]], b = collapse_to[current[t + 1]], c = collapse_to[current[t + 2]];
+			if (a == b || b == c || a == c)
+				continue;
+
+			current[write++] = a;
+			current[write++] = b;
+			current[write++] = c;
+		}
+		current.resize(write);
+
+		open_edges = findOpenEdges(current);
+	}
+
+	if (result_error)
+		*result_error = static_cast<float>(std::sqrt(error));
+
+	return current;
+}
+
+// Each level simplifies the previous one, its error accumulates so screen space selection stays conservative
+void MeshSimplifier::generateLods(SubMesh& submesh)
+{
+	auto positions = MeshOptimizer::getPositions(submesh);
+	auto indices = submesh.getIndices();
+	if (positions.empty() || indices.size() < 3 * 64 || indices.size() % 3 != 0)
+		return;
+
+	glm::vec3 min = positions.front(), max = positions.front();
+	for (const auto& p : positions) {
+		min = glm::min(min, p);
+		max = glm::max(max, p);
+	}
+	float extent = glm::length(max - min);
+
+	std::vector<SubMeshLod> lods;
+	std::vector<uint32_t>   lod_indices;
+	std::vector<uint32_t>   source = indices;
+	float                   error = 0.0f;
+	for (uint32_t level = 1; level <= max_lods; level++) {
+		auto  target = static_cast<size_t>(static_cast<float>(indices.size()) * std::pow(lod_ratio, static_cast<float>(level))) / 3 * 3;
+		float level_error = 0.0f;
+		auto  simplified = simplify(source, positions, target, max_error * extent, &level_error);
+
+		// Stop once the mesh barely shrinks, the error budget or locked seams keep it from going further
+		if (simplified.size() * 10 > source.size() * 9)
+			break;
+
+		MeshOptimizer::optimizeVertexCache(simplified, submesh.getVerticesCount());
+
+		error += level_error;
+		lods.push_back({
+		    .index_offset = static_cast<uint32_t>(lod_indices.size()),
+		    .index_count = static_cast<uint32_t>(simplified.size()),
+		    .error = error,
+		});
+		lod_indices.insert(lod_indices.end(), simplified.begin(), simplified.end());
+		source = std::move(simplified);
+	}
+
+	if (lods.empty())
+		return;
+
+	Logger::info(std::format("Generated {} LOD(s) for {}: {} -> {} triangles", lods.size(), submesh.getName(), indices.size() / 3, lods.back().index_count / 3));
+	submesh.setLods(std::move(lods), std::move(lod_indices));
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+class SubMesh;
+
+// Quadric error edge collapse. Vertices sharing a position with another vertex (UV or normal seams) are locked
+// and border vertices only slide along the border, so seams and open edges keep their shape
+class MeshSimplifier {
+public:
+	static constexpr uint32_t max_lods = 4;
+	static constexpr float    lod_ratio = 0.5f;  // Triangle ratio between consecutive levels
+	static constexpr float    max_error = 0.02f; // Relative to the submesh extent
+
+	static std::vector<uint32_t> simplify(std::span<const uint32_t> indices, std::span<const glm::vec3> positions, size_t target_index_count, float target_error, float* result_error = nullptr);
+
+	static void generateLods(SubMesh& submesh);
+};
@@ -0,0 +1,234 @@
+#include "MeshletBuilder.hpp"
+
+#include <cmath>
+#include <format>
+#include <limits>
+#include <algorithm>
+
+#include "Core/Log/Logger.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+#include "Utils/MeshOptimizer.hpp"
+
+// Cost of a triangle facing away from the meshlet average, relative to one extra vertex
+constexpr float CONE_WEIGHT = 0.5f;
+
+// Below this spread the cone is too wide to ever reject the meshlet
+constexpr float MIN_CONE_DOT = 0.1f;
+
+constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+void MeshletBuilder::computeBounds(Meshlet& meshlet, std::span<const uint32_t> indices, std::span<const glm::vec3> positions)
+{
+	auto triangles = indices.subspan(meshlet.index_offset, meshlet.index_count);
+
+	glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+	for (auto index : triangles) {
+		min = glm::min(min, positions[index]);
+		max = glm::max(max, positions[index]);
+	}
+
+	meshlet.center = (min + max) * 0.5f;
+	meshlet.radius = 0.0f;
+	for (auto index : triangles)
+		meshlet.radius = std::max(meshlet.radius, glm::length(positions[index] - meshlet.center));
+
+	std::vector<glm::vec3> normals, corners;
+	glm::vec3              normal_sum(0.0f);
+	for (size_t t = 0; t < triangles.size(); t += 3) {
+		const auto& p0 = positions[triangles[t]];
+		glm::vec3   normal = glm::cross(positions[triangles[t + 1]] - p0, positions[triangles[t + 2]] - p0);
+		float       length = glm::length(normal);
+		if (length == 0.0f)
+			continue;
+
+		normals.push_back(normal / length);
+		corners.push_back(p0);
+		normal_sum += normals.back();
+	}
+
+	meshlet.cone_apex = meshlet.center;
+	meshlet.cone_axis = glm::vec3(0.0f, 0.0f, 1.0f);
+	meshlet.cone_cutoff = 1.0f;
+
+	float axis_length = glm::length(normal_sum);
+	if (normals.empty() || axis_length == 0.0f)
+		return;
+
+	glm::vec3 axis = normal_sum / axis_length;
+	float     min_dot = 1.0f;
+	for (const auto& normal : normals)
+		min_dot = std::min(min_dot, glm::dot(normal, axis));
+
+	meshlet.cone_axis = axis;
+	if (min_dot <= MIN_CONE_DOT)
+		return;
+
+	// Slide the apex back along the axis until it lies behind every triangle plane
+	float max_t = 0.0f;
+	for (size_t i = 0; i < normals.size(); i++)
+		max_t = std::max(max_t, glm::dot(meshlet.center - corners[i], normals[i]) / glm::dot(axis, normals[i]));
+
+	meshlet.cone_apex = meshlet.center - axis * max_t;
+	meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+}
+
+// Greedy growth: the next triangle shares the most vertices with the meshlet and deviates least from its average
+// normal, a meshlet with no adjacent triangle left continues with the next unused triangle in input order
+std::vector<Meshlet> MeshletBuilder::build(std::span<uint32_t> indices, std::span<const glm::vec3> positions)
+{
+	auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+	auto vertex_count = static_cast<uint32_t>(positions.size());
+
+	std::vector<uint32_t> offsets(vertex_count + 1, 0);
+	for (size_t i = 0; i < size_t{triangle_count} * 3; i++)
+		offsets[indices[i] + 1]++;
+	for (uint32_t v = 0; v < vertex_count; v++)
+		offsets[v + 1] += offsets[v];
+
+	std::vector<uint32_t> adjacency(size_t{triangle_count} * 3);
+	std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t i = 0; i < adjacency.size(); i++)
+		adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+	std::vector<glm::vec3> normals(triangle_count, glm::vec3(0.0f));
+	for (uint32_t t = 0; t < triangle_count; t++) {
+		const auto& p0 = positions[indices[t * 3]];
+		glm::vec3   normal = glm::cross(positions[indices[t * 3 + 1]] - p0, positions[indices[t * 3 + 2]] - p0);
+		if (float length = glm::length(normal); length > 0.0f)
+			normals[t] = normal / length;
+	}
+
+	std::vector<uint32_t> output;
+	output.reserve(size_t{triangle_count} * 3);
+	std::vector<Meshlet> meshlets;
+	std::vector<bool>    emitted(triangle_count, false);
+
+	// Vertices of the open meshlet are tagged with its index, so membership is a single compare
+	std::vector<uint32_t> vertex_tag(vertex_count, INVALID_INDEX);
+	std::vector<uint32_t> vertices;
+	glm::vec3             normal_sum(0.0f);
+	uint32_t              triangles = 0;
+	uint32_t              cursor = 0;
+
+	auto extra_vertices = [&](uint32_t t) {
+		auto tag = static_cast<uint32_t>(meshlets.size());
+		return uint32_t{vertex_tag[indices[t * 3]] != tag} + uint32_t{vertex_tag[indices[t * 3 + 1]] != tag}
+		    + uint32_t{vertex_tag[indices[t * 3 + 2]] != tag};
+	};
+
+	auto flush = [&]() {
+		if (triangles == 0)
+			return;
+
+		meshlets.push_back({
+		    .index_offset = static_cast<uint32_t>(output.size() - size_t{triangles} * 3),
+		    .index_count = triangles * 3,
+		});
+		vertices.clear();
+		normal_sum = glm::vec3(0.0f);
+		triangles = 0;
+	};
+
+	for (uint32_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+		glm::vec3 average = glm::length(normal_sum) > 0.0f ? glm::normalize(normal_sum) : glm::vec3(0.0f);
+		uint32_t  best = INVALID_INDEX;
+		float     best_score = std::numeric_limits<float>::max();
+
+		for (auto vertex : vertices) {
+			for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+				uint32_t t = adjacency[a];
+				if (emitted[t])
+					continue;
+
+				uint32_t extra = extra_vertices(t);
+				if (vertices.size() + extra > max_vertices)
+					continue;
+
+				float score = static_cast<float>(extra) + (1.0f - glm::dot(normals[t], average)) * CONE_WEIGHT;
+				if (score < best_score) {
+					best_score = score;
+					best = t;
+				}
+			}
+		}
+
+		if (best == INVALID_INDEX) {
+			while (emitted[cursor])
+				cursor++;
+			best = cursor;
+			if (vertices.size() + extra_vertices(best) > max_vertices)
+				flush();
+		}
+
+		auto tag = static_cast<uint32_t>(meshlets.size());
+		for (size_t c = 0; c < 3; c++) {
+			uint32_t vertex = indices[best * 3 + c];
+			if (vertex_tag[vertex] != tag) {
+				vertex_tag[vertex] = tag;
+				vertices.push_back(vertex);
+			}
+			output.push_back(vertex);
+		}
+
+		emitted[best] = true;
+		normal_sum += normals[best];
+		if (++triangles == max_triangles)
+			flush();
+	}
+	flush();
+
+	std::copy(output.begin(), output.end(), indices.begin());
+
+	for (auto& meshlet : meshlets)
+		computeBounds(meshlet, indices, positions);
+
+	return meshlets;
+}
+
+void MeshletBuilder::buildMeshlets(SubMesh& submesh)
+{
+	uint32_t vertex_count = submesh.getVerticesCount();
+	auto     positions = MeshOptimizer::getPositions(submesh);
+	auto     indices = submesh.getIndices();
+	if (positions.empty() || indices.size() % 3 != 0 || indices.size() <= size_t{max_triangles} * 3)
+		return;
+
+	if (std::any_of(indices.begin(), indices.end(), [vertex_count](uint32_t index) { return index >= vertex_count; })) {
+		Logger::warn(std::format("SubMesh {} references vertices out of range, skipping meshlets", submesh.getName()));
+		return;
+	}
+
+	auto meshlets = build(indices, positions);
+
+	// Growth order is not cache order, restore post-transform locality inside each meshlet on local vertex ids
+	std::vector<uint32_t> local_index(vertex_count, INVALID_INDEX);
+	std::vector<uint32_t> global_index, local;
+	for (const auto& meshlet : meshlets) {
+		auto range = std::span(indices).subspan(meshlet.index_offset, meshlet.index_count);
+
+		global_index.clear();
+		local.clear();
+		for (auto index : range) {
+			if (local_index[index] == INVALID_INDEX) {
+				local_index[index] = static_cast<uint32_t>(global_index.size());
+				global_index.push_back(index);
+			}
+			local.push_back(local_index[index]);
+		}
+
+		MeshOptimizer::optimizeVertexCache(local, static_cast<uint32_t>(global_index.size()));
+		for (size_t i = 0; i < local.size(); i++)
+			range[i] = global_index[local[i]];
+		for (auto index : global_index)
+			local_index[index] = INVALID_INDEX;
+	}
+
+	size_t cone_count = std::count_if(meshlets.begin(), meshlets.end(), [](const Meshlet& meshlet) { return meshlet.cone_cutoff < 1.0f; });
+	Logger::info(std::format("Built {} meshlets for {} ({} with a usable normal cone)", meshlets.size(), submesh.getName(), cone_count));
+
+	if (vertex_count <= std::numeric_limits<uint16_t>::max())
+		submesh.setIndices(std::vector<uint16_t>(indices.begin(), indices.end()));
+	else
+		submesh.setIndices(std::move(indices));
+	submesh.setMeshlets(std::move(meshlets));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+class SubMesh;
+struct Meshlet;
+
+// Splits a triangle list into small clusters grown over shared vertices, reordering the indices so every cluster
+// is one contiguous range, and computes the bounding sphere and normal cone used to cull each cluster
+class MeshletBuilder {
+public:
+	static constexpr uint32_t max_vertices = 64;
+	static constexpr uint32_t max_triangles = 124;
+
+	static std::vector<Meshlet> build(std::span<uint32_t> indices, std::span<const glm::vec3> positions);
+	static void                 computeBounds(Meshlet& meshlet, std::span<const uint32_t> indices, std::span<const glm::vec3> positions);
+
+	static void buildMeshlets(SubMesh& submesh);
+};
@@ -0,0 +1,209 @@
+#include "MipmapGenerator.hpp"
+
+#include <cmath>
+#include <format>
+#include <algorithm>
+
+#include "Core/Log/Logger.hpp"
+#include "Scene/Resources/Texture.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define VORTEX_SSE2 1
+#	include <emmintrin.h>
+#endif
+
+constexpr uint32_t ENCODE_STEPS = 65535;
+
+// sRGB transfer as lookups: 8-bit to linear, and linear quantized to 16 bits back to 8-bit sRGB
+class SrgbTables {
+private:
+	float   decode_table[256];
+	uint8_t encode_table[ENCODE_STEPS + 1];
+
+public:
+	SrgbTables()
+	{
+		for (uint32_t i = 0; i < 256; i++) {
+			float value = static_cast<float>(i) / 255.0f;
+			decode_table[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (uint32_t i = 0; i <= ENCODE_STEPS; i++) {
+			float linear = static_cast<float>(i) / ENCODE_STEPS;
+			float value = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+			encode_table[i] = static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+		}
+	}
+
+	float decode(uint8_t value) const
+	{
+		return decode_table[value];
+	}
+
+	uint8_t encode(float linear) const
+	{
+		return encode_table[static_cast<uint32_t>(std::clamp(linear, 0.0f, 1.0f) * ENCODE_STEPS + 0.5f)];
+	}
+};
+
+static const SrgbTables& getSrgbTables()
+{
+	static const SrgbTables tables;
+	return tables;
+}
+
+static uint8_t encodeUnorm(float value)
+{
+	return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+uint32_t MipmapGenerator::getMipCount(uint32_t width, uint32_t height)
+{
+	uint32_t count = 1;
+	for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+		count++;
+	return count;
+}
+
+// Source texels and weights of one output texel along an axis. An even size averages pairs, an odd size 2n+1 is an
+// exact box over n outputs, output i covers texels 2i to 2i+2 with weights (n-i, n, i+1) / (2n+1), so every texel counts
+struct Footprint {
+	uint32_t first;
+	uint32_t count;
+	float    weights[3];
+};
+
+static Footprint getFootprint(uint32_t index, uint32_t size)
+{
+	if (size == 1)
+		return {0, 1, {1.0f}};
+	if (size % 2 == 0)
+		return {index * 2, 2, {0.5f, 0.5f}};
+
+	float total = static_cast<float>(size);
+	float half = static_cast<float>(size / 2);
+	float i = static_cast<float>(index);
+	return {index * 2, 3, {(half - i) / total, half / total, (i + 1.0f) / total}};
+}
+
+// destination += source * weight over one RGBA float pixel
+static void accumulate(float* destination, const float* source, float weight)
+{
+#ifdef VORTEX_SSE2
+	_mm_storeu_ps(destination, _mm_add_ps(_mm_loadu_ps(destination), _mm_mul_ps(_mm_loadu_ps(source), _mm_set1_ps(weight))));
+#else
+	for (size_t c = 0; c < 4; c++)
+		destination[c] += source[c] * weight;
+#endif
+}
+
+// Streams a chain row by row. Each level filters incoming rows horizontally into a ring of the last three, emits a row
+// of the next level once its vertical footprint is complete and hands it on in linear float, so scratch memory is a
+// few rows per level whatever the texture size
+class MipChain {
+private:
+	struct Level {
+		uint32_t           width;
+		uint32_t           height;
+		std::vector<float> ring;
+		std::vector<float> emitted_row;
+		uint32_t           received{0};
+		uint32_t           emitted{0};
+	};
+
+	std::vector<Level>             levels;
+	const std::vector<TextureMip>& mips;
+	uint8_t*                       output;
+	bool                           srgb;
+
+public:
+	MipChain(const std::vector<TextureMip>& mips, uint8_t* output, bool srgb) :
+	    mips(mips),
+	    output(output),
+	    srgb(srgb)
+	{
+		// Level k receives the rows of mip k and emits those of mip k + 1
+		for (size_t level = 0; level + 1 < mips.size(); level++)
+			levels.push_back({.width = mips[level].width,
+			    .height = mips[level].height,
+			    .ring = std::vector<float>(size_t{mips[level + 1].width} * 4 * 3),
+			    .emitted_row = std::vector<float>(size_t{mips[level + 1].width} * 4)});
+	}
+
+	void push(size_t index, const float* row)
+	{
+		auto&    level = levels[index];
+		uint32_t next_width = mips[index + 1].width;
+		size_t   row_size = size_t{next_width} * 4;
+
+		float* filtered = level.ring.data() + level.received % 3 * row_size;
+		std::fill_n(filtered, row_size, 0.0f);
+		for (uint32_t x = 0; x < next_width; x++) {
+			auto footprint = getFootprint(x, level.width);
+			for (uint32_t tap = 0; tap < footprint.count; tap++)
+				accumulate(filtered + size_t{x} * 4, row + size_t{footprint.first + tap} * 4, footprint.weights[tap]);
+		}
+		level.received++;
+
+		auto footprint = getFootprint(level.emitted, level.height);
+		if (level.emitted == mips[index + 1].height || footprint.first + footprint.count > level.received)
+			return;
+
+		auto& emitted_row = level.emitted_row;
+		std::fill(emitted_row.begin(), emitted_row.end(), 0.0f);
+		for (uint32_t tap = 0; tap < footprint.count; tap++) {
+			const float* source = level.ring.data() + (footprint.first + tap) % 3 * row_size;
+			for (size_t x = 0; x < row_size; x += 4)
+				accumulate(emitted_row.data() + x, source + x, footprint.weights[tap]);
+		}
+
+		const auto& tables = getSrgbTables();
+		uint8_t*    out = output + mips[index + 1].offset + level.emitted * row_size;
+		for (size_t i = 0; i < row_size; i++)
+			out[i] = srgb && i % 4 != 3 ? tables.encode(emitted_row[i]) : encodeUnorm(emitted_row[i]);
+		level.emitted++;
+
+		if (index + 1 < levels.size())
+			push(index + 1, emitted_row.data());
+	}
+};
+
+void MipmapGenerator::generateMips(Texture& texture)
+{
+	uint32_t width = texture.getWidth(), height = texture.getHeight();
+	auto     data = texture.getData();
+	if (texture.getMipCount() > 1 || texture.getFormat() != TextureFormat::RGBA8 || data.size() < size_t{width} * height * 4)
+		return;
+
+	uint32_t level_count = getMipCount(width, height);
+	if (level_count == 1)
+		return;
+
+	std::vector<TextureMip> mips;
+	uint64_t                total_size = 0;
+	for (uint32_t level = 0, w = width, h = height; level < level_count; level++, w = std::max(w / 2, 1u), h = std::max(h / 2, 1u)) {
+		mips.push_back({.width = w, .height = h, .offset = total_size, .size = uint64_t{w} * h * 4});
+		total_size += mips.back().size;
+	}
+
+	std::vector<uint8_t> output(total_size);
+	std::copy_n(data.begin(), mips[0].size, output.begin());
+
+	const auto& tables = getSrgbTables();
+	bool        srgb = texture.isSrgb();
+
+	// Level 0 is decoded one row at a time straight from the source bytes
+	MipChain           chain(mips, output.data(), srgb);
+	std::vector<float> row(size_t{width} * 4);
+	for (uint32_t y = 0; y < height; y++) {
+		const uint8_t* source = data.data() + size_t{y} * row.size();
+		for (size_t i = 0; i < row.size(); i++)
+			row[i] = srgb && i % 4 != 3 ? tables.decode(source[i]) : static_cast<float>(source[i]) / 255.0f;
+		chain.push(0, row.data());
+	}
+
+	texture.setData(std::move(output));
+	texture.setMips(std::move(mips));
+
+	Logger::debug(std::format("Generated {} mip levels for {} ({}x{})", level_count, texture.getName(), width, height));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+class Texture;
+
+// Full mip chains for RGBA8 textures. Levels are box filtered from the previous level kept in linear float, so sRGB
+// color is averaged in linear light and rounding does not accumulate down the chain. Rows stream through the chain,
+// scratch memory is a few rows per level rather than a float copy of the image
+class MipmapGenerator {
+public:
+	static uint32_t getMipCount(uint32_t width, uint32_t height);
+
+	static void generateMips(Texture& texture);
+};
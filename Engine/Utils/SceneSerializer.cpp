@@ -0,0 +1,885 @@
+#include "SceneSerializer.hpp"
+
+#include <array>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "Core/File/MappedFile.hpp"
+#include "Core/Log/Logger.hpp"
+#include "Render/RHI/GpuData.hpp"
+#include "Scene/Core/Node.hpp"
+#include "Scene/Components/Mesh.hpp"
+#include "Scene/Components/Camera.hpp"
+#include "Scene/Components/Light.hpp"
+#include "Scene/Resources/Material.hpp"
+#include "Scene/Resources/SubMesh.hpp"
+#include "Scene/Resources/Texture.hpp"
+
+enum Section : uint32_t {
+	Strings,
+	Nodes,
+	Meshes,
+	MeshSubMeshes,
+	SubMeshes,
+	Materials,
+	MaterialTextures,
+	Textures,
+	Cameras,
+	Lights,
+	Vertices,
+	Indices,
+	Pixels,
+	Lods,
+	Meshlets,
+	Mips,
+	SectionCount,
+};
+
+struct SectionRange {
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct StringRef {
+	uint32_t offset;
+	uint32_t length;
+};
+
+struct FileHeader {
+	uint32_t     magic;
+	uint32_t     version;
+	uint32_t     page_size;
+	uint32_t     section_count;
+	StringRef    scene_name;
+	SectionRange sections[SectionCount];
+};
+
+// Bits of NodeRecord::flags
+constexpr uint32_t NODE_STATIC = 1u << 0;
+
+struct NodeRecord {
+	StringRef name;
+	int32_t   parent;
+	int32_t   mesh;
+	int32_t   camera;
+	int32_t   light;
+	uint32_t  flags;
+	float     translation[3];
+	float     rotation[4];
+	float     scaling[3];
+};
+
+struct MeshRecord {
+	StringRef name;
+	uint32_t  first_submesh;
+	uint32_t  submesh_count;
+};
+
+struct SubMeshRecord {
+	StringRef name;
+	int32_t   material;
+	uint32_t  visible;
+	uint32_t  vertex_count;
+	uint32_t  index_count;
+	uint32_t  index_size;
+	uint32_t  first_lod;
+	uint32_t  lod_count;
+	uint32_t  lod_index_count;
+	uint32_t  first_meshlet;
+	uint32_t  meshlet_count;
+	float     bounds_min[3];
+	float     bounds_max[3];
+	uint64_t  vertex_offset;
+	uint64_t  index_offset;
+	uint64_t  lod_index_offset;
+};
+
+struct LodRecord {
+	uint32_t index_offset;
+	uint32_t index_count;
+	float    error;
+};
+
+struct MeshletRecord {
+	uint32_t index_offset;
+	uint32_t index_count;
+	float    center[3];
+	float    radius;
+	float    cone_apex[3];
+	float    cone_axis[3];
+	float    cone_cutoff;
+};
+
+struct MaterialRecord {
+	StringRef name;
+	float     base_color[4];
+	float     emissive[3];
+	float     metallic;
+	float     roughness;
+	float     alpha_cutoff;
+	uint32_t  alpha_mode;
+	uint32_t  double_sided;
+	uint32_t  first_texture;
+	uint32_t  texture_count;
+};
+
+struct MaterialTextureRecord {
+	StringRef slot;
+	int32_t   texture;
+};
+
+struct TextureRecord {
+	StringRef name;
+	uint32_t  width;
+	uint32_t  height;
+	uint32_t  format;
+	uint32_t  srgb;
+	uint32_t  first_mip;
+	uint32_t  mip_count;
+	uint64_t  data_offset;
+	uint64_t  data_size;
+};
+
+struct MipRecord {
+	uint32_t width;
+	uint32_t height;
+	uint64_t offset;
+	uint64_t size;
+};
+
+enum class CameraType : uint32_t {
+	Perspective,
+	Ortho,
+};
+
+struct CameraRecord {
+	StringRef  name;
+	CameraType type;
+	float      params[6];
+};
+
+enum class LightType : uint32_t {
+	Directional,
+	Point,
+	Spot,
+};
+
+struct LightRecord {
+	StringRef name;
+	LightType type;
+	float     color[3];
+	float     direction[3];
+	float     intensity;
+	float     range;
+	float     inner_cone_angle;
+	float     outer_cone_angle;
+};
+
+constexpr size_t blob_alignment = 16;
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+class SectionWriter {
+private:
+	std::array<std::vector<uint8_t>, SectionCount> sections;
+
+public:
+	template <typename T>
+	uint32_t append(Section section, const T& record)
+	{
+		auto& bytes = sections[section];
+		auto  index = static_cast<uint32_t>(bytes.size() / sizeof(T));
+		auto  data = reinterpret_cast<const uint8_t*>(&record);
+		bytes.insert(bytes.end(), data, data + sizeof(T));
+		return index;
+	}
+
+	uint64_t appendBlob(Section section, const void* data, size_t size)
+	{
+		auto& bytes = sections[section];
+		auto  offset = alignUp(bytes.size(), blob_alignment);
+		bytes.resize(offset + size);
+		if (size > 0)
+			std::memcpy(bytes.data() + offset, data, size);
+		return offset;
+	}
+
+	StringRef appendString(const std::string& string)
+	{
+		auto offset = appendBlob(Strings, string.data(), string.size());
+		return {static_cast<uint32_t>(offset), static_cast<uint32_t>(string.size())};
+	}
+
+	bool write(const std::filesystem::path& path, StringRef scene_name) const
+	{
+		FileHeader header{
+		    .magic = SceneSerializer::magic,
+		    .version = SceneSerializer::version,
+		    .page_size = SceneSerializer::page_size,
+		    .section_count = SectionCount,
+		    .scene_name = scene_name,
+		};
+
+		size_t cursor = alignUp(sizeof(FileHeader), SceneSerializer::page_size);
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			header.sections[i] = {cursor, sections[i].size()};
+			cursor = alignUp(cursor + sections[i].size(), SceneSerializer::page_size);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+
+		std::vector<char> padding(SceneSerializer::page_size, 0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+		size_t written = sizeof(FileHeader);
+		for (uint32_t i = 0; i < SectionCount; i++) {
+			file.write(padding.data(), static_cast<std::streamsize>(header.sections[i].offset - written));
+			file.write(reinterpret_cast<const char*>(sections[i].data()), static_cast<std::streamsize>(sections[i].size()));
+			written = header.sections[i].offset + sections[i].size();
+		}
+		file.write(padding.data(), static_cast<std::streamsize>(cursor - written));
+
+		return file.good();
+	}
+};
+
+class SectionReader {
+private:
+	std::shared_ptr<const MappedFile> file;
+	const FileHeader*                 header{};
+
+public:
+	SectionReader(const std::filesystem::path& path) :
+	    SectionReader(std::make_shared<const MappedFile>(path), path)
+	{}
+
+	SectionReader(std::shared_ptr<const MappedFile> mapped, const std::filesystem::path& path) :
+	    file(std::move(mapped))
+	{
+		auto bytes = file->getData();
+		if (bytes.size() < sizeof(FileHeader))
+			throw std::runtime_error("Invalid vxscene file: " + path.string());
+
+		header = reinterpret_cast<const FileHeader*>(bytes.data());
+		if (header->magic != SceneSerializer::magic || header->version != SceneSerializer::version || header->section_count != SectionCount)
+			throw std::runtime_error("Unsupported vxscene file: " + path.string());
+
+		for (const auto& section : header->sections)
+			if (section.offset > bytes.size() || section.size > bytes.size() - section.offset)
+				throw std::runtime_error("Truncated vxscene file: " + path.string());
+	}
+
+	auto getStorage() const -> std::shared_ptr<const void>
+	{
+		return file;
+	}
+
+	auto getFile() const -> std::shared_ptr<const MappedFile>
+	{
+		return file;
+	}
+
+	auto getHeader() const -> const FileHeader&
+	{
+		return *header;
+	}
+
+	auto bytes(Section section) const -> std::span<const uint8_t>
+	{
+		const auto& range = header->sections[section];
+		return file->getData().subspan(range.offset, range.size);
+	}
+
+	auto bytes(Section section, uint64_t offset, uint64_t size) const -> std::span<const uint8_t>
+	{
+		auto data = bytes(section);
+		if (offset > data.size() || size > data.size() - offset)
+			throw std::runtime_error("vxscene data range exceeds its section");
+
+		return data.subspan(offset, size);
+	}
+
+	template <typename T>
+	auto table(Section section) const -> std::span<const T>
+	{
+		auto data = bytes(section);
+		if (data.size() % sizeof(T) != 0)
+			throw std::runtime_error("Malformed vxscene record table");
+
+		return {reinterpret_cast<const T*>(data.data()), data.size() / sizeof(T)};
+	}
+
+	std::string string(StringRef ref) const
+	{
+		auto data = bytes(Strings, ref.offset, ref.length);
+		return {reinterpret_cast<const char*>(data.data()), data.size()};
+	}
+};
+
+// Reopens a cooked file for resources released after upload. The mapping is shared while any reloaded data still
+// references it, so submeshes that shared their streams keep sharing them after a reload
+class CookedSource {
+private:
+	std::filesystem::path           path;
+	std::weak_ptr<const MappedFile> file;
+
+public:
+	CookedSource(std::filesystem::path path, std::shared_ptr<const MappedFile> mapped) :
+	    path(std::move(path)), file(mapped)
+	{}
+
+	auto open() -> SectionReader
+	{
+		auto mapped = file.lock();
+		if (!mapped) {
+			mapped = std::make_shared<const MappedFile>(path);
+			file = mapped;
+		}
+
+		return SectionReader(std::move(mapped), path);
+	}
+};
+
+// SubMeshes expose the cooked FullVertex arrays as attribute views
+struct AttributeLayout {
+	const char* name;
+	uint32_t    offset;
+	uint32_t    components;
+};
+
+constexpr std::array ATTRIBUTE_LAYOUTS = {
+    AttributeLayout{"POSITION", offsetof(FullVertex, pos), 3},
+    AttributeLayout{"NORMAL", offsetof(FullVertex, normal), 3},
+    AttributeLayout{"TEXCOORD_0", offsetof(FullVertex, uv), 2},
+    AttributeLayout{"COLOR_0", offsetof(FullVertex, color), 4},
+};
+
+// Vertex, index and LOD streams of one submesh, shared by the first load and later reloads
+static void loadGeometry(const SectionReader& reader, const SubMeshRecord& record, std::span<const LodRecord> lod_records, SubMesh& submesh)
+{
+	auto storage = reader.getStorage();
+
+	if (record.vertex_count > 0) {
+		auto vertices = reader.bytes(Vertices, record.vertex_offset, uint64_t{record.vertex_count} * sizeof(FullVertex));
+
+		for (const auto& layout : ATTRIBUTE_LAYOUTS) {
+			uint32_t size = layout.components * sizeof(float);
+			VertexAttribute attribute{
+			    .size = size,
+			    .stride = sizeof(FullVertex),
+			    .components = layout.components,
+			    .component_type = ComponentType::Float,
+			    .data = vertices.subspan(layout.offset, (record.vertex_count - 1) * sizeof(FullVertex) + size),
+			    .storage = storage,
+			};
+			submesh.setAttribute(layout.name, attribute);
+		}
+	}
+
+	if (record.index_count > 0) {
+		auto indices = reader.bytes(Indices, record.index_offset, uint64_t{record.index_count} * record.index_size);
+
+		submesh.setIndices(indices, record.index_size, storage);
+	}
+
+	if (record.lod_count > 0) {
+		if (record.first_lod > lod_records.size() || record.lod_count > lod_records.size() - record.first_lod)
+			throw std::runtime_error("vxscene LOD range out of bounds");
+
+		auto bytes = reader.bytes(Indices, record.lod_index_offset, uint64_t{record.lod_index_count} * sizeof(uint32_t));
+
+		std::vector<SubMeshLod> lods;
+		for (const auto& lod : lod_records.subspan(record.first_lod, record.lod_count)) {
+			if (uint64_t{lod.index_offset} + lod.index_count > record.lod_index_count)
+				throw std::runtime_error("vxscene LOD indices out of bounds");
+			lods.push_back({lod.index_offset, lod.index_count, lod.error});
+		}
+
+		submesh.setLods(std::move(lods), {reinterpret_cast<const uint32_t*>(bytes.data()), record.lod_index_count}, storage);
+	}
+}
+
+template <typename T>
+static int32_t indexOf(const std::unordered_map<const T*, uint32_t>& indices, const T* value)
+{
+	auto it = indices.find(value);
+	return it != indices.end() ? static_cast<int32_t>(it->second) : -1;
+}
+
+bool SceneSerializer::save(Scene& scene, const std::filesystem::path& path)
+{
+	SectionWriter writer;
+
+	auto textures = scene.getResources<Texture>();
+	auto materials = scene.getResources<Material>();
+	auto meshes = scene.getComponents<Mesh>();
+	auto cameras = scene.getComponents<Camera>();
+	auto lights = scene.getComponents<Light>();
+
+	// Textures
+	std::unordered_map<const Texture*, uint32_t> texture_indices;
+	for (const auto& texture : textures) {
+		auto          pixels = texture->getData();
+		TextureRecord record{
+		    .name = writer.appendString(texture->getName()),
+		    .width = texture->getWidth(),
+		    .height = texture->getHeight(),
+		    .format = static_cast<uint32_t>(texture->getFormat()),
+		    .srgb = texture->isSrgb(),
+		    .data_offset = writer.appendBlob(Pixels, pixels.data(), pixels.size()),
+		    .data_size = pixels.size(),
+		};
+
+		// Single level textures keep mip_count at 0, their data is the base level
+		if (texture->getMipCount() > 1) {
+			record.mip_count = texture->getMipCount();
+			for (uint32_t level = 0; level < record.mip_count; level++) {
+				auto mip = texture->getMip(level);
+				auto mip_index = writer.append(Mips, MipRecord{mip.width, mip.height, mip.offset, mip.size});
+				if (level == 0)
+					record.first_mip = mip_index;
+			}
+		}
+
+		texture_indices[texture] = writer.append(Textures, record);
+	}
+
+	// Materials
+	std::unordered_map<const Material*, uint32_t> material_indices;
+	uint32_t                                      material_texture_count = 0;
+	for (const auto& material : materials) {
+		MaterialRecord record{
+		    .name = writer.appendString(material->getName()),
+		    .base_color = {1.0f, 1.0f, 1.0f, 1.0f},
+		    .emissive = {material->getEmissive().x, material->getEmissive().y, material->getEmissive().z},
+		    .metallic = 0.0f,
+		    .roughness = 1.0f,
+		    .alpha_cutoff = material->getAlphaCutoff(),
+		    .alpha_mode = static_cast<uint32_t>(material->getAlphaMode()),
+		    .double_sided = material->getDoubleSided(),
+		    .first_texture = material_texture_count,
+		};
+
+		if (auto* pbr = dynamic_cast<PBRMaterial*>(material)) {
+			auto base_color = pbr->getBaseColorFactor();
+			std::copy_n(&base_color.x, 4, record.base_color);
+			record.metallic = pbr->getMetallicFactor();
+			record.roughness = pbr->getRoughnessFactor();
+		}
+
+		for (const auto& [slot, texture] : material->getTextures()) {
+			MaterialTextureRecord texture_record{
+			    .slot = writer.appendString(slot),
+			    .texture = indexOf<Texture>(texture_indices, texture.get()),
+			};
+			writer.append(MaterialTextures, texture_record);
+			record.texture_count++;
+		}
+		material_texture_count += record.texture_count;
+
+		material_indices[material] = writer.append(Materials, record);
+	}
+
+	// SubMeshes are baked to FullVertex arrays with their native index width, shared geometry streams are written once
+	struct StreamOffsets {
+		uint64_t vertex_offset;
+		uint64_t index_offset;
+		uint64_t lod_index_offset;
+	};
+
+	std::unordered_map<const SubMesh*, uint32_t>                   submesh_indices;
+	std::unordered_map<GeometryKey, StreamOffsets, GeometryKeyHash> geometry_streams;
+	std::vector<FullVertex>                                        vertices;
+	for (const auto& mesh : meshes) {
+		for (const auto& submesh : mesh->getSubmeshes()) {
+			if (submesh_indices.contains(submesh.get()))
+				continue;
+
+			auto index_data = submesh->getIndexData();
+			auto lod_indices = submesh->getLodIndices();
+
+			auto [streams, inserted] = geometry_streams.try_emplace(submesh->getGeometryKey());
+			if (inserted) {
+				vertices.resize(submesh->getVerticesCount());
+				FullVertex::pack(*submesh, vertices);
+
+				streams->second = {
+				    .vertex_offset = writer.appendBlob(Vertices, vertices.data(), vertices.size() * sizeof(FullVertex)),
+				    .index_offset = writer.appendBlob(Indices, index_data.data(), index_data.size()),
+				    .lod_index_offset = writer.appendBlob(Indices, lod_indices.data(), lod_indices.size_bytes()),
+				};
+			}
+
+			SubMeshRecord record{
+			    .name = writer.appendString(submesh->getName()),
+			    .material = indexOf<Material>(material_indices, submesh->getMaterial().get()),
+			    .visible = submesh->isVisible(),
+			    .vertex_count = submesh->getVerticesCount(),
+			    .index_count = submesh->getIndicesCount(),
+			    .index_size = submesh->getIndexSize(),
+			    .lod_count = static_cast<uint32_t>(submesh->getLods().size()),
+			    .lod_index_count = static_cast<uint32_t>(lod_indices.size()),
+			    .meshlet_count = static_cast<uint32_t>(submesh->getMeshlets().size()),
+			    .bounds_min = {submesh->getBoundsMin().x, submesh->getBoundsMin().y, submesh->getBoundsMin().z},
+			    .bounds_max = {submesh->getBoundsMax().x, submesh->getBoundsMax().y, submesh->getBoundsMax().z},
+			    .vertex_offset = streams->second.vertex_offset,
+			    .index_offset = streams->second.index_offset,
+			    .lod_index_offset = streams->second.lod_index_offset,
+			};
+
+			for (size_t i = 0; const auto& lod : submesh->getLods()) {
+				auto lod_index = writer.append(Lods, LodRecord{lod.index_offset, lod.index_count, lod.error});
+				if (i++ == 0)
+					record.first_lod = lod_index;
+			}
+
+			for (size_t i = 0; const auto& meshlet : submesh->getMeshlets()) {
+				auto meshlet_index = writer.append(Meshlets, MeshletRecord{
+				    .index_offset = meshlet.index_offset,
+				    .index_count = meshlet.index_count,
+				    .center = {meshlet.center.x, meshlet.center.y, meshlet.center.z},
+				    .radius = meshlet.radius,
+				    .cone_apex = {meshlet.cone_apex.x, meshlet.cone_apex.y, meshlet.cone_apex.z},
+				    .cone_axis = {meshlet.cone_axis.x, meshlet.cone_axis.y, meshlet.cone_axis.z},
+				    .cone_cutoff = meshlet.cone_cutoff,
+				});
+				if (i++ == 0)
+					record.first_meshlet = meshlet_index;
+			}
+
+			submesh_indices[submesh.get()] = writer.append(SubMeshes, record);
+		}
+	}
+
+	// Meshes
+	std::unordered_map<const Mesh*, uint32_t> mesh_indices;
+	uint32_t                                  mesh_submesh_count = 0;
+	for (const auto* mesh : meshes) {
+		auto submeshes = mesh->getSubmeshes();
+		for (const auto& submesh : submeshes)
+			writer.append(MeshSubMeshes, submesh_indices.at(submesh.get()));
+
+		MeshRecord record{
+		    .name = writer.appendString(mesh->getName()),
+		    .first_submesh = mesh_submesh_count,
+		    .submesh_count = static_cast<uint32_t>(submeshes.size()),
+		};
+
+		mesh_indices[mesh] = writer.append(Meshes, record);
+		mesh_submesh_count += static_cast<uint32_t>(submeshes.size());
+	}
+
+	// Cameras
+	std::unordered_map<const Camera*, uint32_t> camera_indices;
+	for (const auto* camera : cameras) {
+		CameraRecord record{.name = writer.appendString(camera->getName())};
+		if (auto* perspective = dynamic_cast<const PerspectiveCamera*>(camera)) {
+			record.type = CameraType::Perspective;
+			record.params[0] = perspective->getFov();
+			record.params[1] = perspective->getAspectRatio();
+			record.params[2] = perspective->getNearPlane();
+			record.params[3] = perspective->getFarPlane();
+		} else if (auto* ortho = dynamic_cast<const OrthoCamera*>(camera)) {
+			record.type = CameraType::Ortho;
+			record.params[0] = ortho->getLeft();
+			record.params[1] = ortho->getRight();
+			record.params[2] = ortho->getBottom();
+			record.params[3] = ortho->getTop();
+			record.params[4] = ortho->getNearPlane();
+			record.params[5] = ortho->getFarPlane();
+		} else
+			continue;
+
+		camera_indices[camera] = writer.append(Cameras, record);
+	}
+
+	// Lights
+	std::unordered_map<const Light*, uint32_t> light_indices;
+	for (const auto* light : lights) {
+		LightRecord record{
+		    .name = writer.appendString(light->getName()),
+		    .color = {light->getColor().x, light->getColor().y, light->getColor().z},
+		    .intensity = light->getIntensity(),
+		};
+
+		glm::vec3 direction{0.0f, 0.0f, -1.0f};
+		if (auto* directional = dynamic_cast<const DirectionalLight*>(light)) {
+			record.type = LightType::Directional;
+			direction = directional->getDirection();
+		} else if (auto* point = dynamic_cast<const PointLight*>(light)) {
+			record.type = LightType::Point;
+			record.range = point->getRange();
+		} else if (auto* spot = dynamic_cast<const SpotLight*>(light)) {
+			record.type = LightType::Spot;
+			direction = spot->getDirection();
+			record.range = spot->getRange();
+			record.inner_cone_angle = spot->getInnerConeAngle();
+			record.outer_cone_angle = spot->getOuterConeAngle();
+		} else
+			continue;
+
+		std::copy_n(&direction.x, 3, record.direction);
+		light_indices[light] = writer.append(Lights, record);
+	}
+
+	// Nodes in depth-first order so parents always precede their children
+	std::vector<std::pair<Node*, int32_t>> stack{{scene.getRoot(), -1}};
+	while (!stack.empty()) {
+		auto [node, parent] = stack.back();
+		stack.pop_back();
+
+		auto&      transform = node->getTransform();
+		const auto translation = transform.getTranslation();
+		const auto rotation = transform.getRotation();
+		const auto scaling = transform.getScaling();
+
+		NodeRecord record{
+		    .name = writer.appendString(node->getName()),
+		    .parent = parent,
+		    .mesh = node->hasComponent<Mesh>() ? indexOf<Mesh>(mesh_indices, &node->getComponent<Mesh>()) : -1,
+		    .camera = node->hasComponent<Camera>() ? indexOf<Camera>(camera_indices, &node->getComponent<Camera>()) : -1,
+		    .light = node->hasComponent<Light>() ? indexOf<Light>(light_indices, &node->getComponent<Light>()) : -1,
+		    .flags = node->isStatic() ? NODE_STATIC : 0u,
+		    .translation = {translation.x, translation.y, translation.z},
+		    .rotation = {rotation.x, rotation.y, rotation.z, rotation.w},
+		    .scaling = {scaling.x, scaling.y, scaling.z},
+		};
+
+		auto index = writer.append(Nodes, record);
+
+		const auto& children = node->getChildren();
+		for (auto it = children.rbegin(); it != children.rend(); ++it)
+			stack.emplace_back(*it, static_cast<int32_t>(index));
+	}
+
+	if (!writer.write(path, writer.appendString(scene.getName()))) {
+		Logger::error(std::format("Failed to write cooked scene {}", path.string()));
+		return false;
+	}
+
+	return true;
+}
+
+std::unique_ptr<Scene> SceneSerializer::load(const std::filesystem::path& path)
+{
+	SectionReader reader(path);
+	auto          storage = reader.getStorage();
+	auto          source = std::make_shared<CookedSource>(path, reader.getFile());
+
+	auto scene = std::make_unique<Scene>();
+	scene->setName(reader.string(reader.getHeader().scene_name));
+
+	// Textures reference their pixels in the mapping
+	auto                                  mip_records = reader.table<MipRecord>(Mips);
+	std::vector<std::shared_ptr<Texture>> textures;
+	for (const auto& record : reader.table<TextureRecord>(Textures)) {
+		auto texture = std::make_shared<Texture>(reader.string(record.name));
+		texture->setWidth(record.width);
+		texture->setHeight(record.height);
+		texture->setFormat(static_cast<TextureFormat>(record.format));
+		texture->setSrgb(record.srgb != 0);
+		texture->setData(reader.bytes(Pixels, record.data_offset, record.data_size), storage);
+		texture->setReloader([source, offset = record.data_offset, size = record.data_size](Resource& resource) {
+			auto reader = source->open();
+			static_cast<Texture&>(resource).setData(reader.bytes(Pixels, offset, size), reader.getStorage());
+		});
+
+		if (record.mip_count > 0) {
+			if (record.first_mip > mip_records.size() || record.mip_count > mip_records.size() - record.first_mip)
+				throw std::runtime_error("vxscene mip range out of bounds");
+
+			std::vector<TextureMip> mips;
+			for (const auto& mip : mip_records.subspan(record.first_mip, record.mip_count)) {
+				if (mip.offset > record.data_size || mip.size > record.data_size - mip.offset)
+					throw std::runtime_error("vxscene mip data out of bounds");
+				mips.push_back({.width = mip.width, .height = mip.height, .offset = mip.offset, .size = mip.size});
+			}
+			texture->setMips(std::move(mips));
+		}
+		textures.push_back(std::move(texture));
+	}
+
+	// Materials
+	auto                                   material_textures = reader.table<MaterialTextureRecord>(MaterialTextures);
+	std::vector<std::shared_ptr<Material>> materials;
+	for (const auto& record : reader.table<MaterialRecord>(Materials)) {
+		auto material = std::make_shared<PBRMaterial>(reader.string(record.name));
+		material->setBaseColorFactor({record.base_color[0], record.base_color[1], record.base_color[2], record.base_color[3]});
+		material->setMetallicFactor(record.metallic);
+		material->setRoughnessFactor(record.roughness);
+		material->setEmissive({record.emissive[0], record.emissive[1], record.emissive[2]});
+		material->setAlphaCutoff(record.alpha_cutoff);
+		material->setAlphaMode(static_cast<AlphaMode>(record.alpha_mode));
+		material->setDoubleSided(record.double_sided != 0);
+
+		if (record.first_texture + record.texture_count > material_textures.size())
+			throw std::runtime_error("Malformed vxscene material textures");
+		for (const auto& texture_record : material_textures.subspan(record.first_texture, record.texture_count))
+			if (texture_record.texture >= 0 && texture_record.texture < static_cast<int32_t>(textures.size()))
+				material->addTexture(reader.string(texture_record.slot), textures[texture_record.texture]);
+
+		materials.push_back(std::move(material));
+	}
+
+	auto lod_records = reader.table<LodRecord>(Lods);
+	auto meshlet_records = reader.table<MeshletRecord>(Meshlets);
+
+	std::vector<std::shared_ptr<SubMesh>> submeshes;
+	for (const auto& record : reader.table<SubMeshRecord>(SubMeshes)) {
+		auto submesh = std::make_shared<SubMesh>(reader.string(record.name));
+		submesh->setVisible(record.visible != 0);
+		submesh->setVerticesCount(record.vertex_count);
+
+		loadGeometry(reader, record, lod_records, *submesh);
+		submesh->setReloader([source, index = submeshes.size()](Resource& resource) {
+			auto reader = source->open();
+			loadGeometry(reader, reader.table<SubMeshRecord>(SubMeshes)[index], reader.table<LodRecord>(Lods), static_cast<SubMesh&>(resource));
+		});
+
+		submesh->setBounds({record.bounds_min[0], record.bounds_min[1], record.bounds_min[2]},
+		    {record.bounds_max[0], record.bounds_max[1], record.bounds_max[2]});
+
+		if (record.meshlet_count > 0) {
+			if (record.first_meshlet > meshlet_records.size() || record.meshlet_count > meshlet_records.size() - record.first_meshlet)
+				throw std::runtime_error("vxscene meshlet range out of bounds");
+
+			std::vector<Meshlet> meshlets;
+			for (const auto& meshlet : meshlet_records.subspan(record.first_meshlet, record.meshlet_count)) {
+				if (uint64_t{meshlet.index_offset} + meshlet.index_count > record.index_count)
+					throw std::runtime_error("vxscene meshlet indices out of bounds");
+				meshlets.push_back({
+				    .index_offset = meshlet.index_offset,
+				    .index_count = meshlet.index_count,
+				    .center = {meshlet.center[0], meshlet.center[1], meshlet.center[2]},
+				    .radius = meshlet.radius,
+				    .cone_apex = {meshlet.cone_apex[0], meshlet.cone_apex[1], meshlet.cone_apex[2]},
+				    .cone_axis = {meshlet.cone_axis[0], meshlet.cone_axis[1], meshlet.cone_axis[2]},
+				    .cone_cutoff = meshlet.cone_cutoff,
+				});
+			}
+
+			submesh->setMeshlets(std::move(meshlets));
+		}
+
+		if (record.material >= 0 && record.material < static_cast<int32_t>(materials.size()))
+			submesh->setMaterial(materials[record.material]);
+
+		submeshes.push_back(std::move(submesh));
+	}
+
+	// Meshes
+	auto                               mesh_submeshes = reader.table<uint32_t>(MeshSubMeshes);
+	std::vector<std::unique_ptr<Mesh>> meshes;
+	for (const auto& record : reader.table<MeshRecord>(Meshes)) {
+		if (record.first_submesh + record.submesh_count > mesh_submeshes.size())
+			throw std::runtime_error("Malformed vxscene mesh");
+
+		auto mesh = std::make_unique<Mesh>(reader.string(record.name));
+		for (auto submesh_index : mesh_submeshes.subspan(record.first_submesh, record.submesh_count))
+			mesh->addSubmesh(submeshes.at(submesh_index));
+
+		meshes.push_back(std::move(mesh));
+	}
+
+	// Cameras
+	std::vector<std::unique_ptr<Camera>> cameras;
+	for (const auto& record : reader.table<CameraRecord>(Cameras)) {
+		auto name = reader.string(record.name);
+		if (record.type == CameraType::Ortho)
+			cameras.push_back(std::make_unique<OrthoCamera>(name, record.params[0], record.params[1], record.params[2], record.params[3], record.params[4], record.params[5]));
+		else
+			cameras.push_back(std::make_unique<PerspectiveCamera>(name, record.params[0], record.params[1], record.params[2], record.params[3]));
+	}
+
+	// Lights
+	std::vector<std::unique_ptr<Light>> lights;
+	for (const auto& record : reader.table<LightRecord>(Lights)) {
+		auto      name = reader.string(record.name);
+		glm::vec3 direction{record.direction[0], record.direction[1], record.direction[2]};
+
+		std::unique_ptr<Light> light{};
+		if (record.type == LightType::Point) {
+			auto point = std::make_unique<PointLight>(name);
+			point->setRange(record.range);
+			light = std::move(point);
+		} else if (record.type == LightType::Spot) {
+			auto spot = std::make_unique<SpotLight>(name);
+			spot->setDirection(direction);
+			spot->setRange(record.range);
+			spot->setInnerConeAngle(record.inner_cone_angle);
+			spot->setOuterConeAngle(record.outer_cone_angle);
+			light = std::move(spot);
+		} else {
+			auto directional = std::make_unique<DirectionalLight>(name);
+			directional->setDirection(direction);
+			light = std::move(directional);
+		}
+
+		light->setColor({record.color[0], record.color[1], record.color[2]});
+		light->setIntensity(record.intensity);
+		lights.push_back(std::move(light));
+	}
+
+	// Nodes
+	auto node_records = reader.table<NodeRecord>(Nodes);
+	if (node_records.empty())
+		throw std::runtime_error("vxscene file has no root node");
+
+	std::vector<std::unique_ptr<Node>> nodes;
+	nodes.reserve(node_records.size());
+	for (const auto& record : node_records) {
+		auto  node = std::make_unique<Node>(reader.string(record.name));
+		auto& transform = node->getTransform();
+		transform.setTranslation({record.translation[0], record.translation[1], record.translation[2]});
+		transform.setRotation({record.rotation[3], record.rotation[0], record.rotation[1], record.rotation[2]});
+		transform.setScaling({record.scaling[0], record.scaling[1], record.scaling[2]});
+		node->setStatic(record.flags & NODE_STATIC);
+
+		if (record.mesh >= 0 && record.mesh < static_cast<int32_t>(meshes.size())) {
+			node->setComponent(*meshes[record.mesh]);
+			meshes[record.mesh]->setNode(*node);
+		}
+
+		if (record.camera >= 0 && record.camera < static_cast<int32_t>(cameras.size())) {
+			node->setComponent(*cameras[record.camera]);
+			cameras[record.camera]->setNode(*node);
+		}
+
+		if (record.light >= 0 && record.light < static_cast<int32_t>(lights.size())) {
+			node->setComponent(*lights[record.light]);
+			lights[record.light]->setNode(*node);
+		}
+
+		if (record.parent >= 0) {
+			if (record.parent >= static_cast<int32_t>(nodes.size()))
+				throw std::runtime_error("vxscene node precedes its parent");
+			nodes[record.parent]->addChild(*node);
+		}
+
+		nodes.push_back(std::move(node));
+	}
+
+	scene->setRoot(*nodes.front());
+	scene->setNodes(std::move(nodes));
+
+	if (!textures.empty())
+		scene->setResources(std::move(textures));
+	if (!materials.empty())
+		scene->setResources(std::move(materials));
+	if (!submeshes.empty())
+		scene->setResources(std::move(submeshes));
+	if (!meshes.empty())
+		scene->setComponents(std::move(meshes));
+	if (!cameras.empty())
+		scene->setComponents(std::move(cameras));
+	if (!lights.empty())
+		scene->setComponents(std::move(lights));
+
+	return scene;
+}
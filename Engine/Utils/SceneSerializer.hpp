@@ -0,0 +1,18 @@
+#pragma once
+
+#include <memory>
+#include <filesystem>
+
+#include "Scene/Core/Scene.hpp"
+
+// Cooked .vxscene layout: a header with a section table, every section page aligned so the
+// file can be mapped and its record tables, vertex, index and pixel blobs used in place
+class SceneSerializer {
+public:
+	static constexpr uint32_t magic = 0x43535856;
+	static constexpr uint32_t version = 5;
+	static constexpr uint32_t page_size = 4096;
+
+	static bool                   save(Scene& scene, const std::filesystem::path& path);
+	static std::unique_ptr<Scene> load(const std::filesystem::path& path);
+};
@@ -0,0 +1,445 @@
+#include "TextureCompressor.hpp"
+
+#include <array>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "Core/Log/Logger.hpp"
+
+constexpr uint32_t BLOCK_PIXELS = 16;
+
+// BC7 4-bit index interpolation weights out of 64
+constexpr uint32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// BC1 index to the position between color0 and color1
+constexpr float BC1_WEIGHTS[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+using BlockColors = std::array<glm::vec4, BLOCK_PIXELS>;
+
+// Writes bit fields least significant bit first, the layout BC7 uses
+class BlockWriter {
+private:
+	uint8_t* block;
+	uint32_t position{0};
+
+public:
+	BlockWriter(uint8_t* block, size_t size) :
+	    block(block)
+	{
+		std::memset(block, 0, size);
+	}
+
+	void put(uint32_t value, uint32_t bits)
+	{
+		for (uint32_t i = 0; i < bits; i++, position++)
+			if ((value >> i) & 1)
+				block[position / 8] |= static_cast<uint8_t>(1u << (position % 8));
+	}
+};
+
+struct Bc1Fit {
+	uint16_t color0;
+	uint16_t color1;
+	uint32_t indices;
+	float    error;
+};
+
+struct Bc7Fit {
+	uint32_t endpoints[2][4];
+	uint32_t pbits[2];
+	uint32_t indices[BLOCK_PIXELS];
+	float    error;
+};
+
+static BlockColors loadColors(const uint8_t* pixels, bool alpha)
+{
+	BlockColors colors;
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+		colors[i] = glm::vec4(pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2], alpha ? pixels[i * 4 + 3] : 0.0f);
+	return colors;
+}
+
+static float distanceSquared(const glm::vec4& a, const glm::vec4& b)
+{
+	glm::vec4 d = a - b;
+	return glm::dot(d, d);
+}
+
+// Endpoints at the extremes of the block projected on its principal axis, found by power iteration on the covariance
+static std::pair<glm::vec4, glm::vec4> fitPrincipalAxis(const BlockColors& colors)
+{
+	glm::vec4 mean(0.0f), min(255.0f), max(0.0f);
+	for (const auto& color : colors) {
+		mean += color;
+		min = glm::min(min, color);
+		max = glm::max(max, color);
+	}
+	mean /= static_cast<float>(BLOCK_PIXELS);
+
+	float covariance[4][4]{};
+	for (const auto& color : colors) {
+		glm::vec4 d = color - mean;
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				covariance[i][j] += d[i] * d[j];
+	}
+
+	glm::vec4 axis = max - min;
+	if (glm::dot(axis, axis) == 0.0f)
+		return {mean, mean};
+
+	for (int iteration = 0; iteration < 8; iteration++) {
+		glm::vec4 next(0.0f);
+		for (int i = 0; i < 4; i++)
+			for (int j = 0; j < 4; j++)
+				next[i] += covariance[i][j] * axis[j];
+
+		float length = glm::length(next);
+		if (length == 0.0f)
+			break;
+		axis = next / length;
+	}
+
+	float t_min = std::numeric_limits<float>::max(), t_max = std::numeric_limits<float>::lowest();
+	for (const auto& color : colors) {
+		float t = glm::dot(color - mean, axis);
+		t_min = std::min(t_min, t);
+		t_max = std::max(t_max, t);
+	}
+
+	return {glm::clamp(mean + axis * t_min, 0.0f, 255.0f), glm::clamp(mean + axis * t_max, 0.0f, 255.0f)};
+}
+
+// Least squares endpoints for fixed per pixel weights, 0 selects the first endpoint and 1 the second
+static bool refineEndpoints(const BlockColors& colors, const float* weights, glm::vec4& e0, glm::vec4& e1)
+{
+	float     a = 0.0f, b = 0.0f, c = 0.0f;
+	glm::vec4 x0(0.0f), x1(0.0f);
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++) {
+		float w = weights[i], v = 1.0f - w;
+		a += v * v;
+		b += v * w;
+		c += w * w;
+		x0 += colors[i] * v;
+		x1 += colors[i] * w;
+	}
+
+	float determinant = a * c - b * b;
+	if (std::abs(determinant) < 1e-6f)
+		return false;
+
+	e0 = glm::clamp((x0 * c - x1 * b) / determinant, 0.0f, 255.0f);
+	e1 = glm::clamp((x1 * a - x0 * b) / determinant, 0.0f, 255.0f);
+	return true;
+}
+
+static uint16_t packRgb565(const glm::vec4& color)
+{
+	auto r = static_cast<uint32_t>(std::lround(color.r * 31.0f / 255.0f));
+	auto g = static_cast<uint32_t>(std::lround(color.g * 63.0f / 255.0f));
+	auto b = static_cast<uint32_t>(std::lround(color.b * 31.0f / 255.0f));
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static glm::vec4 unpackRgb565(uint16_t value)
+{
+	uint32_t r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+	return glm::vec4((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 0.0f);
+}
+
+// Four color mode only (color0 > color1), equal endpoints leave every index at 0
+static Bc1Fit fitBC1(const BlockColors& colors, const glm::vec4& e0, const glm::vec4& e1)
+{
+	Bc1Fit fit{packRgb565(e0), packRgb565(e1), 0, 0.0f};
+	if (fit.color0 < fit.color1)
+		std::swap(fit.color0, fit.color1);
+
+	glm::vec4 palette[4];
+	palette[0] = unpackRgb565(fit.color0);
+	palette[1] = unpackRgb565(fit.color1);
+	palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+	palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+
+	uint32_t palette_size = fit.color0 == fit.color1 ? 1 : 4;
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++) {
+		uint32_t best = 0;
+		float    best_error = distanceSquared(colors[i], palette[0]);
+		for (uint32_t k = 1; k < palette_size; k++) {
+			float error = distanceSquared(colors[i], palette[k]);
+			if (error < best_error) {
+				best_error = error;
+				best = k;
+			}
+		}
+		fit.indices |= best << (i * 2);
+		fit.error += best_error;
+	}
+
+	return fit;
+}
+
+// Mode 6: one subset, RGBA endpoints of 7 bits plus a shared low bit per endpoint, 4-bit indices
+static Bc7Fit fitBC7(const BlockColors& colors, const glm::vec4& e0, const glm::vec4& e1)
+{
+	Bc7Fit          fit{};
+	const glm::vec4 targets[2] = {e0, e1};
+	uint32_t        decoded[2][4];
+
+	for (uint32_t e = 0; e < 2; e++) {
+		float best_error = std::numeric_limits<float>::max();
+		for (uint32_t p = 0; p < 2; p++) {
+			uint32_t quantized[4];
+			float    error = 0.0f;
+			for (int c = 0; c < 4; c++) {
+				quantized[c] = static_cast<uint32_t>(std::clamp<long>(std::lround((targets[e][c] - static_cast<float>(p)) * 0.5f), 0, 127));
+				float value = static_cast<float>(quantized[c] * 2 + p);
+				error += (value - targets[e][c]) * (value - targets[e][c]);
+			}
+
+			if (error < best_error) {
+				best_error = error;
+				fit.pbits[e] = p;
+				for (int c = 0; c < 4; c++) {
+					fit.endpoints[e][c] = quantized[c];
+					decoded[e][c] = quantized[c] * 2 + p;
+				}
+			}
+		}
+	}
+
+	glm::vec4 palette[16];
+	for (uint32_t k = 0; k < 16; k++)
+		for (int c = 0; c < 4; c++)
+			palette[k][c] = static_cast<float>(((64 - BC7_WEIGHTS[k]) * decoded[0][c] + BC7_WEIGHTS[k] * decoded[1][c] + 32) >> 6);
+
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++) {
+		uint32_t best = 0;
+		float    best_error = distanceSquared(colors[i], palette[0]);
+		for (uint32_t k = 1; k < 16; k++) {
+			float error = distanceSquared(colors[i], palette[k]);
+			if (error < best_error) {
+				best_error = error;
+				best = k;
+			}
+		}
+		fit.indices[i] = best;
+		fit.error += best_error;
+	}
+
+	return fit;
+}
+
+void TextureCompressor::encodeBC1(const uint8_t* pixels, uint8_t* block)
+{
+	auto colors = loadColors(pixels, false);
+	auto [e0, e1] = fitPrincipalAxis(colors);
+	auto fit = fitBC1(colors, e0, e1);
+
+	float weights[BLOCK_PIXELS];
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+		weights[i] = BC1_WEIGHTS[(fit.indices >> (i * 2)) & 3];
+
+	if (fit.color0 != fit.color1 && refineEndpoints(colors, weights, e0, e1)) {
+		auto refined = fitBC1(colors, e0, e1);
+		if (refined.error < fit.error)
+			fit = refined;
+	}
+
+	std::memcpy(block, &fit.color0, 2);
+	std::memcpy(block + 2, &fit.color1, 2);
+	std::memcpy(block + 4, &fit.indices, 4);
+}
+
+void TextureCompressor::encodeBC3(const uint8_t* pixels, uint8_t* block)
+{
+	encodeBC4(pixels, 3, block);
+	encodeBC1(pixels, block + 8);
+}
+
+// Eight value mode between the block minimum and maximum
+void TextureCompressor::encodeBC4(const uint8_t* pixels, uint32_t channel, uint8_t* block)
+{
+	uint32_t low = 255, high = 0;
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++) {
+		low = std::min<uint32_t>(low, pixels[i * 4 + channel]);
+		high = std::max<uint32_t>(high, pixels[i * 4 + channel]);
+	}
+
+	uint64_t indices = 0;
+	if (high > low) {
+		uint32_t palette[8] = {high, low};
+		for (uint32_t i = 1; i < 7; i++)
+			palette[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+
+		for (uint32_t i = 0; i < BLOCK_PIXELS; i++) {
+			int      value = pixels[i * 4 + channel];
+			uint64_t best = 0;
+			int      best_error = std::abs(value - static_cast<int>(palette[0]));
+			for (uint32_t k = 1; k < 8; k++) {
+				int error = std::abs(value - static_cast<int>(palette[k]));
+				if (error < best_error) {
+					best_error = error;
+					best = k;
+				}
+			}
+			indices |= best << (i * 3);
+		}
+	}
+
+	block[0] = static_cast<uint8_t>(high);
+	block[1] = static_cast<uint8_t>(low);
+	for (uint32_t i = 0; i < 6; i++)
+		block[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+}
+
+void TextureCompressor::encodeBC5(const uint8_t* pixels, uint8_t* block)
+{
+	encodeBC4(pixels, 0, block);
+	encodeBC4(pixels, 1, block + 8);
+}
+
+void TextureCompressor::encodeBC7(const uint8_t* pixels, uint8_t* block)
+{
+	auto colors = loadColors(pixels, true);
+	auto [e0, e1] = fitPrincipalAxis(colors);
+	auto fit = fitBC7(colors, e0, e1);
+
+	float weights[BLOCK_PIXELS];
+	for (uint32_t i = 0; i < BLOCK_PIXELS; i++)
+		weights[i] = static_cast<float>(BC7_WEIGHTS[fit.indices[i]]) / 64.0f;
+
+	if (refineEndpoints(colors, weights, e0, e1)) {
+		auto refined = fitBC7(colors, e0, e1);
+		if (refined.error < fit.error)
+			fit = refined;
+	}
+
+	// The first index is stored with its top bit implied zero, swapping the endpoints mirrors the weights
+	if (fit.indices[0] >= 8) {
+		std::swap(fit.endpoints[0], fit.endpoints[1]);
+		std::swap(fit.pbits[0], fit.pbits[1]);
+		for (auto& index : fit.indices)
+			index = 15 - index;
+	}
+
+	BlockWriter writer(block, 16);
+	writer.put(1u << 6, 7);
+	for (int c = 0; c < 4; c++)
+		for (int e = 0; e < 2; e++)
+			writer.put(fit.endpoints[e][c], 7);
+	writer.put(fit.pbits[0], 1);
+	writer.put(fit.pbits[1], 1);
+
+	writer.put(fit.indices[0], 3);
+	for (uint32_t i = 1; i < BLOCK_PIXELS; i++)
+		writer.put(fit.indices[i], 4);
+}
+
+static const char* getFormatName(TextureFormat format)
+{
+	switch (format) {
+	case TextureFormat::BC1:
+		return "BC1";
+	case TextureFormat::BC3:
+		return "BC3";
+	case TextureFormat::BC4:
+		return "BC4";
+	case TextureFormat::BC5:
+		return "BC5";
+	case TextureFormat::BC7:
+		return "BC7";
+	default:
+		return "RGBA8";
+	}
+}
+
+TextureFormat TextureCompressor::chooseFormat(const Texture& texture)
+{
+	if (texture.getFormat() != TextureFormat::RGBA8)
+		return texture.getFormat();
+
+	bool opaque = true, grayscale = true;
+	auto pixels = texture.getMipData(0);
+	for (size_t i = 0; i + 3 < pixels.size(); i += 4) {
+		uint8_t r = pixels[i], g = pixels[i + 1], b = pixels[i + 2];
+		opaque &= pixels[i + 3] == 255;
+		grayscale &= r == g && g == b;
+	}
+
+	if (texture.isSrgb())
+		return opaque ? TextureFormat::BC1 : TextureFormat::BC7;
+	return opaque && grayscale ? TextureFormat::BC4 : TextureFormat::BC7;
+}
+
+void TextureCompressor::compress(Texture& texture, TextureFormat format)
+{
+	if (!texture.valid() || texture.getFormat() != TextureFormat::RGBA8 || !Texture::isCompressed(format))
+		return;
+
+	std::vector<TextureMip> mips;
+	uint64_t                total_size = 0;
+	for (uint32_t level = 0; level < texture.getMipCount(); level++) {
+		auto mip = texture.getMip(level);
+		if (mip.size < Texture::getDataSize(TextureFormat::RGBA8, mip.width, mip.height))
+			return;
+
+		mips.push_back({.width = mip.width, .height = mip.height, .offset = total_size, .size = Texture::getDataSize(format, mip.width, mip.height)});
+		total_size += mips.back().size;
+	}
+
+	size_t               block_size = format == TextureFormat::BC1 || format == TextureFormat::BC4 ? 8 : 16;
+	std::vector<uint8_t> output(total_size);
+	uint8_t              pixels[BLOCK_PIXELS * 4];
+
+	for (uint32_t level = 0; level < mips.size(); level++) {
+		auto     source = texture.getMipData(level);
+		uint32_t width = mips[level].width, height = mips[level].height;
+		uint8_t* block = output.data() + mips[level].offset;
+
+		for (uint32_t block_y = 0; block_y < height; block_y += 4) {
+			for (uint32_t block_x = 0; block_x < width; block_x += 4, block += block_size) {
+				// Edge blocks of small levels repeat the last row and column
+				for (uint32_t y = 0; y < 4; y++) {
+					size_t row = std::min(block_y + y, height - 1);
+					for (uint32_t x = 0; x < 4; x++)
+						std::memcpy(pixels + (y * 4 + x) * 4, source.data() + (row * width + std::min(block_x + x, width - 1)) * 4, 4);
+				}
+
+				switch (format) {
+				case TextureFormat::BC1:
+					encodeBC1(pixels, block);
+					break;
+				case TextureFormat::BC3:
+					encodeBC3(pixels, block);
+					break;
+				case TextureFormat::BC4:
+					encodeBC4(pixels, 0, block);
+					break;
+				case TextureFormat::BC5:
+					encodeBC5(pixels, block);
+					break;
+				default:
+					encodeBC7(pixels, block);
+					break;
+				}
+			}
+		}
+	}
+
+	Logger::debug(std::format("Compressed {} to {}: {} -> {} bytes", texture.getName(), getFormatName(format), texture.getData().size(), output.size()));
+
+	texture.setData(std::move(output));
+	texture.setFormat(format);
+	texture.setMips(std::move(mips));
+}
+
+void TextureCompressor::compress(Texture& texture)
+{
+	compress(texture, chooseFormat(texture));
+}
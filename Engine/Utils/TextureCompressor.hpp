@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Scene/Resources/Texture.hpp"
+
+// CPU block compression of RGBA8 mip chains. Encoders take 16 RGBA pixels (one 4x4 block, row major) and write one block
+class TextureCompressor {
+public:
+	static void encodeBC1(const uint8_t* pixels, uint8_t* block);
+	static void encodeBC3(const uint8_t* pixels, uint8_t* block);
+	static void encodeBC4(const uint8_t* pixels, uint32_t channel, uint8_t* block);
+	static void encodeBC5(const uint8_t* pixels, uint8_t* block);
+	static void encodeBC7(const uint8_t* pixels, uint8_t* block);
+
+	// Opaque color goes to BC1 and color with alpha to BC7, opaque grayscale data to BC4 and other linear data to BC7.
+	// BC5 is never picked, two channel normals need the shader to rebuild Z and no material slot does that yet
+	static TextureFormat chooseFormat(const Texture& texture);
+
+	static void compress(Texture& texture, TextureFormat format);
+	static void compress(Texture& texture);
+};
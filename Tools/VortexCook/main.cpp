@@ -0,0 +1,156 @@
+#include <format>
+#include <string>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+
+#include "Core/Clock/Timer.hpp"
+#include "Core/File/FileSystem.hpp"
+#include "Core/File/PathResolver.hpp"
+#include "Core/Log/Logger.hpp"
+#include "Core/Thread/ThreadPool.hpp"
+#include "Utils/AssetCache.hpp"
+#include "Utils/AssetImporter.hpp"
+#include "Utils/SceneSerializer.hpp"
+
+static std::vector<std::filesystem::path> findScenes(const std::filesystem::path& assets_dir)
+{
+	std::vector<std::filesystem::path> scenes;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(assets_dir)) {
+		if (!entry.is_regular_file())
+			continue;
+
+		auto extension = entry.path().extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		if (extension == ".gltf" || extension == ".glb")
+			scenes.push_back(entry.path());
+	}
+
+	std::sort(scenes.begin(), scenes.end());
+	return scenes;
+}
+
+// Cooks every glTF scene under the assets directory into the cache, inputs with a current cache entry are skipped
+int main(int argc, char** argv)
+{
+	bool                  force = false;
+	bool                  optimize = true;
+	bool                  lods = true;
+	bool                  meshlets = true;
+	bool                  mips = true;
+	bool                  compress = true;
+	bool                  dedup = true;
+	bool                  bake = true;
+	bool                  collapse = false;
+	std::filesystem::path assets_dir;
+	std::filesystem::path cache_dir;
+
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		if (arg == "--force")
+			force = true;
+		else if (arg == "--no-optimize")
+			optimize = false;
+		else if (arg == "--no-lods")
+			lods = false;
+		else if (arg == "--no-meshlets")
+			meshlets = false;
+		else if (arg == "--no-mips")
+			mips = false;
+		else if (arg == "--no-compress")
+			compress = false;
+		else if (arg == "--no-dedup")
+			dedup = false;
+		else if (arg == "--no-bake")
+			bake = false;
+		else if (arg == "--collapse")
+			collapse = true;
+		else if (arg == "--assets" && i + 1 < argc)
+			assets_dir = argv[++i];
+		else if (arg == "--cache" && i + 1 < argc)
+			cache_dir = argv[++i];
+		else {
+			Logger::error("Usage: VortexCook [--force] [--no-optimize] [--no-lods] [--no-meshlets] [--no-mips] [--no-compress] [--no-dedup] [--no-bake] [--collapse] [--assets <dir>] [--cache <dir>]");
+			return 1;
+		}
+	}
+
+	try {
+		if (assets_dir.empty())
+			assets_dir = PathResolver::getAssetsDir();
+		if (cache_dir.empty())
+			cache_dir = PathResolver::getCacheDir();
+
+		Timer timer;
+		timer.start();
+
+		AssetCache   cache(assets_dir, cache_dir);
+		CookSettings settings{
+		    .optimize_meshes = optimize,
+		    .generate_lods = lods,
+		    .build_meshlets = meshlets,
+		    .generate_mips = mips,
+		    .compress_textures = compress,
+		    .deduplicate_assets = dedup,
+		    .bake_static = bake,
+		    .collapse_static = collapse,
+		};
+
+		std::vector<std::filesystem::path> stale;
+		for (const auto& scene_path : findScenes(assets_dir))
+			if (force || !cache.findCooked(scene_path, settings))
+				stale.push_back(scene_path);
+
+		std::vector<std::optional<CacheEntry>> entries(stale.size());
+		ThreadPool::instance().parallelFor(stale.size(), [&](size_t index) {
+			const auto& source = stale[index];
+			try {
+				auto entry = cache.makeEntry(source, settings);
+
+				ImportSettings import_settings{
+				    .parallel = true,
+				    .report_timings = false,
+				    .write_cooked = false,
+				    .use_cache = false,
+				    .optimize_meshes = settings.optimize_meshes,
+				    .generate_lods = settings.generate_lods,
+				    .build_meshlets = settings.build_meshlets,
+				    .generate_mips = settings.generate_mips,
+				    .compress_textures = settings.compress_textures,
+				    .deduplicate_assets = settings.deduplicate_assets,
+				    .bake_static = settings.bake_static,
+				    .collapse_static = settings.collapse_static,
+				};
+				auto scene = AssetImporter::loadScene(source.string(), import_settings);
+
+				auto cooked_path = cache.getCookedPath(source);
+				FileSystem::createDirectories(cooked_path.parent_path());
+				if (!SceneSerializer::save(*scene, cooked_path))
+					throw std::runtime_error("Failed to write " + cooked_path.string());
+
+				entries[index] = std::move(entry);
+				Logger::info(std::format("Cooked {}", source.string()));
+			} catch (const std::exception& e) {
+				Logger::error(std::format("Failed to cook {}: {}", source.string(), e.what()));
+			}
+		});
+
+		size_t cooked = 0;
+		for (size_t i = 0; i < stale.size(); i++) {
+			if (entries[i]) {
+				cache.addEntry(stale[i], std::move(*entries[i]));
+				cooked++;
+			}
+		}
+
+		if (!cache.save())
+			throw std::runtime_error("Failed to write " + cache.getManifestPath().string());
+
+		Logger::info(std::format("Cooked {} of {} stale scene(s) in {:.2f} ms", cooked, stale.size(), timer.getElapsedMilliseconds()));
+		return cooked == stale.size() ? 0 : 1;
+	} catch (const std::exception& e) {
+		Logger::error(e.what());
+		return 1;
+	}
+}